@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <memory_resource>
+#include <vector>
+#include "FrameArena.h"
+
+namespace
+{
+	//A frame's worth of short lived scratch arrays, sizes vary like draw and visibility lists do
+	void BuildScratch(std::pmr::memory_resource* pResource, uint32_t lists)
+	{
+		for (uint32_t i = 0; i < lists; ++i)
+		{
+			std::pmr::vector<uint32_t> scratch(pResource);
+			scratch.resize(16 + (i * 37) % 512);
+			scratch[i % scratch.size()] = i;
+			benchmark::DoNotOptimize(scratch.data());
+		}
+	}
+}
+
+//Baseline, every list goes through new/delete
+static void BM_ScratchNewDelete(benchmark::State& state)
+{
+	uint32_t const lists = (uint32_t)state.range(0);
+	for (auto _ : state) BuildScratch(std::pmr::new_delete_resource(), lists);
+	state.SetItemsProcessed(state.iterations() * lists);
+}
+BENCHMARK(BM_ScratchNewDelete)->Arg(64)->Arg(1024);
+
+static void BM_ScratchFrameArena(benchmark::State& state)
+{
+	uint32_t const lists = (uint32_t)state.range(0);
+	Memory::FrameArena arena;
+	for (auto _ : state)
+	{
+		arena.NextFrame();
+		BuildScratch(arena.Resource(), lists);
+	}
+	state.SetItemsProcessed(state.iterations() * lists);
+	state.counters["high water KB"] = (double)arena.Current().Stats().highWater / 1024.0;
+	state.counters["overflows"] = (double)arena.Current().Stats().overflowAllocations;
+}
+BENCHMARK(BM_ScratchFrameArena)->Arg(64)->Arg(1024);
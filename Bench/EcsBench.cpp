@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <optional>
+#include <vector>
+#include "Ecs.h"
+#include "Terrain.h"
+
+//Chunked query over every terrain sprite, nudging positions by their layer. 0 workers runs the serial query
+static void BM_SpriteQuery(benchmark::State& state)
+{
+	uint32_t const side = (uint32_t)state.range(0);
+	uint32_t const workers = (uint32_t)state.range(1);
+	std::optional<Jobs::JobSystem> jobs;
+	if (workers > 0) jobs.emplace(workers);
+
+	Ecs::World sprites;
+	sprites.CreateMany<QuadTransform, SpriteLayer>(side * side);
+
+	auto move = [](std::span<Ecs::Entity const>, std::span<QuadTransform> transforms, std::span<SpriteLayer const> layers) {
+		for (size_t i = 0; i < transforms.size(); ++i) transforms[i].position.x += 0.5f + (float)layers[i].layer;
+	};
+	for (auto _ : state)
+	{
+		if (jobs) sprites.ParallelForEachChunk<QuadTransform, SpriteLayer const>(*jobs, move);
+		else sprites.ForEachChunk<QuadTransform, SpriteLayer const>(move);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * side * side);
+}
+BENCHMARK(BM_SpriteQuery)->Args({ 1000, 0 })->Args({ 1000, 1 })->Args({ 1000, 4 })->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+//Gathering a component into a flat array, the path for cpu consumers that want one contiguous span
+static void BM_SpriteGather(benchmark::State& state)
+{
+	uint32_t const side = (uint32_t)state.range(0);
+	Terrain terrain(side, side, 50);
+	std::vector<QuadTransform> cells;
+
+	for (auto _ : state)
+	{
+		terrain.Sprites().Gather(cells);
+		benchmark::DoNotOptimize(cells.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * (int64_t)(cells.size() * sizeof(QuadTransform)));
+}
+BENCHMARK(BM_SpriteGather)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
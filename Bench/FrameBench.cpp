@@ -0,0 +1,289 @@
+#include <benchmark/benchmark.h>
+#include "webgpu.h"
+#include "NullDevice.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "DrawList.h"
+#include "DrawBundle.h"
+#include "TerrainRenderer.h"
+#include "TilemapRenderer.h"
+#include "TextureUploader.h"
+#include "Terrain.h"
+#include "AllocationTracker.h"
+#include "NullScene.h"
+
+namespace
+{
+	using Test::NullScene;
+
+	void ReportDeviceCounters(benchmark::State& state, Gfx::NullDevice const& device, size_t commands)
+	{
+		auto const& stats = device.Stats();
+		double frames = (double)state.iterations();
+		state.counters["bytesPerFrame"] = (double)(stats.bufferBytesWritten + stats.textureBytesWritten) / frames;
+		state.counters["writesPerFrame"] = (double)(stats.bufferWrites + stats.textureWrites) / frames;
+		state.counters["drawsPerFrame"] = (double)stats.draws / frames;
+		state.counters["stateChangesPerFrame"] = (double)stats.stateChanges / frames;
+		state.counters["commandsPerFrame"] = (double)commands;
+	}
+
+	struct SteadyAllocations
+	{
+		uint32_t frames = 0;
+		Memory::AllocationCounters allocated;
+
+		void Report(benchmark::State& state) const
+		{
+			if (!Memory::k_trackAllocations || frames < 2) return;
+			state.counters["allocsPerFrame"] = (double)allocated.allocations / (double)(frames - 1);
+			state.counters["allocBytesPerFrame"] = (double)allocated.bytes / (double)(frames - 1);
+		}
+	};
+
+	//Frames after the first are steady state, every container has grown to size so they shouldn't allocate.
+	//Counted when built with RENDERER_TRACK_ALLOCATIONS, in strict mode (RENDERER_STRICT_ALLOCATIONS=1) one aborts the run
+	class SteadyFrame {
+	public:
+		explicit SteadyFrame(SteadyAllocations& totals) noexcept
+			: _totals(totals)
+			, _noAllocations(totals.frames > 0)
+			, _start(Memory::ThreadAllocations())
+		{
+		}
+
+		~SteadyFrame()
+		{
+			if (_totals.frames++ == 0) return;
+			Memory::AllocationCounters const allocated = Memory::ThreadAllocations() - _start;
+			_totals.allocated.allocations += allocated.allocations;
+			_totals.allocated.bytes += allocated.bytes;
+		}
+
+	private:
+		//No copy, move
+		SteadyFrame(SteadyFrame const& other) = delete;
+		SteadyFrame(SteadyFrame&& other) = delete;
+		SteadyFrame& operator=(SteadyFrame const& other) = delete;
+		SteadyFrame& operator=(SteadyFrame&& other) = delete;
+
+		SteadyAllocations& _totals;
+		Memory::NoAllocationScope _noAllocations;
+		Memory::AllocationCounters _start;
+	};
+}
+
+//Cpu cost of building one terrain frame: animate, upload, animation and cull dispatches and the bundled draw
+static void BM_TerrainFrame(benchmark::State& state)
+{
+	uint32_t side = (uint32_t)state.range(0);
+
+	Gfx::NullDevice device;
+	NullScene scene(device);
+	Terrain terrain(side, side, 50);
+	TerrainRenderer terrainRenderer(device, terrain, scene.animations, scene.camera, scene.quadShader, scene.cullShader, scene.animShader,
+		scene.colorTarget, scene.depthStencil, Gfx::QuadGeometry::VertexPulling);
+
+	wgpu::RenderPassDescriptor passDesc{};
+	device.ResetStats();
+	size_t commands = 0;
+	SteadyAllocations allocations;
+	for (auto _ : state)
+	{
+		SteadyFrame frame(allocations);
+		device.ClearCommands();
+
+		wgpu::CommandEncoder encoder = device.BeginCommands("Frame");
+		terrain.Animate();
+		terrainRenderer.Update(terrain.AnimTick());
+		terrainRenderer.Animate(encoder);
+		terrainRenderer.Cull(encoder);
+
+		Gfx::RenderEncoder& pass = device.BeginRenderPass(encoder, passDesc);
+		terrainRenderer.Draw(pass);
+		device.EndRenderPass(pass);
+		device.Submit(encoder);
+
+		commands = device.Commands().size();
+	}
+
+	state.SetItemsProcessed(state.iterations() * (int64_t)side * side);
+	ReportDeviceCounters(state, device, commands);
+	allocations.Report(state);
+	//What the quad draw would fetch from vertex/index buffers with each geometry, pulled fetches none
+	uint64_t const instances = (uint64_t)side * side;
+	state.counters["fetchBytesVertexBuffer"] = (double)Gfx::QuadVertexFetchBytes(Gfx::QuadGeometry::VertexBuffer, instances);
+	state.counters["fetchBytesIndexed"] = (double)Gfx::QuadVertexFetchBytes(Gfx::QuadGeometry::Indexed, instances);
+	state.counters["fetchBytesPulled"] = (double)Gfx::QuadVertexFetchBytes(Gfx::QuadGeometry::VertexPulling, instances);
+}
+//1k, 10k, 100k and 1M instances
+BENCHMARK(BM_TerrainFrame)->Arg(32)->Arg(100)->Arg(317)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+//Same terrain in tilemap mode, the frame shouldn't grow with the cell count
+static void BM_TilemapFrame(benchmark::State& state)
+{
+	uint32_t side = (uint32_t)state.range(0);
+
+	Gfx::NullDevice device;
+	NullScene scene(device);
+	Terrain terrain(side, side, 50);
+	TilemapRenderer tilemapRenderer(device, terrain, scene.animations, scene.camera, scene.tilemapShader,
+		scene.colorTarget, scene.depthStencil);
+
+	wgpu::RenderPassDescriptor passDesc{};
+	device.ResetStats();
+	size_t commands = 0;
+	SteadyAllocations allocations;
+	for (auto _ : state)
+	{
+		SteadyFrame frame(allocations);
+		device.ClearCommands();
+
+		wgpu::CommandEncoder encoder = device.BeginCommands("Frame");
+		terrain.Animate();
+		tilemapRenderer.Update(terrain.AnimTick());
+
+		Gfx::RenderEncoder& pass = device.BeginRenderPass(encoder, passDesc);
+		tilemapRenderer.Draw(pass);
+		device.EndRenderPass(pass);
+		device.Submit(encoder);
+
+		commands = device.Commands().size();
+	}
+
+	state.SetItemsProcessed(state.iterations() * (int64_t)side * side);
+	ReportDeviceCounters(state, device, commands);
+	allocations.Report(state);
+}
+BENCHMARK(BM_TilemapFrame)->Arg(32)->Arg(100)->Arg(317)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+//Cpu cost of staging a frame of sprite sized sub rect uploads into one buffer, vs a queue write each
+static void BM_TextureUploads(benchmark::State& state)
+{
+	uint32_t const uploads = (uint32_t)state.range(0);
+	bool const batched = state.range(1) != 0;
+	constexpr wgpu::Extent3D k_tileSize = { 50, 38, 1 };
+
+	Gfx::NullDevice device;
+	Gfx::Texture atlas(wgpu::TextureDimension::_2D, { 1024, 1024, 1 }, wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::CopyDst,
+		4, 1, wgpu::TextureFormat::RGBA8Unorm, device, "Upload Atlas");
+	Gfx::TextureUploader uploader(device);
+	std::vector<uint8_t> texels(k_tileSize.width * k_tileSize.height * 4, 0x7f);
+	uint32_t const tilesPerRow = atlas.Extents().width / k_tileSize.width;
+
+	device.ResetStats();
+	for (auto _ : state)
+	{
+		device.ClearCommands();
+		wgpu::CommandEncoder encoder = device.BeginCommands("Frame");
+		for (uint32_t i = 0; i < uploads; ++i)
+		{
+			wgpu::Origin3D origin = { (i % tilesPerRow) * k_tileSize.width, (i / tilesPerRow) * k_tileSize.height % (atlas.Extents().height - k_tileSize.height), 0 };
+			if (batched) uploader.Enqueue(atlas, texels.data(), k_tileSize, origin);
+			else atlas.EnqueueCopy(texels.data(), k_tileSize, origin);
+		}
+		uploader.Flush(encoder);
+		device.Submit(encoder);
+	}
+
+	auto const& stats = device.Stats();
+	double frames = (double)state.iterations();
+	state.SetItemsProcessed(state.iterations() * uploads);
+	state.counters["queueWritesPerFrame"] = (double)(stats.bufferWrites + stats.textureWrites) / frames;
+	state.counters["copiesPerFrame"] = (double)stats.textureCopies / frames;
+	state.counters["stagedBytesPerFrame"] = (double)stats.textureBytesCopied / frames;
+}
+BENCHMARK(BM_TextureUploads)->Args({ 16, 0 })->Args({ 16, 1 })->Args({ 128, 0 })->Args({ 128, 1 })->Unit(benchmark::kMicrosecond);
+
+//Per draw encoding cost, sorted draw list encoded every frame vs the same draws replayed from a bundle
+static void FillDraws(Gfx::NullDevice& device, Gfx::DrawList& draws, uint32_t count,
+	std::vector<wgpu::RenderPipeline>& pipelines, std::vector<wgpu::BindGroup>& bindGroups)
+{
+	constexpr uint32_t k_pipelineCount = 4;
+	constexpr uint32_t k_bindGroupCount = 16;
+	for (uint32_t i = 0; i < k_pipelineCount; ++i) pipelines.push_back(device.CreateRenderPipeline({}));
+	for (uint32_t i = 0; i < k_bindGroupCount; ++i) bindGroups.push_back(device.CreateBindGroup({}));
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		Gfx::DrawCommand draw;
+		draw.pipeline = pipelines[i % k_pipelineCount];
+		draw.bindGroup = bindGroups[(i / k_pipelineCount) % k_bindGroupCount];
+		draw.vertexOrIndexCount = 6;
+		draws.Add(Gfx::DrawKey::Make(Gfx::k_mainPass, i % k_pipelineCount, (i / k_pipelineCount) % k_bindGroupCount, 0.f, 0), draw);
+	}
+	draws.Sort();
+}
+
+static void ReleaseDraws(Gfx::NullDevice& device, std::vector<wgpu::RenderPipeline> const& pipelines, std::vector<wgpu::BindGroup> const& bindGroups)
+{
+	for (auto pipeline : pipelines) device.Release(pipeline);
+	for (auto bindGroup : bindGroups) device.Release(bindGroup);
+}
+
+static void BM_EncodeDrawList(benchmark::State& state)
+{
+	Gfx::NullDevice device;
+	Gfx::DrawList draws;
+	std::vector<wgpu::RenderPipeline> pipelines;
+	std::vector<wgpu::BindGroup> bindGroups;
+	FillDraws(device, draws, (uint32_t)state.range(0), pipelines, bindGroups);
+
+	wgpu::RenderPassDescriptor passDesc{};
+	device.ResetStats();
+	size_t commands = 0;
+	SteadyAllocations allocations;
+	for (auto _ : state)
+	{
+		SteadyFrame frame(allocations);
+		device.ClearCommands();
+		wgpu::CommandEncoder encoder = device.BeginCommands("Frame");
+		Gfx::RenderEncoder& pass = device.BeginRenderPass(encoder, passDesc);
+		draws.Encode(Gfx::k_mainPass, pass);
+		device.EndRenderPass(pass);
+		device.Submit(encoder);
+		commands = device.Commands().size();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	ReportDeviceCounters(state, device, commands);
+	allocations.Report(state);
+	ReleaseDraws(device, pipelines, bindGroups);
+}
+BENCHMARK(BM_EncodeDrawList)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ExecuteDrawBundle(benchmark::State& state)
+{
+	Gfx::NullDevice device;
+	std::vector<wgpu::RenderPipeline> pipelines;
+	std::vector<wgpu::BindGroup> bindGroups;
+	{
+		Gfx::DrawList draws;
+		Gfx::DrawBundle bundle({ NullScene::k_colorFormat }, NullScene::k_depthFormat, "Bench Bundle", device);
+		FillDraws(device, draws, (uint32_t)state.range(0), pipelines, bindGroups);
+
+		wgpu::RenderPassDescriptor passDesc{};
+		device.ResetStats();
+		size_t commands = 0;
+		SteadyAllocations allocations;
+		for (auto _ : state)
+		{
+			SteadyFrame frame(allocations);
+			device.ClearCommands();
+			//Layout never changes so only the first frame records
+			bundle.Update(1, draws, Gfx::k_mainPass);
+
+			wgpu::CommandEncoder encoder = device.BeginCommands("Frame");
+			Gfx::RenderEncoder& pass = device.BeginRenderPass(encoder, passDesc);
+			bundle.Execute(pass);
+			device.EndRenderPass(pass);
+			device.Submit(encoder);
+			commands = device.Commands().size();
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		ReportDeviceCounters(state, device, commands);
+		allocations.Report(state);
+	}
+	ReleaseDraws(device, pipelines, bindGroups);
+}
+BENCHMARK(BM_ExecuteDrawBundle)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
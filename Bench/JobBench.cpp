@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cmath>
+#include <optional>
+#include <vector>
+#include "JobSystem.h"
+#include "Terrain.h"
+
+namespace
+{
+	//0 is one worker per hardware thread
+	uint32_t WorkersArg(int64_t arg)
+	{
+		return arg == 0 ? Jobs::JobSystem::DefaultWorkerCount() : (uint32_t)arg;
+	}
+}
+
+//Scheduling overhead: empty jobs queued from one thread then waited on, the rest steal them
+static void BM_JobSpawnWait(benchmark::State& state)
+{
+	uint32_t const jobCount = (uint32_t)state.range(0);
+	Jobs::JobSystem jobs(WorkersArg(state.range(1)));
+	std::atomic<uint32_t> ran = 0;
+
+	for (auto _ : state)
+	{
+		Jobs::Counter counter;
+		for (uint32_t i = 0; i < jobCount; ++i) jobs.Run(counter, [&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+		jobs.Wait(counter);
+	}
+
+	benchmark::DoNotOptimize(ran.load());
+	state.SetItemsProcessed(state.iterations() * jobCount);
+}
+BENCHMARK(BM_JobSpawnWait)->Args({ 1, 1 })->Args({ 1000, 1 })->Args({ 1000, 2 })->Args({ 1000, 4 })->Args({ 1000, 0 })
+	->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+//Scaling across cores with compute bound chunks
+static void BM_ParallelForScaling(benchmark::State& state)
+{
+	Jobs::JobSystem jobs(WorkersArg(state.range(0)));
+	std::vector<float> values(1 << 20);
+	for (size_t i = 0; i < values.size(); ++i) values[i] = (float)i;
+
+	for (auto _ : state)
+	{
+		jobs.ParallelFor((uint32_t)values.size(), 4096, [&values](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) values[i] = std::sqrt(values[i] * 1.0001f + 1.f);
+		});
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * (int64_t)values.size());
+	state.counters["workers"] = (double)jobs.WorkerCount();
+}
+BENCHMARK(BM_ParallelForScaling)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(0)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+//Chunks that spawn their own chunks, most of the work ends up stolen
+static void BM_NestedParallelFor(benchmark::State& state)
+{
+	Jobs::JobSystem jobs(WorkersArg(state.range(0)));
+	std::atomic<uint64_t> sum = 0;
+
+	for (auto _ : state)
+	{
+		jobs.ParallelFor(64, 1, [&](uint32_t, uint32_t) {
+			jobs.ParallelFor(1024, 64, [&](uint32_t begin, uint32_t end) {
+				uint64_t local = 0;
+				for (uint32_t i = begin; i < end; ++i) local += (uint64_t)i * i;
+				sum.fetch_add(local, std::memory_order_relaxed);
+			});
+		});
+	}
+
+	benchmark::DoNotOptimize(sum.load());
+	state.SetItemsProcessed(state.iterations() * 64 * 1024);
+}
+BENCHMARK(BM_NestedParallelFor)->Arg(1)->Arg(4)->Arg(0)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+//Terrain rows generated across the workers, 0 runs without a job system
+static void BM_TerrainGenerate(benchmark::State& state)
+{
+	uint32_t const side = (uint32_t)state.range(0);
+	uint32_t const workers = (uint32_t)state.range(1);
+	std::optional<Jobs::JobSystem> jobs;
+	if (workers > 0) jobs.emplace(workers);
+
+	Terrain terrain(1, 1, 50);
+	for (auto _ : state)
+	{
+		terrain.Generate(side, side, 50, jobs ? &*jobs : nullptr);
+		benchmark::DoNotOptimize(terrain.CellCount());
+	}
+
+	state.SetItemsProcessed(state.iterations() * side * side);
+}
+BENCHMARK(BM_TerrainGenerate)->Args({ 1000, 0 })->Args({ 1000, 1 })->Args({ 1000, 4 })->Unit(benchmark::kMillisecond)->UseRealTime();
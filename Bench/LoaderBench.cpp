@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "Utils.h"
+#include "Terrain.h"
+#include "SpriteAnimPipeline.h"
+
+namespace
+{
+	std::filesystem::path const k_assetsPath = ASSETS_DIR;
+
+	//The loaders log every load, which would bury the benchmark output
+	class SilenceCout {
+	public:
+		SilenceCout() : _pPrevious(std::cout.rdbuf(_discard.rdbuf())) {}
+		~SilenceCout() { std::cout.rdbuf(_pPrevious); }
+
+	private:
+		//No copy, move
+		SilenceCout(SilenceCout const& other) = delete;
+		SilenceCout(SilenceCout&& other) = delete;
+		SilenceCout& operator=(SilenceCout const& other) = delete;
+		SilenceCout& operator=(SilenceCout&& other) = delete;
+
+		std::ostringstream _discard;
+		std::streambuf* _pPrevious;
+	};
+}
+
+//Single png frame, decode and copy into a TextureResource
+static void BM_LoadTexture(benchmark::State& state)
+{
+	std::filesystem::path const path = k_assetsPath / "cell1" / "cell1_1.png";
+	int64_t bytes = 0;
+	for (auto _ : state)
+	{
+		auto oTexture = Utils::LoadTexture(path);
+		if (!oTexture)
+		{
+			state.SkipWithError("Missing cell1_1.png");
+			return;
+		}
+		bytes += (int64_t)oTexture->SizeBytes();
+		benchmark::DoNotOptimize(oTexture->data.data());
+	}
+	state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_LoadTexture)->Unit(benchmark::kMicrosecond);
+
+//Every frame of an animation folder, sorted and packed into one strip
+static void BM_LoadAnimationTexture(benchmark::State& state)
+{
+	SilenceCout silence;
+	std::filesystem::path const path = k_assetsPath / "cell1";
+	int64_t bytes = 0;
+	for (auto _ : state)
+	{
+		auto oStrip = Utils::LoadAnimationTexture(path);
+		if (!oStrip)
+		{
+			state.SkipWithError("Missing cell1 animation");
+			return;
+		}
+		bytes += (int64_t)oStrip->SizeBytes();
+		benchmark::DoNotOptimize(oStrip->data.data());
+	}
+	state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_LoadAnimationTexture)->Unit(benchmark::kMillisecond);
+
+//Packing frames of side x side RGBA8 texels into a strip, without the decode
+static void BM_CopyIntoSquare(benchmark::State& state)
+{
+	uint32_t const side = (uint32_t)state.range(0);
+	uint32_t const frames = (uint32_t)state.range(1);
+	uint32_t const frameRowBytes = side * 4;
+	uint32_t const stripRowBytes = frameRowBytes * frames;
+
+	std::vector<std::byte> frame((size_t)frameRowBytes * side, std::byte{ 0x7f });
+	std::vector<std::byte> strip((size_t)stripRowBytes * side);
+	for (auto _ : state)
+	{
+		for (uint32_t i = 0; i < frames; ++i)
+		{
+			Utils::CopyIntoSquare(strip.data(), stripRowBytes, i * frameRowBytes, frame.data(), frameRowBytes, (uint32_t)frame.size());
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * (int64_t)strip.size());
+}
+BENCHMARK(BM_CopyIntoSquare)->Args({ 50, 8 })->Args({ 128, 8 })->Args({ 512, 8 })->Unit(benchmark::kMicrosecond);
+
+static void BM_LoadGeometry(benchmark::State& state)
+{
+	std::filesystem::path const path = k_assetsPath / "pyramid.obj";
+	for (auto _ : state)
+	{
+		auto oObject = Utils::LoadGeometry(path);
+		if (!oObject)
+		{
+			state.SkipWithError("Missing pyramid.obj");
+			return;
+		}
+		benchmark::DoNotOptimize(oObject->shapes.data());
+	}
+}
+BENCHMARK(BM_LoadGeometry)->Unit(benchmark::kMicrosecond);
+
+//Serial construction, BM_TerrainGenerate covers it spread over workers
+static void BM_TerrainConstruct(benchmark::State& state)
+{
+	uint32_t const side = (uint32_t)state.range(0);
+	for (auto _ : state)
+	{
+		Terrain terrain(side, side, 50);
+		benchmark::DoNotOptimize(terrain.CellCount());
+	}
+	state.SetItemsProcessed(state.iterations() * side * side);
+}
+BENCHMARK(BM_TerrainConstruct)->Arg(10)->Arg(100)->Arg(317)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+//One simulation step plus the frame indices it implies, computed with the cpu reference of the sprite anim pass
+static void BM_TerrainAnimate(benchmark::State& state)
+{
+	uint32_t const side = (uint32_t)state.range(0);
+	Terrain terrain(side, side, 50);
+	std::vector<SpriteAnimState> states;
+	std::vector<AnimUniform> animations;
+	terrain.Sprites().Gather(states);
+	terrain.Sprites().Gather(animations);
+
+	for (auto _ : state)
+	{
+		terrain.Animate();
+		Gfx::AnimateSprites(states, terrain.AnimTick(), animations);
+		benchmark::DoNotOptimize(animations.data());
+	}
+	state.SetItemsProcessed(state.iterations() * side * side);
+}
+BENCHMARK(BM_TerrainAnimate)->Arg(10)->Arg(100)->Arg(317)->Arg(1000)->Unit(benchmark::kMicrosecond);
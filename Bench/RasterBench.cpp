@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "SoftwareRasterizer.h"
+#include "QuadCulling.h"
+#include "Terrain.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
+
+namespace
+{
+	//Checkerboard stand in for the animation strips so the benchmark doesn't need assets
+	TextureResource MakeCheckerLayer(uint32_t width, uint32_t height, uint8_t alpha)
+	{
+		TextureResource layer{ width, height, 1, 4, {}, "checker" };
+		layer.data.resize(layer.SizeBytes());
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				uint8_t value = ((x / 8 + y / 8) % 2) ? 220 : 40;
+				std::byte* pTexel = layer.data.data() + ((size_t)y * width + x) * 4;
+				pTexel[0] = (std::byte)value;
+				pTexel[1] = (std::byte)(255 - value);
+				pTexel[2] = (std::byte)value;
+				pTexel[3] = (std::byte)alpha;
+			}
+		}
+		return layer;
+	}
+}
+
+//Terrain frame rendered on the cpu at 1280x720, one terrain cell is 50 pixels at the default camera
+static void BM_SoftwareRasterizeTerrain(benchmark::State& state)
+{
+	uint32_t side = (uint32_t)state.range(0);
+	uint32_t workers = state.range(1) == 0 ? Jobs::JobSystem::DefaultWorkerCount() : (uint32_t)state.range(1);
+
+	Terrain terrain(side, side, 50);
+	std::vector<QuadTransform> cells;
+	std::vector<AnimUniform> animations;
+	terrain.Sprites().Gather(cells);
+	terrain.Sprites().Gather(animations);
+	std::vector<TextureResource> layers{ MakeCheckerLayer(400, 38, 255), MakeCheckerLayer(400, 38, 128) };
+
+	CamUniforms camera;
+	camera.position = Vec2f{ 640.f, 360.f };
+	camera.extents = Vec2f{ 640.f, 360.f };
+	std::vector<uint32_t> visible(cells.size());
+	visible.resize(Gfx::CullQuads(cells, camera, visible));
+
+	Gfx::RasterTarget target;
+	target.Resize(1280, 720);
+	Jobs::JobSystem jobs(workers);
+	Gfx::SoftwareRasterizer rasterizer(&jobs);
+	Memory::FrameArena frameArena;
+
+	for (auto _ : state)
+	{
+		frameArena.NextFrame();
+		target.Clear(Vec4f{ 0.9f, 0.1f, 0.2f, 1.f }, 1.f);
+		rasterizer.DrawQuads({ cells, animations, camera, visible, layers }, target, frameArena.Resource());
+		benchmark::DoNotOptimize(target.color.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * (int64_t)target.color.size());
+	state.counters["quads"] = (double)visible.size();
+}
+BENCHMARK(BM_SoftwareRasterizeTerrain)->Args({ 10, 1 })->Args({ 30, 1 })->Args({ 30, 4 })->Args({ 30, 0 })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,180 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	struct ThreadCounters
+	{
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t bytes = 0;
+		uint32_t noAllocationDepth = 0;
+	};
+
+	//Plain thread_local data with constant initialization, reading it can't allocate or recurse into new
+	constinit thread_local ThreadCounters t_counters;
+
+	std::atomic<uint64_t> g_allocations{ 0 };
+	std::atomic<uint64_t> g_frees{ 0 };
+	std::atomic<uint64_t> g_bytes{ 0 };
+	std::atomic<uint64_t> g_violations{ 0 };
+	std::atomic<int> g_strict{ -1 }; //-1 until the environment variable has been read
+
+	[[maybe_unused]] void OnAllocate(size_t bytes) noexcept
+	{
+		++t_counters.allocations;
+		t_counters.bytes += bytes;
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+		g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+		if (t_counters.noAllocationDepth == 0) return;
+		g_violations.fetch_add(1, std::memory_order_relaxed);
+		if (Memory::StrictAllocations())
+		{
+			//stdio rather than cout, the stream could allocate from in here
+			std::fprintf(stderr, "Allocated %zu bytes inside a NoAllocationScope\n", bytes);
+			std::abort();
+		}
+	}
+
+	[[maybe_unused]] void OnFree(void* p) noexcept
+	{
+		if (!p) return;
+		++t_counters.frees;
+		g_frees.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+namespace Memory
+{
+	AllocationCounters ThreadAllocations() noexcept
+	{
+		return { t_counters.allocations, t_counters.frees, t_counters.bytes };
+	}
+
+	AllocationCounters GlobalAllocations() noexcept
+	{
+		return { g_allocations.load(std::memory_order_relaxed), g_frees.load(std::memory_order_relaxed), g_bytes.load(std::memory_order_relaxed) };
+	}
+
+	uint64_t AllocationViolations() noexcept
+	{
+		return g_violations.load(std::memory_order_relaxed);
+	}
+
+	void SetStrictAllocations(bool strict) noexcept
+	{
+		g_strict.store(strict ? 1 : 0, std::memory_order_relaxed);
+	}
+
+	bool StrictAllocations() noexcept
+	{
+		int strict = g_strict.load(std::memory_order_relaxed);
+		if (strict < 0)
+		{
+			char const* value = std::getenv("RENDERER_STRICT_ALLOCATIONS");
+			strict = value && value[0] == '1' ? 1 : 0;
+			g_strict.store(strict, std::memory_order_relaxed);
+		}
+		return strict == 1;
+	}
+
+	NoAllocationScope::NoAllocationScope(bool active) noexcept
+		: _active(active)
+	{
+		if (_active) ++t_counters.noAllocationDepth;
+	}
+
+	NoAllocationScope::~NoAllocationScope()
+	{
+		if (_active) --t_counters.noAllocationDepth;
+	}
+}
+
+#ifdef RENDERER_TRACK_ALLOCATIONS
+//Replacements for the global operators. Everything funnels into these four, the array, nothrow and sized forms forward to them
+namespace
+{
+	void* Allocate(size_t bytes)
+	{
+		if (bytes == 0) bytes = 1;
+		void* p = std::malloc(bytes);
+		if (!p) throw std::bad_alloc();
+		OnAllocate(bytes);
+		return p;
+	}
+
+	void* AllocateAligned(size_t bytes, std::align_val_t alignment)
+	{
+		size_t const align = (size_t)alignment;
+		if (bytes == 0) bytes = 1;
+#ifdef _MSC_VER
+		void* p = _aligned_malloc(bytes, align);
+#else
+		//aligned_alloc wants the size to be a multiple of the alignment
+		void* p = std::aligned_alloc(align, (bytes + align - 1) / align * align);
+#endif
+		if (!p) throw std::bad_alloc();
+		OnAllocate(bytes);
+		return p;
+	}
+
+	void Free(void* p) noexcept
+	{
+		OnFree(p);
+		std::free(p);
+	}
+
+	void FreeAligned(void* p) noexcept
+	{
+		OnFree(p);
+#ifdef _MSC_VER
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+void* operator new(size_t bytes) { return Allocate(bytes); }
+void* operator new[](size_t bytes) { return Allocate(bytes); }
+void* operator new(size_t bytes, std::align_val_t alignment) { return AllocateAligned(bytes, alignment); }
+void* operator new[](size_t bytes, std::align_val_t alignment) { return AllocateAligned(bytes, alignment); }
+
+void* operator new(size_t bytes, std::nothrow_t const&) noexcept
+{
+	try { return Allocate(bytes); }
+	catch (...) { return nullptr; }
+}
+void* operator new[](size_t bytes, std::nothrow_t const&) noexcept
+{
+	try { return Allocate(bytes); }
+	catch (...) { return nullptr; }
+}
+void* operator new(size_t bytes, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+	try { return AllocateAligned(bytes, alignment); }
+	catch (...) { return nullptr; }
+}
+void* operator new[](size_t bytes, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+	try { return AllocateAligned(bytes, alignment); }
+	catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept { FreeAligned(p); }
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept { FreeAligned(p); }
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+//Opt in counting of heap allocations. Built with RENDERER_TRACK_ALLOCATIONS the global operator new/delete are
+//replaced with versions that count per thread and in total, otherwise everything here reads zero and costs nothing.
+//Profile scopes record the allocations made inside them, frames can diff the counters around the loop body
+namespace Memory
+{
+#ifdef RENDERER_TRACK_ALLOCATIONS
+	constexpr bool k_trackAllocations = true;
+#else
+	constexpr bool k_trackAllocations = false;
+#endif
+
+	struct AllocationCounters
+	{
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t bytes = 0; //Requested by allocations, frees aren't sized so this only grows
+
+		AllocationCounters operator-(AllocationCounters const& other) const noexcept
+		{
+			return { allocations - other.allocations, frees - other.frees, bytes - other.bytes };
+		}
+	};
+
+	//Since startup
+	AllocationCounters ThreadAllocations() noexcept;
+	AllocationCounters GlobalAllocations() noexcept;
+
+	//Allocations made inside a NoAllocationScope on any thread
+	uint64_t AllocationViolations() noexcept;
+
+	//Strict mode aborts on the first allocation inside a NoAllocationScope, printing its size, so a debugger stops on the
+	//offending call. Starts on when the RENDERER_STRICT_ALLOCATIONS environment variable is 1
+	void SetStrictAllocations(bool strict) noexcept;
+	bool StrictAllocations() noexcept;
+
+	//Marks code on this thread that must not allocate, e.g. a steady state frame. Scopes nest
+	class NoAllocationScope {
+	public:
+		explicit NoAllocationScope(bool active = true) noexcept;
+		~NoAllocationScope();
+
+	private:
+		//No copy, move
+		NoAllocationScope(NoAllocationScope const& other) = delete;
+		NoAllocationScope(NoAllocationScope&& other) = delete;
+		NoAllocationScope& operator=(NoAllocationScope const& other) = delete;
+		NoAllocationScope& operator=(NoAllocationScope&& other) = delete;
+
+		bool _active;
+	};
+}
@@ -1,28 +1,29 @@
 #include "Buffer.h"
+#include <cassert>
 
 namespace Gfx
 {
-	void Buffer::EnqueueCopy(void const* pData, uint32_t size, uint32_t bufferOffset, wgpu::Queue& queue)
+	void Buffer::EnqueueCopy(void const* pData, uint32_t size, uint32_t bufferOffset)
 	{
 		assert(size <= _size);
-		queue.writeBuffer(_handle, bufferOffset, pData, size);
+		_pDevice->WriteBuffer(_handle, bufferOffset, pData, size);
 	}
 
-	void Buffer::EnqueueCopy(void const* pData, uint32_t bufferOffset, wgpu::Queue& queue)
+	void Buffer::EnqueueCopy(void const* pData, uint32_t bufferOffset)
 	{
-		EnqueueCopy(pData, _size, bufferOffset, queue);
+		EnqueueCopy(pData, _size, bufferOffset);
 	}
 
 	Buffer::~Buffer()
 	{
 		if (_handle) {
-			_handle.destroy();
-			_handle.release();
+			_pDevice->Release(_handle);
 		}
 	}
 
-	Buffer::Buffer(uint32_t size, int usageFlags, std::string const& label, wgpu::Device device)
-		: _handle(nullptr)
+	Buffer::Buffer(uint32_t size, int usageFlags, std::string const& label, Gfx::Device& device)
+		: _pDevice(&device)
+		, _handle(nullptr)
 		, _size(size)
 	{
 		wgpu::BufferDescriptor desc;
@@ -32,7 +33,7 @@ namespace Gfx
 		desc.size = size;
 		desc.usage = usageFlags;
 
-		_handle = device.createBuffer(desc);
+		_handle = device.CreateBuffer(desc);
 	}
 
-}
\ No newline at end of file
+}
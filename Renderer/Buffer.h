@@ -2,22 +2,30 @@
 #include <cstdint>
 #include <string>
 #include "webgpu.h"
+#include "GfxDevice.h"
 
 namespace Gfx
 {
 	class Buffer
 	{
 	public:
-		Buffer(uint32_t size, int usageFlags, std::string const& label, wgpu::Device device);
+		Buffer(uint32_t size, int usageFlags, std::string const& label, Gfx::Device& device);
 		~Buffer();
 
-		void EnqueueCopy(void const* pData, uint32_t size, uint32_t bufferOffset, wgpu::Queue& queue);
-		void EnqueueCopy(void const* pData, uint32_t bufferOffset, wgpu::Queue& queue);
+		void EnqueueCopy(void const* pData, uint32_t size, uint32_t bufferOffset);
+		void EnqueueCopy(void const* pData, uint32_t bufferOffset);
 
 		inline wgpu::Buffer const& Get() const { return _handle; }
 		inline uint32_t Size() const { return _size; }
 
 	private:
+		//No copy, move
+		Buffer(Buffer const& other) = delete;
+		Buffer(Buffer&& other) = delete;
+		Buffer& operator=(Buffer const& other) = delete;
+		Buffer& operator=(Buffer&& other) = delete;
+
+		Gfx::Device* _pDevice;
 		wgpu::Buffer _handle;
 		uint32_t _size;
 	};
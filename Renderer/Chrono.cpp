@@ -0,0 +1,45 @@
+#include "Chrono.h"
+
+namespace Clock
+{
+	FrameClock::FrameClock(Duration fixedStep, uint32_t maxCatchUpSteps, TimePoint start)
+		: _lastFrameTime(start)
+		, _delta(0)
+		, _accumulator(0)
+		, _fixedStep(fixedStep)
+		, _maxCatchUpSteps(maxCatchUpSteps)
+		, _steps(0)
+		, _droppedSteps(0)
+	{
+	}
+
+	uint32_t FrameClock::Tick()
+	{
+		return Tick(Clock::now());
+	}
+
+	uint32_t FrameClock::Tick(TimePoint now)
+	{
+		_delta = now - _lastFrameTime;
+		_lastFrameTime = now;
+
+		//Integer nanoseconds so the step count never drifts from rounding
+		_accumulator += _delta;
+		uint64_t steps = (uint64_t)(_accumulator / _fixedStep);
+		_accumulator -= steps * _fixedStep;
+
+		if (steps > _maxCatchUpSteps)
+		{
+			_droppedSteps += steps - _maxCatchUpSteps;
+			steps = _maxCatchUpSteps;
+		}
+		_steps += steps;
+		return (uint32_t)steps;
+	}
+
+	FrameClock& Get()
+	{
+		static FrameClock clock;
+		return clock;
+	}
+}
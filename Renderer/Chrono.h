@@ -1,4 +1,6 @@
-#include<chrono>
+#pragma once
+#include <chrono>
+#include <cstdint>
 
 namespace Clock
 {
@@ -7,24 +9,46 @@ namespace Clock
 	using Duration = std::chrono::nanoseconds;
 
 	constexpr float k_nanosecondsInSecond = 1'000'000'000;
+	constexpr Duration k_fixedStep = std::chrono::nanoseconds(1'000'000'000 / 60);
+	//After a long stall (debugger, window drag) at most this many steps are run, the rest of the backlog is dropped
+	constexpr uint32_t k_maxCatchUpSteps = 5;
 
-	namespace {
-		Clock g_clock;
-		TimePoint lastFrameTime = g_clock.now();
-		Duration deltaTime;
-	}
-
-	static void Tick()
-	{
-		auto nowTime = g_clock.now();
-		deltaTime = nowTime.time_since_epoch() - lastFrameTime.time_since_epoch();
-		lastFrameTime = nowTime;
-	}
-
-	static float GetDelta()
-	{
-		return (float)deltaTime.count() / k_nanosecondsInSecond;
-	}
-}
+	//Real frame time plus a fixed step accumulator. The simulation advances in whole steps of FixedDelta,
+	//so its results don't depend on the display rate; rendering uses Alpha to blend between the last two steps.
+	//Not thread safe, each thread that steps time owns one. All of them read the same steady clock
+	class FrameClock {
+	public:
+		//The first Tick measures from start
+		FrameClock(Duration fixedStep = k_fixedStep, uint32_t maxCatchUpSteps = k_maxCatchUpSteps, TimePoint start = Clock::now());
+
+		//Call once per frame, returns how many fixed steps to simulate this frame.
+		//Tick(now) takes the time explicitly, for deterministic stepping
+		uint32_t Tick();
+		uint32_t Tick(TimePoint now);
+
+		//Real time since the previous Tick, in seconds
+		inline float GetDelta() const noexcept { return (float)_delta.count() / k_nanosecondsInSecond; }
+		inline float FixedDelta() const noexcept { return (float)_fixedStep.count() / k_nanosecondsInSecond; }
 
+		//How far between the last simulated step and the next one the current frame is, in [0, 1)
+		inline float Alpha() const noexcept { return (float)_accumulator.count() / (float)_fixedStep.count(); }
 
+		//Fixed steps taken since construction
+		inline uint64_t Steps() const noexcept { return _steps; }
+		//Steps dropped by the catch up cap
+		inline uint64_t DroppedSteps() const noexcept { return _droppedSteps; }
+
+	private:
+		TimePoint _lastFrameTime;
+		Duration _delta;
+		Duration _accumulator;
+		Duration _fixedStep;
+		uint32_t _maxCatchUpSteps;
+		uint64_t _steps;
+		uint64_t _droppedSteps;
+	};
+
+	//The clock the render loop ticks once per frame, for frame times. Render thread only: the simulation thread
+	//keeps its own FrameClock, ticking this one as well would split each frame's delta between the two threads
+	FrameClock& Get();
+}
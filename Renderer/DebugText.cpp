@@ -0,0 +1,122 @@
+#include "DebugText.h"
+#include <algorithm>
+#include "Profiler.h"
+
+namespace
+{
+	constexpr uint32_t k_textPipelineId = 1;
+	constexpr uint32_t k_fontTextureId = 1;
+	constexpr char k_fallbackGlyph = '?';
+}
+
+namespace Gfx
+{
+	DebugText::DebugText(Gfx::Device& device, FontResource const& font, wgpu::ShaderModule shader,
+		wgpu::TextureFormat colorFormat, wgpu::TextureFormat depthFormat)
+		: _glyphs(font.glyphs)
+		, _lineHeight(font.lineHeight)
+		, _atlas(wgpu::TextureDimension::_2D, font.atlas.Extents(), wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::CopyDst,
+			4, 1, wgpu::TextureFormat::RGBA8Unorm, device, "Debug Font Atlas")
+		, _glyphBuffer(k_maxDebugGlyphs * (uint32_t)sizeof(GlyphInstance), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+			"Debug Text Glyphs", device)
+		, _screenBuffer(sizeof(TextUniforms), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, "Debug Text Screen", device)
+		, _pipeline(device, shader, colorFormat, depthFormat)
+		, _frame(0)
+	{
+		_atlas.EnqueueCopy(font.atlas.data.data(), font.atlas.Extents());
+		_pipeline.BindData(_glyphBuffer, _atlas, _screenBuffer);
+		_instances.reserve(k_maxDebugGlyphs);
+		_screen.screenSize = Vec2f{ 0.f, 0.f };
+	}
+
+	void DebugText::BeginFrame(Vec2f screenSize)
+	{
+		++_frame;
+		_instances.clear();
+		_stats = {};
+
+		std::erase_if(_layouts, [this](auto const& entry) { return entry.second.lastUsedFrame + 1 < _frame; });
+
+		if (screenSize != _screen.screenSize)
+		{
+			_screen.screenSize = screenSize;
+			_screenBuffer.EnqueueCopy(&_screen, 0);
+		}
+	}
+
+	void DebugText::LayoutString(std::string_view text, Layout& layout) const
+	{
+		layout.glyphs.clear();
+		Vec2f pen{ 0.f, 0.f };
+		for (char c : text)
+		{
+			if (c == '\n')
+			{
+				pen = Vec2f{ 0.f, pen.y + _lineHeight };
+				continue;
+			}
+
+			uint32_t glyphIndex = (uint32_t)(unsigned char)c - k_firstFontGlyph;
+			if (glyphIndex >= k_fontGlyphCount) glyphIndex = (uint32_t)k_fallbackGlyph - k_firstFontGlyph;
+			GlyphResource const& glyph = _glyphs[glyphIndex];
+
+			//Whitespace only moves the pen
+			if (glyph.x1 > glyph.x0 && glyph.y1 > glyph.y0)
+			{
+				GlyphInstance instance;
+				instance.rect = Vec4f{ pen.x + glyph.x0, pen.y + glyph.y0, glyph.x1 - glyph.x0, glyph.y1 - glyph.y0 };
+				instance.uvRect = Vec4f{ glyph.u0, glyph.v0, glyph.u1, glyph.v1 };
+				instance.color = Vec4f{ 1.f, 1.f, 1.f, 1.f };
+				layout.glyphs.push_back(instance);
+			}
+			pen.x += glyph.advance;
+		}
+	}
+
+	void DebugText::Print(std::string_view text, Vec2f position, Vec4f color)
+	{
+		auto it = _layouts.find(text);
+		if (it == _layouts.end())
+		{
+			it = _layouts.emplace(std::string(text), Layout{}).first;
+			LayoutString(text, it->second);
+			++_stats.layoutCacheMisses;
+		}
+		else
+		{
+			++_stats.layoutCacheHits;
+		}
+
+		Layout& layout = it->second;
+		layout.lastUsedFrame = _frame;
+		++_stats.strings;
+
+		size_t space = k_maxDebugGlyphs - _instances.size();
+		size_t count = std::min(space, layout.glyphs.size());
+		_stats.droppedGlyphs += (uint32_t)(layout.glyphs.size() - count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			GlyphInstance instance = layout.glyphs[i];
+			instance.rect.x += position.x;
+			instance.rect.y += position.y;
+			instance.color = color;
+			_instances.push_back(instance);
+		}
+	}
+
+	void DebugText::Submit(Gfx::DrawList& draws)
+	{
+		PROFILE_FUNCTION();
+		_stats.glyphs = (uint32_t)_instances.size();
+		if (_instances.empty()) return;
+
+		_glyphBuffer.EnqueueCopy(_instances.data(), (uint32_t)(_instances.size() * sizeof(GlyphInstance)), 0);
+
+		Gfx::DrawCommand textDraw;
+		textDraw.pipeline = _pipeline.Get();
+		textDraw.bindGroup = _pipeline.BindGroup();
+		textDraw.vertexOrIndexCount = 6;
+		textDraw.instanceCount = (uint32_t)_instances.size();
+		draws.Add(Gfx::DrawKey::Make(Gfx::k_overlayPass, k_textPipelineId, k_fontTextureId, 0.f, 0), textDraw);
+	}
+}
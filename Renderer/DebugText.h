@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "webgpu.h"
+#include "MathDefs.h"
+#include "ResourceDefs.h"
+#include "GfxDevice.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "DrawList.h"
+#include "TextRenderPipeline.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_maxDebugGlyphs = 4096;
+
+	struct DebugTextStats
+	{
+		uint32_t glyphs = 0;
+		uint32_t strings = 0;
+		uint32_t layoutCacheHits = 0;
+		uint32_t layoutCacheMisses = 0;
+		uint32_t droppedGlyphs = 0; //Past k_maxDebugGlyphs
+	};
+
+	//Immediate mode on screen text. Strings printed during a frame are laid out into one glyph instance stream
+	//and drawn with a single instanced draw in the overlay pass. Layouts are cached per string so unchanged text only costs a copy
+	class DebugText {
+	public:
+		DebugText(Gfx::Device& device, FontResource const& font, wgpu::ShaderModule shader,
+			wgpu::TextureFormat colorFormat, wgpu::TextureFormat depthFormat);
+
+		//Clears last frame's text, layouts that weren't printed last frame are dropped from the cache
+		void BeginFrame(Vec2f screenSize);
+
+		//position is the top left of the first line in pixels, '\n' starts a new line
+		void Print(std::string_view text, Vec2f position, Vec4f color = Vec4f{ 1.f, 1.f, 1.f, 1.f });
+
+		//Uploads the frame's glyphs and adds the draw for all of them to draws
+		void Submit(Gfx::DrawList& draws);
+
+		inline DebugTextStats const& Stats() const noexcept { return _stats; }
+		inline float LineHeight() const noexcept { return _lineHeight; }
+
+	private:
+		//No copy, move
+		DebugText(DebugText const& other) = delete;
+		DebugText(DebugText&& other) = delete;
+		DebugText& operator=(DebugText const& other) = delete;
+		DebugText& operator=(DebugText&& other) = delete;
+
+		//Glyphs relative to the string origin, color is applied when copied into the frame
+		struct Layout
+		{
+			std::vector<GlyphInstance> glyphs;
+			uint64_t lastUsedFrame = 0;
+		};
+
+		//Lets the cache be searched with a string_view without building a string
+		struct StringHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+		};
+
+		void LayoutString(std::string_view text, Layout& layout) const;
+
+		std::array<GlyphResource, k_fontGlyphCount> _glyphs;
+		float _lineHeight;
+
+		Gfx::Texture _atlas;
+		Gfx::Buffer _glyphBuffer;
+		Gfx::Buffer _screenBuffer;
+		Gfx::TextRenderPipeline _pipeline;
+
+		std::unordered_map<std::string, Layout, StringHash, std::equal_to<>> _layouts;
+		std::vector<GlyphInstance> _instances;
+		TextUniforms _screen;
+		uint64_t _frame;
+		DebugTextStats _stats;
+	};
+}
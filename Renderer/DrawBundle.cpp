@@ -0,0 +1,58 @@
+#include "DrawBundle.h"
+
+namespace Gfx
+{
+	DrawBundle::DrawBundle(std::vector<wgpu::TextureFormat> colorFormats, wgpu::TextureFormat depthStencilFormat, std::string const& label, Gfx::Device& device)
+		: _pDevice(&device)
+		, _bundle(nullptr)
+		, _colorFormats(std::move(colorFormats))
+		, _depthStencilFormat(depthStencilFormat)
+		, _label(label)
+		, _layoutVersion(0)
+	{
+	}
+
+	DrawBundle::~DrawBundle()
+	{
+		Invalidate();
+	}
+
+	bool DrawBundle::Update(uint64_t layoutVersion, DrawList& draws, uint32_t pass)
+	{
+		if (_bundle && layoutVersion == _layoutVersion) return false;
+		Invalidate();
+
+		wgpu::RenderBundleEncoderDescriptor encoderDesc{};
+		encoderDesc.label = _label.c_str();
+		encoderDesc.colorFormatCount = _colorFormats.size();
+		encoderDesc.colorFormats = (WGPUTextureFormat const*)_colorFormats.data();
+		encoderDesc.depthStencilFormat = _depthStencilFormat;
+		encoderDesc.sampleCount = 1;
+		encoderDesc.depthReadOnly = false;
+		encoderDesc.stencilReadOnly = true; //Must match the pass, we never write stencil
+		Gfx::RenderEncoder& encoder = _pDevice->BeginRenderBundle(encoderDesc);
+
+		draws.Encode(pass, encoder);
+
+		wgpu::RenderBundleDescriptor bundleDesc{};
+		bundleDesc.label = _label.c_str();
+		_bundle = _pDevice->FinishRenderBundle(encoder, bundleDesc);
+
+		_layoutVersion = layoutVersion;
+		return true;
+	}
+
+	void DrawBundle::Invalidate()
+	{
+		if (_bundle)
+		{
+			_pDevice->Release(_bundle);
+			_bundle = nullptr;
+		}
+	}
+
+	void DrawBundle::Execute(Gfx::RenderEncoder& pass) const
+	{
+		pass.ExecuteBundle(_bundle);
+	}
+}
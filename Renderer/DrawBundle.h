@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "webgpu.h"
+#include "DrawList.h"
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	//Records the draws of a pass once into a render bundle and replays it every frame.
+	//The bundle is only re-recorded when the layout version it was recorded with changes
+	class DrawBundle {
+	public:
+		DrawBundle(std::vector<wgpu::TextureFormat> colorFormats, wgpu::TextureFormat depthStencilFormat, std::string const& label, Gfx::Device& device);
+		~DrawBundle();
+
+		//Returns true if the bundle had to be recorded
+		bool Update(uint64_t layoutVersion, DrawList& draws, uint32_t pass);
+
+		//Forces a re-record on the next Update, e.g. when a bound buffer is recreated
+		void Invalidate();
+
+		void Execute(Gfx::RenderEncoder& pass) const;
+
+		inline bool IsValid() const noexcept { return _bundle; }
+
+	private:
+		//No copy, move
+		DrawBundle(DrawBundle const& other) = delete;
+		DrawBundle(DrawBundle&& other) = delete;
+		DrawBundle& operator=(DrawBundle const& other) = delete;
+		DrawBundle& operator=(DrawBundle&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::RenderBundle _bundle;
+		std::vector<wgpu::TextureFormat> _colorFormats;
+		wgpu::TextureFormat _depthStencilFormat;
+		std::string _label;
+		uint64_t _layoutVersion;
+	};
+}
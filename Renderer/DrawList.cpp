@@ -0,0 +1,95 @@
+#include "DrawList.h"
+#include <algorithm>
+#include "Profiler.h"
+
+namespace Gfx
+{
+	DrawList::DrawList(Jobs::JobSystem* pJobs)
+		: _pJobs(pJobs)
+	{
+	}
+
+	void DrawList::Reset()
+	{
+		_commands.clear();
+		_sorted.clear();
+		_stats = {};
+	}
+
+	void DrawList::Add(uint64_t key, DrawCommand const& command)
+	{
+		_sorted.push_back({ key, (uint32_t)_commands.size() });
+		_commands.push_back(command);
+	}
+
+	void DrawList::Sort(std::pmr::memory_resource* pScratch)
+	{
+		PROFILE_FUNCTION();
+		if (pScratch)
+		{
+			std::pmr::vector<SortItem> scratch(_sorted.size(), pScratch);
+			RadixSort(_sorted, scratch, _pJobs);
+			return;
+		}
+		if (_scratch.size() < _sorted.size()) _scratch.resize(_sorted.size());
+		RadixSort(_sorted, _scratch, _pJobs);
+	}
+
+	void DrawList::Encode(uint32_t pass, Gfx::RenderEncoder& encoder)
+	{
+		auto first = std::lower_bound(_sorted.begin(), _sorted.end(), pass, [](SortItem const& item, uint32_t p) {
+			return DrawKey::Pass(item.key) < p;
+		});
+
+		//Bound state is unknown at the start of a pass
+		wgpu::RenderPipeline boundPipeline = nullptr;
+		wgpu::BindGroup boundBindGroup = nullptr;
+		wgpu::Buffer boundVertexBuffer = nullptr;
+		wgpu::Buffer boundIndexBuffer = nullptr;
+
+		for (auto it = first; it != _sorted.end() && DrawKey::Pass(it->key) == pass; ++it)
+		{
+			DrawCommand const& command = _commands[it->index];
+
+			if (command.pipeline != boundPipeline)
+			{
+				encoder.SetPipeline(command.pipeline);
+				boundPipeline = command.pipeline;
+				++_stats.pipelineChanges;
+			}
+
+			if (command.bindGroup && command.bindGroup != boundBindGroup)
+			{
+				encoder.SetBindGroup(0, command.bindGroup);
+				boundBindGroup = command.bindGroup;
+				++_stats.bindGroupChanges;
+			}
+
+			if (command.vertexBuffer && command.vertexBuffer != boundVertexBuffer)
+			{
+				encoder.SetVertexBuffer(0, command.vertexBuffer, 0, command.vertexBufferSize);
+				boundVertexBuffer = command.vertexBuffer;
+				++_stats.vertexBufferChanges;
+			}
+
+			if (command.indexBuffer && command.indexBuffer != boundIndexBuffer)
+			{
+				encoder.SetIndexBuffer(command.indexBuffer, command.indexFormat, 0, command.indexBufferSize);
+				boundIndexBuffer = command.indexBuffer;
+				++_stats.indexBufferChanges;
+			}
+
+			if (command.indirectBuffer)
+			{
+				if (command.indexBuffer) encoder.DrawIndexedIndirect(command.indirectBuffer, command.indirectOffset);
+				else encoder.DrawIndirect(command.indirectBuffer, command.indirectOffset);
+			}
+			else
+			{
+				if (command.indexBuffer) encoder.DrawIndexed(command.vertexOrIndexCount, command.instanceCount, 0, 0, 0);
+				else encoder.Draw(command.vertexOrIndexCount, command.instanceCount, 0, 0);
+			}
+			++_stats.draws;
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "webgpu.h"
+#include "RadixSort.h"
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	//Pass ids used in draw keys
+	constexpr uint32_t k_mainPass = 0; //Scene color + depth
+	constexpr uint32_t k_overlayPass = 1; //Swap chain at native resolution after the upscale, no depth
+
+	//64 bit draw sort key, fields packed most significant first so sorting groups draws by
+	//| pass 4 | pipeline 8 | texture layer or atlas page 12 | depth 24 | material 16 |
+	namespace DrawKey
+	{
+		constexpr uint32_t k_passBits = 4;
+		constexpr uint32_t k_pipelineBits = 8;
+		constexpr uint32_t k_textureBits = 12;
+		constexpr uint32_t k_depthBits = 24;
+		constexpr uint32_t k_materialBits = 16;
+		static_assert(k_passBits + k_pipelineBits + k_textureBits + k_depthBits + k_materialBits == 64);
+
+		constexpr uint32_t k_materialShift = 0;
+		constexpr uint32_t k_depthShift = k_materialShift + k_materialBits;
+		constexpr uint32_t k_textureShift = k_depthShift + k_depthBits;
+		constexpr uint32_t k_pipelineShift = k_textureShift + k_textureBits;
+		constexpr uint32_t k_passShift = k_pipelineShift + k_pipelineBits;
+
+		constexpr uint64_t Mask(uint32_t bits) { return (1ull << bits) - 1; }
+
+		//depth is expected in [0,1] (ndc depth) and is quantized, smaller depths sort first. NaN sorts as 0
+		constexpr uint64_t Make(uint32_t pass, uint32_t pipeline, uint32_t texture, float depth, uint32_t material)
+		{
+			//Written so NaN fails the first test, casting it to an integer is undefined
+			float clampedDepth = !(depth >= 0.f) ? 0.f : (depth > 1.f ? 1.f : depth);
+			uint64_t quantizedDepth = (uint64_t)(clampedDepth * (float)Mask(k_depthBits));
+			return ((pass & Mask(k_passBits)) << k_passShift)
+				| ((pipeline & Mask(k_pipelineBits)) << k_pipelineShift)
+				| ((texture & Mask(k_textureBits)) << k_textureShift)
+				| ((quantizedDepth & Mask(k_depthBits)) << k_depthShift)
+				| ((material & Mask(k_materialBits)) << k_materialShift);
+		}
+
+		constexpr uint32_t Pass(uint64_t key) { return (uint32_t)((key >> k_passShift) & Mask(k_passBits)); }
+	}
+
+	//Everything needed to issue one draw, unset buffers are skipped.
+	//With an indirect buffer the counts come from the buffer instead
+	struct DrawCommand
+	{
+		wgpu::RenderPipeline pipeline = nullptr;
+		wgpu::BindGroup bindGroup = nullptr;
+		wgpu::Buffer vertexBuffer = nullptr;
+		uint64_t vertexBufferSize = 0;
+		wgpu::Buffer indexBuffer = nullptr;
+		uint64_t indexBufferSize = 0;
+		wgpu::IndexFormat indexFormat = wgpu::IndexFormat::Uint16;
+		wgpu::Buffer indirectBuffer = nullptr;
+		uint64_t indirectOffset = 0;
+		uint32_t vertexOrIndexCount = 0;
+		uint32_t instanceCount = 1;
+	};
+
+	//State changes issued by DrawList::Encode since the last Reset
+	struct DrawStats
+	{
+		uint32_t draws = 0;
+		uint32_t pipelineChanges = 0;
+		uint32_t bindGroupChanges = 0;
+		uint32_t vertexBufferChanges = 0;
+		uint32_t indexBufferChanges = 0;
+	};
+
+	//Collects a frame's draws, sorts them by key and encodes them with redundant state changes removed
+	class DrawList {
+	public:
+		//Large lists are sorted over pJobs' workers
+		explicit DrawList(Jobs::JobSystem* pJobs = nullptr);
+
+		//Clears draws and stats, keeps the allocations for the next frame
+		void Reset();
+
+		void Add(uint64_t key, DrawCommand const& command);
+
+		//The radix sort's scratch comes from pScratch, e.g. a Memory::FrameArena, or a buffer kept for the next frame
+		void Sort(std::pmr::memory_resource* pScratch = nullptr);
+
+		//Encodes the sorted draws whose key has the given pass
+		void Encode(uint32_t pass, Gfx::RenderEncoder& encoder);
+
+		inline DrawStats const& Stats() const noexcept { return _stats; }
+		inline size_t Size() const noexcept { return _commands.size(); }
+
+	private:
+		std::vector<DrawCommand> _commands;
+		std::vector<SortItem> _sorted;
+		std::vector<SortItem> _scratch;
+		DrawStats _stats;
+		Jobs::JobSystem* _pJobs;
+	};
+}
@@ -0,0 +1,85 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr float k_frameSmoothing = 0.1f;
+	//No change while the smoothed time is inside [target * low, target * high]
+	constexpr float k_deadBandLow = 0.85f;
+	constexpr float k_deadBandHigh = 1.05f;
+}
+
+namespace Gfx
+{
+	ResolutionController::ResolutionController(ResolutionControllerConfig const& config)
+		: _config(config)
+		, _scale(config.maxScale)
+		, _smoothedMs(0.f)
+		, _settleFrames(0)
+	{
+	}
+
+	float ResolutionController::Update(float frameMs)
+	{
+		_smoothedMs = _smoothedMs == 0.f ? frameMs : _smoothedMs + (frameMs - _smoothedMs) * k_frameSmoothing;
+		if (_settleFrames > 0)
+		{
+			--_settleFrames;
+			return _scale;
+		}
+
+		if (_smoothedMs <= 0.f) return _scale;
+		if (_smoothedMs >= _config.targetFrameMs * k_deadBandLow && _smoothedMs <= _config.targetFrameMs * k_deadBandHigh) return _scale;
+
+		float desired = _scale * std::sqrt(_config.targetFrameMs / _smoothedMs);
+		desired = std::clamp(desired, _scale - _config.maxStep, _scale + _config.maxStep);
+		desired = std::clamp(desired, _config.minScale, _config.maxScale);
+		if (desired != _scale)
+		{
+			_scale = desired;
+			_settleFrames = _config.settleFrames;
+		}
+		return _scale;
+	}
+
+	ScaledRenderTarget::ScaledRenderTarget(Gfx::Device& device, wgpu::TextureFormat colorFormat, wgpu::TextureFormat depthFormat)
+		: _pDevice(&device)
+		, _colorFormat(colorFormat)
+		, _depthFormat(depthFormat)
+		, _renderExtents{ 0, 0, 1 }
+		, _scale(1.f)
+	{
+	}
+
+	bool ScaledRenderTarget::Resize(uint32_t width, uint32_t height)
+	{
+		if (_color && _color->Extents().width == width && _color->Extents().height == height) return false;
+
+		//Old ones go first so both sizes are never alive at once
+		_color.reset();
+		_depth.reset();
+		_color.emplace(wgpu::TextureDimension::_2D, wgpu::Extent3D{ width, height, 1 },
+			wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::CopySrc, 4, 1, _colorFormat, *_pDevice, "Scaled Color");
+		_depth.emplace(wgpu::TextureDimension::_2D, wgpu::Extent3D{ width, height, 1 },
+			wgpu::TextureUsage::RenderAttachment, 1, 3/*24 bit depth*/, _depthFormat, *_pDevice, "Scaled Depth");
+
+		SetScale(_scale);
+		return true;
+	}
+
+	void ScaledRenderTarget::SetScale(float scale)
+	{
+		_scale = scale;
+		if (!_color) return;
+
+		wgpu::Extent3D extents = _color->Extents();
+		_renderExtents.width = std::clamp((uint32_t)std::lround(extents.width * scale), 1u, extents.width);
+		_renderExtents.height = std::clamp((uint32_t)std::lround(extents.height * scale), 1u, extents.height);
+	}
+
+	void ScaledRenderTarget::SetViewport(Gfx::RenderEncoder& pass) const
+	{
+		pass.SetViewport(0.f, 0.f, (float)_renderExtents.width, (float)_renderExtents.height);
+	}
+}
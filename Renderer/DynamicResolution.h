@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include "webgpu.h"
+#include "GfxDevice.h"
+#include "Texture.h"
+
+namespace Gfx
+{
+	struct ResolutionControllerConfig
+	{
+		float targetFrameMs = 1000.f / 60.f;
+		float minScale = 0.5f;
+		float maxScale = 1.0f;
+		float maxStep = 0.05f; //Largest scale change per adjustment
+		uint32_t settleFrames = 8; //Frames to wait after a change, gpu timings arrive a few frames late
+	};
+
+	//Picks the render scale that holds a frame time. Pixel cost goes with the square of the scale, so the
+	//scale moves by the square root of the target/measured ratio, with a dead band so it doesn't oscillate
+	class ResolutionController {
+	public:
+		explicit ResolutionController(ResolutionControllerConfig const& config = {});
+
+		//Feed the gpu time of the frame when available, cpu frame time is capped by vsync and can't show headroom
+		float Update(float frameMs);
+
+		inline float Scale() const noexcept { return _scale; }
+
+	private:
+		ResolutionControllerConfig _config;
+		float _scale;
+		float _smoothedMs;
+		uint32_t _settleFrames;
+	};
+
+	//Offscreen color + depth sized for the window, of which only the top left Scale() part is rendered to.
+	//Scale changes only move the viewport, the textures are recreated on resize only
+	class ScaledRenderTarget {
+	public:
+		ScaledRenderTarget(Gfx::Device& device, wgpu::TextureFormat colorFormat, wgpu::TextureFormat depthFormat);
+
+		//Returns true if the textures were recreated, views handed out before are released then
+		bool Resize(uint32_t width, uint32_t height);
+		void SetScale(float scale);
+
+		void SetViewport(Gfx::RenderEncoder& pass) const;
+
+		inline wgpu::TextureView ColorView() const noexcept { return _color->View(); }
+		inline wgpu::Texture ColorTexture() const noexcept { return _color->Get(); }
+		inline wgpu::TextureView DepthView() const noexcept { return _depth->View(); }
+		inline wgpu::Extent3D Extents() const noexcept { return _color->Extents(); }
+		inline wgpu::Extent3D RenderExtents() const noexcept { return _renderExtents; }
+
+	private:
+		//No copy, move
+		ScaledRenderTarget(ScaledRenderTarget const& other) = delete;
+		ScaledRenderTarget(ScaledRenderTarget&& other) = delete;
+		ScaledRenderTarget& operator=(ScaledRenderTarget const& other) = delete;
+		ScaledRenderTarget& operator=(ScaledRenderTarget&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::TextureFormat _colorFormat;
+		wgpu::TextureFormat _depthFormat;
+		std::optional<Gfx::Texture> _color;
+		std::optional<Gfx::Texture> _depth;
+		wgpu::Extent3D _renderExtents;
+		float _scale;
+	};
+}
@@ -0,0 +1,190 @@
+#include "Ecs.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	//Written once per component type before its id is handed out, so readers with an id never race the write
+	std::array<Ecs::Detail::ComponentInfo, Ecs::k_maxComponentTypes> g_componentInfos;
+	std::atomic<uint32_t> g_componentCount = 0;
+
+	constexpr uint32_t AlignUp(uint32_t value, uint32_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+namespace Ecs
+{
+	namespace Detail
+	{
+		uint32_t RegisterComponent(ComponentInfo info)
+		{
+			uint32_t const id = g_componentCount.fetch_add(1);
+			if (id >= k_maxComponentTypes)
+			{
+				std::cout << "More than " << k_maxComponentTypes << " component types\n";
+				std::abort();
+			}
+			g_componentInfos[id] = info;
+			return id;
+		}
+
+		ComponentInfo const& GetComponentInfo(uint32_t componentId)
+		{
+			return g_componentInfos[componentId];
+		}
+	}
+
+	World::Archetype::Archetype(uint64_t componentMask)
+		: mask(componentMask)
+		, capacity(0)
+	{
+		columnOf.fill(-1);
+		uint32_t rowBytes = sizeof(Entity);
+		for (uint32_t id = 0; id < k_maxComponentTypes; ++id)
+		{
+			if ((mask & (1ull << id)) == 0) continue;
+			columnOf[id] = (int32_t)components.size();
+			components.push_back(id);
+			sizes.push_back(Detail::GetComponentInfo(id).size);
+			rowBytes += sizes.back();
+		}
+
+		//Start from the unpadded count and back off until the aligned arrays fit
+		capacity = std::max((uint32_t)(k_chunkBytes / rowBytes), 1u);
+		while (true)
+		{
+			offsets.clear();
+			uint32_t end = capacity * (uint32_t)sizeof(Entity);
+			for (uint32_t id : components)
+			{
+				Detail::ComponentInfo const& info = Detail::GetComponentInfo(id);
+				uint32_t const offset = AlignUp(end, info.alignment);
+				offsets.push_back(offset);
+				end = offset + capacity * info.size;
+			}
+			if (end <= k_chunkBytes || capacity == 1) break;
+			--capacity;
+		}
+	}
+
+	World::Archetype& World::GetArchetype(uint64_t mask, uint32_t* pIndex)
+	{
+		auto [it, added] = _archetypeOfMask.try_emplace(mask, (uint32_t)_archetypes.size());
+		if (added) _archetypes.push_back(std::make_unique<Archetype>(mask));
+		if (pIndex) *pIndex = it->second;
+		return *_archetypes[it->second];
+	}
+
+	Entity World::NewEntity()
+	{
+		Entity entity;
+		if (!_freeIndices.empty())
+		{
+			entity.index = _freeIndices.back();
+			_freeIndices.pop_back();
+		}
+		else
+		{
+			entity.index = (uint32_t)_records.size();
+			_records.emplace_back();
+		}
+		EntityRecord& record = _records[entity.index];
+		record.alive = true;
+		entity.generation = record.generation;
+		++_alive;
+		return entity;
+	}
+
+	void World::AllocateRow(uint32_t archetypeIndex, Entity entity)
+	{
+		Archetype& archetype = *_archetypes[archetypeIndex];
+		if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity)
+		{
+			Chunk& chunk = archetype.chunks.emplace_back();
+			chunk.data = std::make_unique<std::byte[]>(k_chunkBytes);
+		}
+
+		Chunk& chunk = archetype.chunks.back();
+		uint32_t const row = chunk.count++;
+		archetype.Entities(chunk)[row] = entity;
+
+		EntityRecord& record = _records[entity.index];
+		record.archetype = archetypeIndex;
+		record.chunk = (uint32_t)archetype.chunks.size() - 1;
+		record.row = row;
+	}
+
+	void World::RemoveRow(uint32_t archetypeIndex, uint32_t chunkIndex, uint32_t row)
+	{
+		Archetype& archetype = *_archetypes[archetypeIndex];
+		Chunk& chunk = archetype.chunks[chunkIndex];
+		Chunk& last = archetype.chunks.back();
+		uint32_t const lastRow = last.count - 1;
+
+		if (&chunk != &last || row != lastRow)
+		{
+			for (uint32_t column = 0; column < archetype.components.size(); ++column)
+			{
+				std::memcpy(archetype.Component(chunk, column, row), archetype.Component(last, column, lastRow), archetype.sizes[column]);
+			}
+			Entity const moved = archetype.Entities(last)[lastRow];
+			archetype.Entities(chunk)[row] = moved;
+			_records[moved.index].chunk = chunkIndex;
+			_records[moved.index].row = row;
+		}
+
+		//Empty chunks are freed, an archetype only ever has one partly filled chunk
+		if (--last.count == 0) archetype.chunks.pop_back();
+	}
+
+	void World::MoveEntity(Entity entity, uint64_t newMask)
+	{
+		EntityRecord const old = _records[entity.index];
+		uint32_t newIndex = 0;
+		GetArchetype(newMask, &newIndex);
+		AllocateRow(newIndex, entity);
+
+		//GetArchetype can grow _archetypes, so both are looked up after it
+		Archetype const& from = *_archetypes[old.archetype];
+		Archetype const& to = *_archetypes[newIndex];
+		EntityRecord const& moved = _records[entity.index];
+		for (uint32_t column = 0; column < from.components.size(); ++column)
+		{
+			int32_t const toColumn = to.columnOf[from.components[column]];
+			if (toColumn < 0) continue;
+			std::memcpy(to.Component(to.chunks[moved.chunk], (uint32_t)toColumn, moved.row), from.Component(from.chunks[old.chunk], column, old.row),
+				from.sizes[column]);
+		}
+		RemoveRow(old.archetype, old.chunk, old.row);
+	}
+
+	void World::Destroy(Entity entity)
+	{
+		if (!Alive(entity)) return;
+		EntityRecord& record = _records[entity.index];
+		RemoveRow(record.archetype, record.chunk, record.row);
+		record.alive = false;
+		++record.generation;
+		_freeIndices.push_back(entity.index);
+		--_alive;
+	}
+
+	void World::Clear()
+	{
+		//Archetypes and their layouts stay, only the entities go
+		for (std::unique_ptr<Archetype>& pArchetype : _archetypes) pArchetype->chunks.clear();
+		_records.clear();
+		_freeIndices.clear();
+		_alive = 0;
+	}
+
+	bool World::Alive(Entity entity) const noexcept
+	{
+		return entity.index < _records.size() && _records[entity.index].alive && _records[entity.index].generation == entity.generation;
+	}
+}
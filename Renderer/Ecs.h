@@ -0,0 +1,297 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "JobSystem.h"
+
+//Archetype entity component store. Entities with the same set of components share an archetype, whose entities live in
+//fixed size chunks with one tightly packed array per component (structure of arrays). Queries walk the chunks of every
+//archetype that has the asked for components and get plain spans, which can be memcpy'd straight into gpu buffers
+namespace Ecs
+{
+	constexpr size_t k_chunkBytes = 16 * 1024; //Fits in L1 along with what's being written
+	constexpr uint32_t k_maxComponentTypes = 64;
+
+	struct Entity
+	{
+		uint32_t index = ~0u;
+		uint32_t generation = 0; //Bumped when the index is reused so stale handles are caught
+
+		inline bool operator==(Entity const& other) const noexcept = default;
+	};
+
+	namespace Detail
+	{
+		struct ComponentInfo
+		{
+			uint32_t size;
+			uint32_t alignment;
+		};
+
+		uint32_t RegisterComponent(ComponentInfo info);
+		ComponentInfo const& GetComponentInfo(uint32_t componentId);
+	}
+
+	//Components are plain data, they're moved between chunks with memcpy and never destroyed
+	template<typename T>
+	uint32_t ComponentId()
+	{
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "Components have to be plain data");
+		static_assert(alignof(T) <= alignof(std::max_align_t), "Component alignment is more than chunks give");
+		static uint32_t const id = Detail::RegisterComponent({ (uint32_t)sizeof(T), (uint32_t)alignof(T) });
+		return id;
+	}
+
+	template<typename... Ts>
+	uint64_t ComponentMask()
+	{
+		return (0ull | ... | (1ull << ComponentId<std::remove_const_t<Ts>>()));
+	}
+
+	class World {
+	public:
+		World() = default;
+
+		//Indices of freed entities are reused, after Clear they're handed out from 0 again in creation order
+		template<typename... Ts>
+		Entity Create(Ts const&... components);
+		//count entities with default constructed components, usually filled in afterwards with a query
+		template<typename... Ts>
+		void CreateMany(uint32_t count);
+		void Destroy(Entity entity);
+		void Clear();
+
+		bool Alive(Entity entity) const noexcept;
+		//nullptr if the entity doesn't have a T. Only valid until the next structural change
+		template<typename T>
+		T* Get(Entity entity) noexcept;
+
+		//Structural changes, the entity moves to the archetype with the new component set
+		template<typename T>
+		void Add(Entity entity, T const& component);
+		template<typename T>
+		void Remove(Entity entity);
+
+		inline uint32_t Count() const noexcept { return _alive; }
+		//Entities that have all of Ts
+		template<typename... Ts>
+		uint32_t Count() const;
+
+		//fn(std::span<Entity const>, std::span<Ts>...) once per non empty chunk whose archetype has all of Ts, in archetype
+		//then creation order (until entities are destroyed). Ts can be const. No structural changes from inside fn
+		template<typename... Ts, typename Fn>
+		void ForEachChunk(Fn&& fn);
+		template<typename... Ts, typename Fn>
+		void ForEachChunk(Fn&& fn) const;
+		//Same with the chunks spread over the job system, fn has to be safe to call concurrently
+		template<typename... Ts, typename Fn>
+		void ParallelForEachChunk(Jobs::JobSystem& jobs, Fn&& fn);
+
+		//Copies the T of every entity that has one into out, in ForEachChunk order
+		template<typename T>
+		void Gather(std::vector<T>& out) const;
+
+	private:
+		//No copy, move
+		World(World const& other) = delete;
+		World(World&& other) = delete;
+		World& operator=(World const& other) = delete;
+		World& operator=(World&& other) = delete;
+
+		struct Chunk
+		{
+			std::unique_ptr<std::byte[]> data;
+			uint32_t count = 0;
+		};
+
+		struct Archetype
+		{
+			explicit Archetype(uint64_t componentMask);
+
+			template<typename T>
+			inline std::span<T> Column(Chunk const& chunk) const noexcept
+			{
+				using Component = std::remove_const_t<T>;
+				int32_t const column = columnOf[ComponentId<Component>()];
+				assert(column >= 0);
+				return std::span<T>(reinterpret_cast<Component*>(chunk.data.get() + offsets[column]), chunk.count);
+			}
+			inline std::span<Entity> Entities(Chunk const& chunk) const noexcept
+			{
+				return std::span<Entity>(reinterpret_cast<Entity*>(chunk.data.get()), chunk.count);
+			}
+			inline std::byte* Component(Chunk const& chunk, uint32_t column, uint32_t row) const noexcept
+			{
+				return chunk.data.get() + offsets[column] + (size_t)row * sizes[column];
+			}
+
+			uint64_t mask;
+			std::vector<uint32_t> components;
+			std::vector<uint32_t> offsets; //Start of each component array in a chunk, same order as components
+			std::vector<uint32_t> sizes;
+			std::array<int32_t, k_maxComponentTypes> columnOf; //Component id to index in components, -1 if absent
+			uint32_t capacity; //Entities per chunk
+			std::vector<Chunk> chunks; //All full except the last
+		};
+
+		struct EntityRecord
+		{
+			uint32_t generation = 0;
+			uint32_t archetype = 0;
+			uint32_t chunk = 0;
+			uint32_t row = 0;
+			bool alive = false;
+		};
+
+		Archetype& GetArchetype(uint64_t mask, uint32_t* pIndex = nullptr);
+		//Reserves a row at the end of the archetype and points the entity's record at it
+		void AllocateRow(uint32_t archetypeIndex, Entity entity);
+		//Fills the hole with the archetype's last entity
+		void RemoveRow(uint32_t archetypeIndex, uint32_t chunkIndex, uint32_t row);
+		//Takes the components both archetypes share along
+		void MoveEntity(Entity entity, uint64_t newMask);
+		Entity NewEntity();
+
+		template<typename T>
+		void Write(Entity entity, T const& component) noexcept;
+
+		std::vector<std::unique_ptr<Archetype>> _archetypes;
+		std::unordered_map<uint64_t, uint32_t> _archetypeOfMask;
+		std::vector<EntityRecord> _records;
+		std::vector<uint32_t> _freeIndices;
+		uint32_t _alive = 0;
+	};
+
+	template<typename... Ts>
+	Entity World::Create(Ts const&... components)
+	{
+		uint32_t archetypeIndex = 0;
+		GetArchetype(ComponentMask<Ts...>(), &archetypeIndex);
+		Entity const entity = NewEntity();
+		AllocateRow(archetypeIndex, entity);
+		(Write(entity, components), ...);
+		return entity;
+	}
+
+	template<typename... Ts>
+	void World::CreateMany(uint32_t count)
+	{
+		uint32_t archetypeIndex = 0;
+		GetArchetype(ComponentMask<Ts...>(), &archetypeIndex);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Entity const entity = NewEntity();
+			AllocateRow(archetypeIndex, entity);
+			(Write(entity, Ts{}), ...);
+		}
+	}
+
+	template<typename T>
+	void World::Write(Entity entity, T const& component) noexcept
+	{
+		EntityRecord const& record = _records[entity.index];
+		Archetype const& archetype = *_archetypes[record.archetype];
+		archetype.Column<T>(archetype.chunks[record.chunk])[record.row] = component;
+	}
+
+	template<typename T>
+	T* World::Get(Entity entity) noexcept
+	{
+		if (!Alive(entity)) return nullptr;
+		EntityRecord const& record = _records[entity.index];
+		Archetype const& archetype = *_archetypes[record.archetype];
+		if (archetype.columnOf[ComponentId<T>()] < 0) return nullptr;
+		return &archetype.Column<T>(archetype.chunks[record.chunk])[record.row];
+	}
+
+	template<typename T>
+	void World::Add(Entity entity, T const& component)
+	{
+		assert(Alive(entity));
+		uint64_t const mask = _archetypes[_records[entity.index].archetype]->mask;
+		if ((mask & ComponentMask<T>()) == 0) MoveEntity(entity, mask | ComponentMask<T>());
+		Write(entity, component);
+	}
+
+	template<typename T>
+	void World::Remove(Entity entity)
+	{
+		assert(Alive(entity));
+		uint64_t const mask = _archetypes[_records[entity.index].archetype]->mask;
+		if (mask & ComponentMask<T>()) MoveEntity(entity, mask & ~ComponentMask<T>());
+	}
+
+	template<typename... Ts>
+	uint32_t World::Count() const
+	{
+		uint64_t const mask = ComponentMask<Ts...>();
+		uint32_t count = 0;
+		for (std::unique_ptr<Archetype> const& pArchetype : _archetypes)
+		{
+			if ((pArchetype->mask & mask) != mask) continue;
+			for (Chunk const& chunk : pArchetype->chunks) count += chunk.count;
+		}
+		return count;
+	}
+
+	template<typename... Ts, typename Fn>
+	void World::ForEachChunk(Fn&& fn)
+	{
+		uint64_t const mask = ComponentMask<Ts...>();
+		for (std::unique_ptr<Archetype> const& pArchetype : _archetypes)
+		{
+			if ((pArchetype->mask & mask) != mask) continue;
+			for (Chunk const& chunk : pArchetype->chunks)
+			{
+				if (chunk.count > 0) fn(std::span<Entity const>(pArchetype->Entities(chunk)), pArchetype->template Column<Ts>(chunk)...);
+			}
+		}
+	}
+
+	template<typename... Ts, typename Fn>
+	void World::ForEachChunk(Fn&& fn) const
+	{
+		static_assert((std::is_const_v<Ts> && ...), "Components of a const World are const");
+		const_cast<World*>(this)->ForEachChunk<Ts...>(std::forward<Fn>(fn));
+	}
+
+	template<typename... Ts, typename Fn>
+	void World::ParallelForEachChunk(Jobs::JobSystem& jobs, Fn&& fn)
+	{
+		uint64_t const mask = ComponentMask<Ts...>();
+		std::vector<std::pair<Archetype const*, Chunk const*>> chunks;
+		for (std::unique_ptr<Archetype> const& pArchetype : _archetypes)
+		{
+			if ((pArchetype->mask & mask) != mask) continue;
+			for (Chunk const& chunk : pArchetype->chunks)
+			{
+				if (chunk.count > 0) chunks.emplace_back(pArchetype.get(), &chunk);
+			}
+		}
+
+		jobs.ParallelFor((uint32_t)chunks.size(), 1, [&chunks, &fn](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				auto [pArchetype, pChunk] = chunks[i];
+				fn(std::span<Entity const>(pArchetype->Entities(*pChunk)), pArchetype->template Column<Ts>(*pChunk)...);
+			}
+		});
+	}
+
+	template<typename T>
+	void World::Gather(std::vector<T>& out) const
+	{
+		out.clear();
+		out.reserve(Count<T>());
+		ForEachChunk<T const>([&out](std::span<Entity const>, std::span<T const> components) {
+			out.insert(out.end(), components.begin(), components.end());
+		});
+	}
+}
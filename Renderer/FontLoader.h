@@ -0,0 +1,27 @@
+#pragma once
+//Only the font baking part of nuklear is used, it embeds stb_truetype and stb_rect_pack
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#pragma GCC diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#elif WIN32
+#pragma warning( push )
+#pragma warning( disable : 4505 4100 4244 4701 4996 )
+#endif
+
+#include <glfw/deps/nuklear.h>
+
+#ifdef WIN32
+#pragma warning( pop )
+#elif __GNUC__
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,124 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define RENDERER_ARENA_ASAN
+#endif
+#elif defined(__SANITIZE_ADDRESS__)
+#define RENDERER_ARENA_ASAN
+#endif
+
+#ifdef RENDERER_ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace
+{
+	//Under asan memory that isn't handed out is poisoned so reads of recycled scratch are reported.
+	//RENDERER_ARENA_POISON (debug builds) also overwrites it so stale reads show up as 0xDD garbage
+	void PoisonRegion([[maybe_unused]] std::byte* p, [[maybe_unused]] size_t bytes)
+	{
+		if (bytes == 0) return;
+#ifdef RENDERER_ARENA_POISON
+		std::memset(p, Memory::k_arenaPoisonByte, bytes);
+#endif
+#ifdef RENDERER_ARENA_ASAN
+		ASAN_POISON_MEMORY_REGION(p, bytes);
+#endif
+	}
+
+	void UnpoisonRegion([[maybe_unused]] std::byte* p, [[maybe_unused]] size_t bytes)
+	{
+#ifdef RENDERER_ARENA_ASAN
+		ASAN_UNPOISON_MEMORY_REGION(p, bytes);
+#endif
+	}
+}
+
+namespace Memory
+{
+	LinearArena::LinearArena(size_t capacity, std::pmr::memory_resource* pUpstream)
+		: _pUpstream(pUpstream)
+		, _pBlock(nullptr)
+		, _capacity(capacity)
+		, _offset(0)
+	{
+		assert(_pUpstream);
+		if (_capacity > 0)
+		{
+			_pBlock = (std::byte*)_pUpstream->allocate(_capacity, alignof(std::max_align_t));
+			PoisonRegion(_pBlock, _capacity);
+		}
+	}
+
+	LinearArena::~LinearArena()
+	{
+		Reset();
+		if (_pBlock)
+		{
+			UnpoisonRegion(_pBlock, _capacity);
+			_pUpstream->deallocate(_pBlock, _capacity, alignof(std::max_align_t));
+		}
+	}
+
+	void LinearArena::Reset()
+	{
+		PoisonRegion(_pBlock, _offset);
+		_offset = 0;
+
+		for (Overflow const& overflow : _overflow) _pUpstream->deallocate(overflow.p, overflow.bytes, overflow.alignment);
+		_overflow.clear();
+
+		_stats.used = 0;
+		_stats.overflowBytes = 0;
+		_stats.overflowAllocations = 0;
+	}
+
+	void* LinearArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		//Aligned by address so alignments past the block's own still work
+		uintptr_t const base = (uintptr_t)_pBlock;
+		uintptr_t const aligned = (base + _offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		size_t const begin = aligned - base;
+		if (_pBlock && begin <= _capacity && bytes <= _capacity - begin)
+		{
+			std::byte* p = _pBlock + begin;
+			UnpoisonRegion(p, bytes);
+			_offset = begin + bytes;
+			_stats.used = _offset;
+			_stats.highWater = std::max(_stats.highWater, _offset);
+			return p;
+		}
+
+		void* p = _pUpstream->allocate(bytes, alignment);
+		_overflow.push_back({ p, bytes, alignment });
+		_stats.overflowBytes += bytes;
+		++_stats.overflowAllocations;
+		return p;
+	}
+
+	void LinearArena::do_deallocate(void*, size_t, size_t)
+	{
+		//Released all at once by Reset
+	}
+
+	bool LinearArena::do_is_equal(std::pmr::memory_resource const& other) const noexcept
+	{
+		return this == &other;
+	}
+
+	FrameArena::FrameArena(size_t capacityPerFrame, std::pmr::memory_resource* pUpstream)
+		: _arenas{ LinearArena(capacityPerFrame, pUpstream), LinearArena(capacityPerFrame, pUpstream) }
+		, _current(0)
+	{
+	}
+
+	void FrameArena::NextFrame()
+	{
+		_current ^= 1;
+		_arenas[_current].Reset();
+	}
+}
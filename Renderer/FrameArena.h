@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Memory
+{
+	constexpr size_t k_defaultArenaBytes = 1024 * 1024;
+	constexpr uint8_t k_arenaPoisonByte = 0xDD; //Written over recycled memory when RENDERER_ARENA_POISON is defined
+
+	struct ArenaStats
+	{
+		size_t used = 0; //Bytes bumped since the last reset, including alignment padding
+		size_t highWater = 0; //Most used between two resets
+		size_t overflowBytes = 0; //Went to the upstream resource since the last reset
+		uint32_t overflowAllocations = 0;
+	};
+
+	//Bump allocator over one fixed block, deallocate is a no-op and everything is released together by Reset.
+	//Requests that don't fit go to the upstream resource and are freed on Reset, so a full arena is slower instead of failing.
+	//Not thread safe, hand workers memory allocated up front
+	class LinearArena : public std::pmr::memory_resource {
+	public:
+		explicit LinearArena(size_t capacity = k_defaultArenaBytes, std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource());
+		~LinearArena() override;
+
+		//Everything allocated so far is invalid after this
+		void Reset();
+
+		inline size_t Capacity() const noexcept { return _capacity; }
+		inline ArenaStats const& Stats() const noexcept { return _stats; }
+
+	private:
+		//No copy, move
+		LinearArena(LinearArena const& other) = delete;
+		LinearArena(LinearArena&& other) = delete;
+		LinearArena& operator=(LinearArena const& other) = delete;
+		LinearArena& operator=(LinearArena&& other) = delete;
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override;
+
+		struct Overflow
+		{
+			void* p;
+			size_t bytes;
+			size_t alignment;
+		};
+
+		std::pmr::memory_resource* _pUpstream;
+		std::byte* _pBlock;
+		size_t _capacity;
+		size_t _offset;
+		std::vector<Overflow> _overflow;
+		ArenaStats _stats;
+	};
+
+	//Two arenas swapped every frame. Memory from Resource() stays valid through the next frame, so scratch handed to
+	//something that finishes a frame late (e.g. a callback fired from the next Poll) doesn't need copying out
+	class FrameArena {
+	public:
+		explicit FrameArena(size_t capacityPerFrame = k_defaultArenaBytes, std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource());
+
+		//Call once at the start of a frame, recycles the arena used two frames ago
+		void NextFrame();
+
+		inline std::pmr::memory_resource* Resource() noexcept { return &_arenas[_current]; }
+		inline LinearArena const& Current() const noexcept { return _arenas[_current]; }
+		inline LinearArena const& Previous() const noexcept { return _arenas[_current ^ 1]; }
+
+	private:
+		//No copy, move
+		FrameArena(FrameArena const& other) = delete;
+		FrameArena(FrameArena&& other) = delete;
+		FrameArena& operator=(FrameArena const& other) = delete;
+		FrameArena& operator=(FrameArena&& other) = delete;
+
+		std::array<LinearArena, 2> _arenas;
+		uint32_t _current;
+	};
+}
@@ -0,0 +1,215 @@
+#include "FrameCapture.h"
+#include <cstdio>
+#include <iostream>
+#include "Profiler.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#elif WIN32
+#pragma warning( push )
+#pragma warning( disable : 4505 )          // 4505: unreferenced function with internal linkage has been removed
+#endif
+
+#include <glfw/deps/stb_image_write.h>
+#ifdef WIN32
+#pragma warning( pop )
+#elif __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+	constexpr uint32_t k_bytesPerPixel = 4;
+
+	std::optional<bool> IsBgra(wgpu::TextureFormat format)
+	{
+		switch (format)
+		{
+		case wgpu::TextureFormat::RGBA8Unorm:
+		case wgpu::TextureFormat::RGBA8UnormSrgb:
+			return false;
+		case wgpu::TextureFormat::BGRA8Unorm:
+		case wgpu::TextureFormat::BGRA8UnormSrgb:
+			return true;
+		default:
+			return std::nullopt;
+		}
+	}
+}
+
+namespace Gfx
+{
+	FrameCapture::FrameCapture(Gfx::ReadbackRing& readbacks, uint32_t workerCount, uint32_t maxPending)
+		: _pReadbacks(&readbacks)
+		, _state(std::make_shared<SharedState>())
+		, _maxPending(std::max(maxPending, 1u))
+		, _sequenceFrame(0)
+		, _sequenceRemaining(0)
+		, _requested(0)
+		, _dropped(0)
+	{
+		for (uint32_t i = 0; i < std::max(workerCount, 1u); ++i) _workers.emplace_back(WorkerLoop, _state);
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		{
+			std::lock_guard lock(_state->mutex);
+			_state->stopping = true;
+		}
+		_state->wake.notify_all();
+		for (std::thread& worker : _workers) worker.join();
+	}
+
+	void FrameCapture::Screenshot(std::filesystem::path const& path)
+	{
+		_screenshotPath = path;
+	}
+
+	void FrameCapture::StartSequence(std::filesystem::path const& directory, uint32_t frameCount)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error)
+		{
+			std::cout << "Failed to create capture directory: " << directory << " (" << error.message() << ")\n";
+			return;
+		}
+		_sequenceDirectory = directory;
+		_sequenceFrame = 0;
+		_sequenceRemaining = frameCount;
+	}
+
+	void FrameCapture::Capture(wgpu::CommandEncoder commands, wgpu::Texture texture, wgpu::TextureFormat format, wgpu::Extent3D size)
+	{
+		if (!Capturing()) return;
+		PROFILE_FUNCTION();
+
+		//Both can be due on the same frame, the screenshot goes first and the sequence frame is dropped
+		std::filesystem::path path;
+		if (_screenshotPath)
+		{
+			path = std::move(*_screenshotPath);
+			_screenshotPath.reset();
+		}
+		else
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "frame_%05u.png", _sequenceFrame);
+			path = _sequenceDirectory / name;
+		}
+		if (_sequenceRemaining > 0)
+		{
+			++_sequenceFrame;
+			--_sequenceRemaining;
+		}
+		++_requested;
+
+		std::optional<bool> bgra = IsBgra(format);
+		if (!bgra)
+		{
+			std::cout << "Can't capture texture format " << (uint32_t)format << "\n";
+			++_dropped;
+			return;
+		}
+
+		{
+			std::lock_guard lock(_state->mutex);
+			if (_state->reading + _state->jobs.size() >= _maxPending)
+			{
+				++_dropped;
+				return;
+			}
+			++_state->reading;
+		}
+
+		size.depthOrArrayLayers = 1;
+		auto onReady = [state = _state, path, width = size.width, height = size.height, bgra = *bgra](Gfx::ReadbackData const& data) {
+			//Runs from Device::Poll on the render thread, so this only copies the rows out and leaves the rest to a worker
+			EncodeJob job;
+			if (!data.bytes.empty())
+			{
+				job.path = path;
+				job.width = width;
+				job.height = height;
+				job.bytesPerRow = data.bytesPerRow;
+				job.bgra = bgra;
+				job.pixels.assign(data.bytes.begin(), data.bytes.end());
+			}
+
+			{
+				std::lock_guard lock(state->mutex);
+				--state->reading;
+				if (data.bytes.empty())
+				{
+					++state->failed;
+					return;
+				}
+				state->jobs.push_back(std::move(job));
+			}
+			state->wake.notify_one();
+		};
+
+		if (!_pReadbacks->ReadTexture(commands, texture, k_bytesPerPixel, { 0, 0, 0 }, size, std::move(onReady)))
+		{
+			std::lock_guard lock(_state->mutex);
+			--_state->reading;
+			++_dropped;
+		}
+	}
+
+	CaptureStats FrameCapture::Stats() const
+	{
+		CaptureStats stats;
+		stats.requested = _requested;
+		stats.dropped = _dropped;
+		stats.written = _state->written;
+		stats.failed = _state->failed;
+		return stats;
+	}
+
+	void FrameCapture::WorkerLoop(std::shared_ptr<SharedState> state)
+	{
+		while (true)
+		{
+			EncodeJob job;
+			{
+				std::unique_lock lock(state->mutex);
+				state->wake.wait(lock, [&state] { return state->stopping || !state->jobs.empty(); });
+				//Queued frames are still written when stopping
+				if (state->jobs.empty()) return;
+				job = std::move(state->jobs.front());
+				state->jobs.pop_front();
+			}
+
+			if (WritePng(job)) ++state->written;
+			else ++state->failed;
+		}
+	}
+
+	bool FrameCapture::WritePng(EncodeJob& job)
+	{
+		//Swap chain alpha is whatever blending left there, pngs are written opaque
+		for (uint32_t y = 0; y < job.height; ++y)
+		{
+			std::byte* pRow = job.pixels.data() + (size_t)y * job.bytesPerRow;
+			for (uint32_t x = 0; x < job.width; ++x)
+			{
+				std::byte* pPixel = pRow + (size_t)x * k_bytesPerPixel;
+				if (job.bgra) std::swap(pPixel[0], pPixel[2]);
+				pPixel[3] = std::byte{ 0xff };
+			}
+		}
+
+		//Rows keep the 256 byte readback padding, stb takes the stride
+		std::string const path = job.path.string();
+		if (stbi_write_png(path.c_str(), (int)job.width, (int)job.height, k_bytesPerPixel, job.pixels.data(), (int)job.bytesPerRow) == 0)
+		{
+			std::cout << "Failed to write capture: " << path << "\n";
+			return false;
+		}
+		return true;
+	}
+}
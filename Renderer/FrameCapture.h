@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "webgpu.h"
+#include "ReadbackRing.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_captureWorkers = 2;
+	constexpr uint32_t k_maxPendingCaptures = 8; //Frames being read back or waiting for a worker
+
+	struct CaptureStats
+	{
+		uint32_t requested = 0;
+		uint32_t written = 0;
+		uint32_t dropped = 0; //Too many captures pending, or no readback slot
+		uint32_t failed = 0; //Readback or png write failed
+	};
+
+	//Writes frames to png without waiting on the gpu or the encoder. Pixels come back through the ReadbackRing and are
+	//encoded on worker threads. When more than maxPending frames are outstanding new ones are dropped instead of stalling.
+	//Only 8 bit RGBA/BGRA color targets can be captured
+	class FrameCapture {
+	public:
+		FrameCapture(Gfx::ReadbackRing& readbacks, uint32_t workerCount = k_captureWorkers, uint32_t maxPending = k_maxPendingCaptures);
+		//Finishes writing the frames already queued, frames still being read back are dropped
+		~FrameCapture();
+
+		//Taken by the next Capture
+		void Screenshot(std::filesystem::path const& path);
+		//The next frameCount Captures are written to directory/frame_00000.png onwards. A dropped frame leaves a gap in the numbering
+		void StartSequence(std::filesystem::path const& directory, uint32_t frameCount);
+
+		//Call once a frame after the texture is rendered, in the same commands. Does nothing unless a capture is pending.
+		//The texture needs CopySrc usage, only the top left size texels are captured
+		void Capture(wgpu::CommandEncoder commands, wgpu::Texture texture, wgpu::TextureFormat format, wgpu::Extent3D size);
+
+		inline bool Capturing() const noexcept { return _screenshotPath.has_value() || _sequenceRemaining > 0; }
+		CaptureStats Stats() const;
+
+	private:
+		//No copy, move
+		FrameCapture(FrameCapture const& other) = delete;
+		FrameCapture(FrameCapture&& other) = delete;
+		FrameCapture& operator=(FrameCapture const& other) = delete;
+		FrameCapture& operator=(FrameCapture&& other) = delete;
+
+		struct EncodeJob
+		{
+			std::filesystem::path path;
+			uint32_t width;
+			uint32_t height;
+			uint32_t bytesPerRow;
+			bool bgra;
+			std::vector<std::byte> pixels;
+		};
+
+		//Shared with the readback callbacks and the workers
+		struct SharedState
+		{
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::deque<EncodeJob> jobs;
+			uint32_t reading = 0; //Captures waiting on their readback
+			bool stopping = false;
+
+			std::atomic<uint32_t> written = 0;
+			std::atomic<uint32_t> failed = 0;
+		};
+
+		static void WorkerLoop(std::shared_ptr<SharedState> state);
+		static bool WritePng(EncodeJob& job);
+
+		Gfx::ReadbackRing* _pReadbacks;
+		std::shared_ptr<SharedState> _state;
+		std::vector<std::thread> _workers;
+		uint32_t _maxPending;
+
+		std::optional<std::filesystem::path> _screenshotPath;
+		std::filesystem::path _sequenceDirectory;
+		uint32_t _sequenceFrame;
+		uint32_t _sequenceRemaining;
+
+		uint32_t _requested;
+		uint32_t _dropped;
+	};
+}
@@ -0,0 +1,200 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	constexpr float k_msInSecond = 1000.f;
+	constexpr float k_usInSecond = 1'000'000.f;
+	constexpr float k_usInMs = 1000.f;
+
+	std::ofstream OpenStatsFile(std::filesystem::path const& path)
+	{
+		std::ofstream out(path, std::ios::trunc);
+		if (!out) std::cout << "Failed to open frame stats file " << path << "\n";
+		return out;
+	}
+}
+
+uint32_t FrameHistogram::BucketIndex(uint32_t microseconds) noexcept
+{
+	uint32_t magnitude = (uint32_t)std::max(0, (int)std::bit_width(microseconds) - (int)k_subBucketBits);
+	uint32_t index = magnitude * k_subBucketHalf + (microseconds >> magnitude);
+	return std::min(index, k_bucketCount - 1);
+}
+
+uint32_t FrameHistogram::BucketUpperBound(uint32_t index) noexcept
+{
+	uint32_t magnitude = index < k_subBucketCount ? 0 : (index - k_subBucketHalf) / k_subBucketHalf;
+	uint32_t subBucket = index - magnitude * k_subBucketHalf;
+	return ((subBucket + 1) << magnitude) - 1;
+}
+
+void FrameHistogram::Add(uint32_t microseconds) noexcept
+{
+	++_buckets[BucketIndex(microseconds)];
+	++_count;
+}
+
+void FrameHistogram::Clear() noexcept
+{
+	_buckets.fill(0);
+	_count = 0;
+}
+
+uint32_t FrameHistogram::Percentile(float percentile) const noexcept
+{
+	if (_count == 0) return 0;
+
+	uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil((double)percentile * (double)_count));
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < k_bucketCount; ++i)
+	{
+		seen += _buckets[i];
+		if (seen >= target) return BucketUpperBound(i);
+	}
+	return BucketUpperBound(k_bucketCount - 1);
+}
+
+void FrameStats::Accumulator::Add(float seconds, std::vector<float> const& thresholdsMs)
+{
+	histogram.Add((uint32_t)std::min(seconds * k_usInSecond, (float)UINT32_MAX));
+	sumSeconds += seconds;
+	maxSeconds = std::max(maxSeconds, seconds);
+	for (size_t i = 0; i < thresholdsMs.size(); ++i)
+	{
+		if (seconds * k_msInSecond > thresholdsMs[i]) ++hitches[i];
+	}
+}
+
+void FrameStats::Accumulator::Clear(double start)
+{
+	histogram.Clear();
+	startSeconds = start;
+	sumSeconds = 0.0;
+	maxSeconds = 0.f;
+	hitches.fill(0);
+}
+
+FrameWindowStats FrameStats::Accumulator::Summarize() const
+{
+	FrameWindowStats stats;
+	stats.startSeconds = startSeconds;
+	stats.frames = (uint32_t)histogram.Count();
+	if (stats.frames == 0) return stats;
+
+	//Bucket bounds can overshoot the real max, which is tracked exactly
+	float const maxMs = maxSeconds * k_msInSecond;
+	stats.meanMs = (float)(sumSeconds / stats.frames) * k_msInSecond;
+	stats.p50Ms = std::min(maxMs, histogram.Percentile(0.50f) / k_usInMs);
+	stats.p95Ms = std::min(maxMs, histogram.Percentile(0.95f) / k_usInMs);
+	stats.p99Ms = std::min(maxMs, histogram.Percentile(0.99f) / k_usInMs);
+	stats.maxMs = maxMs;
+	stats.hitches = hitches;
+	return stats;
+}
+
+FrameStats::FrameStats(FrameStatsConfig const& config)
+	: _thresholdsMs(config.hitchThresholdsMs)
+	, _elapsedSeconds(0.0)
+	, _windowSeconds(config.windowSeconds)
+	, _frameCount(0)
+{
+	if (_thresholdsMs.size() > k_maxHitchThresholds)
+	{
+		std::cout << "FrameStats only tracks " << k_maxHitchThresholds << " hitch thresholds, ignoring the rest\n";
+		_thresholdsMs.resize(k_maxHitchThresholds);
+	}
+}
+
+void FrameStats::AddFrame(float seconds)
+{
+	_history[_frameCount % k_frameHistoryLength] = seconds;
+	++_frameCount;
+
+	_window.Add(seconds, _thresholdsMs);
+	_total.Add(seconds, _thresholdsMs);
+	_elapsedSeconds += seconds;
+
+	if (_elapsedSeconds - _window.startSeconds >= _windowSeconds)
+	{
+		_windows.push_back(_window.Summarize());
+		_window.Clear(_elapsedSeconds);
+	}
+}
+
+FrameWindowStats FrameStats::Total() const
+{
+	return _total.Summarize();
+}
+
+bool FrameStats::Write(std::filesystem::path const& path) const
+{
+	return path.extension() == ".json" ? WriteJson(path) : WriteCsv(path);
+}
+
+bool FrameStats::WriteCsv(std::filesystem::path const& path) const
+{
+	std::ofstream out = OpenStatsFile(path);
+	if (!out) return false;
+
+	out << "window,startSeconds,frames,meanMs,p50Ms,p95Ms,p99Ms,maxMs";
+	for (float threshold : _thresholdsMs) out << ",hitchesOver" << threshold << "ms";
+	out << "\n";
+
+	auto writeRow = [&](char const* name, FrameWindowStats const& stats)
+	{
+		out << name << "," << stats.startSeconds << "," << stats.frames << "," << stats.meanMs << "," << stats.p50Ms
+			<< "," << stats.p95Ms << "," << stats.p99Ms << "," << stats.maxMs;
+		for (size_t i = 0; i < _thresholdsMs.size(); ++i) out << "," << stats.hitches[i];
+		out << "\n";
+	};
+
+	for (size_t i = 0; i < _windows.size(); ++i) writeRow(std::to_string(i).c_str(), _windows[i]);
+	writeRow("total", Total());
+
+	std::cout << "Wrote frame stats to " << path << "\n";
+	return (bool)out;
+}
+
+bool FrameStats::WriteJson(std::filesystem::path const& path) const
+{
+	std::ofstream out = OpenStatsFile(path);
+	if (!out) return false;
+
+	auto writeWindow = [&](FrameWindowStats const& stats)
+	{
+		out << "{\"startSeconds\":" << stats.startSeconds << ",\"frames\":" << stats.frames << ",\"meanMs\":" << stats.meanMs
+			<< ",\"p50Ms\":" << stats.p50Ms << ",\"p95Ms\":" << stats.p95Ms << ",\"p99Ms\":" << stats.p99Ms
+			<< ",\"maxMs\":" << stats.maxMs << ",\"hitches\":[";
+		for (size_t i = 0; i < _thresholdsMs.size(); ++i) out << (i ? "," : "") << stats.hitches[i];
+		out << "]}";
+	};
+
+	out << "{\n\"hitchThresholdsMs\":[";
+	for (size_t i = 0; i < _thresholdsMs.size(); ++i) out << (i ? "," : "") << _thresholdsMs[i];
+	out << "],\n\"total\":";
+	writeWindow(Total());
+	out << ",\n\"windows\":[\n";
+	for (size_t i = 0; i < _windows.size(); ++i)
+	{
+		if (i) out << ",\n";
+		writeWindow(_windows[i]);
+	}
+
+	//Raw recent frames, oldest first
+	out << "\n],\n\"recentFramesMs\":[";
+	uint32_t historyCount = (uint32_t)std::min<uint64_t>(_frameCount, k_frameHistoryLength);
+	for (uint32_t i = 0; i < historyCount; ++i)
+	{
+		out << (i ? "," : "") << _history[(HistoryStart() + i) % k_frameHistoryLength] * k_msInSecond;
+	}
+	out << "]\n}\n";
+
+	std::cout << "Wrote frame stats to " << path << "\n";
+	return (bool)out;
+}
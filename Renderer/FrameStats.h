@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+constexpr uint32_t k_frameHistoryLength = 1024;
+constexpr uint32_t k_maxHitchThresholds = 4;
+
+//Log bucketed like HdrHistogram: values in microseconds, linear sub buckets inside each power of two
+//so every bucket is within ~6% of the values it holds. Frames over ~2 minutes land in the last bucket
+class FrameHistogram {
+public:
+	static constexpr uint32_t k_subBucketBits = 5;
+	static constexpr uint32_t k_subBucketCount = 1u << k_subBucketBits;
+	static constexpr uint32_t k_subBucketHalf = k_subBucketCount / 2;
+	static constexpr uint32_t k_bucketCount = 384;
+
+	void Add(uint32_t microseconds) noexcept;
+	void Clear() noexcept;
+
+	//Highest value that falls in the bucket holding the percentile, percentile in [0, 1]
+	uint32_t Percentile(float percentile) const noexcept;
+
+	inline uint64_t Count() const noexcept { return _count; }
+
+	static uint32_t BucketIndex(uint32_t microseconds) noexcept;
+	static uint32_t BucketUpperBound(uint32_t index) noexcept;
+
+private:
+	std::array<uint32_t, k_bucketCount> _buckets{};
+	uint64_t _count = 0;
+};
+
+struct FrameStatsConfig
+{
+	float windowSeconds = 1.0f;
+	//Frames longer than these count as hitches, at most k_maxHitchThresholds are used
+	std::vector<float> hitchThresholdsMs = { 33.3f, 50.0f, 100.0f };
+};
+
+struct FrameWindowStats
+{
+	double startSeconds = 0.0; //Since the first frame
+	uint32_t frames = 0;
+	float meanMs = 0.f;
+	float p50Ms = 0.f;
+	float p95Ms = 0.f;
+	float p99Ms = 0.f;
+	float maxMs = 0.f;
+	std::array<uint32_t, k_maxHitchThresholds> hitches{};
+};
+
+//Frame time history, per window percentiles and hitch counts. Frames are grouped into windows of
+//config.windowSeconds, the whole run is also summarised in one window starting at 0.
+class FrameStats {
+public:
+	explicit FrameStats(FrameStatsConfig const& config = {});
+
+	void AddFrame(float seconds);
+
+	//Picks csv or json from the extension, csv has one row per window followed by the total
+	bool Write(std::filesystem::path const& path) const;
+	bool WriteCsv(std::filesystem::path const& path) const;
+	bool WriteJson(std::filesystem::path const& path) const;
+
+	//Last k_frameHistoryLength frame times in seconds, oldest first starting at HistoryStart
+	inline std::array<float, k_frameHistoryLength> const& History() const noexcept { return _history; }
+	inline uint32_t HistoryStart() const noexcept { return _frameCount < k_frameHistoryLength ? 0 : (uint32_t)(_frameCount % k_frameHistoryLength); }
+
+	inline std::vector<FrameWindowStats> const& Windows() const noexcept { return _windows; }
+	//Zeroed until the first window is complete
+	inline FrameWindowStats const& LastWindow() const noexcept { return _windows.empty() ? _emptyWindow : _windows.back(); }
+	FrameWindowStats Total() const;
+
+	inline std::vector<float> const& HitchThresholdsMs() const noexcept { return _thresholdsMs; }
+
+private:
+	struct Accumulator
+	{
+		FrameHistogram histogram;
+		double startSeconds = 0.0;
+		double sumSeconds = 0.0;
+		float maxSeconds = 0.f;
+		std::array<uint32_t, k_maxHitchThresholds> hitches{};
+
+		void Add(float seconds, std::vector<float> const& thresholdsMs);
+		void Clear(double start);
+		FrameWindowStats Summarize() const;
+	};
+
+	std::array<float, k_frameHistoryLength> _history{};
+	std::vector<float> _thresholdsMs;
+	std::vector<FrameWindowStats> _windows;
+	FrameWindowStats _emptyWindow;
+	Accumulator _window;
+	Accumulator _total;
+	double _elapsedSeconds;
+	float _windowSeconds;
+	uint64_t _frameCount;
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include "webgpu.h"
+
+//Thin layer between the Gfx wrappers and webgpu, so that a frame can be built without a window or adapter.
+//Objects are still handed around as wgpu handles, backends without a gpu hand out placeholder handles
+//that must only ever be given back to the device that created them.
+namespace Gfx
+{
+	//Commands of a render pass or a render bundle
+	class RenderEncoder {
+	public:
+		virtual ~RenderEncoder() = default;
+
+		virtual void SetPipeline(wgpu::RenderPipeline pipeline) = 0;
+		virtual void SetBindGroup(uint32_t groupIndex, wgpu::BindGroup bindGroup) = 0;
+		virtual void SetVertexBuffer(uint32_t slot, wgpu::Buffer buffer, uint64_t offset, uint64_t size) = 0;
+		virtual void SetIndexBuffer(wgpu::Buffer buffer, wgpu::IndexFormat format, uint64_t offset, uint64_t size) = 0;
+		virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) = 0;
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) = 0;
+		virtual void DrawIndirect(wgpu::Buffer indirectBuffer, uint64_t offset) = 0;
+		virtual void DrawIndexedIndirect(wgpu::Buffer indirectBuffer, uint64_t offset) = 0;
+		//Render passes only, bundles can't execute bundles
+		virtual void ExecuteBundle(wgpu::RenderBundle bundle) = 0;
+		//Render passes only, bundles executed afterwards draw with the pass' viewport. Depth range is always [0, 1]
+		virtual void SetViewport(float x, float y, float width, float height) = 0;
+	};
+
+	class ComputeEncoder {
+	public:
+		virtual ~ComputeEncoder() = default;
+
+		virtual void SetPipeline(wgpu::ComputePipeline pipeline) = 0;
+		virtual void SetBindGroup(uint32_t groupIndex, wgpu::BindGroup bindGroup) = 0;
+		virtual void DispatchWorkgroups(uint32_t x, uint32_t y, uint32_t z) = 0;
+	};
+
+	//Mapped range of a MapRead, nullptr if mapping failed. Only valid during the callback
+	using MapReadCallback = std::function<void(void const* pData, uint64_t size)>;
+
+	class Device {
+	public:
+		virtual ~Device() = default;
+
+		virtual wgpu::Buffer CreateBuffer(wgpu::BufferDescriptor const& desc) = 0;
+		virtual wgpu::Texture CreateTexture(wgpu::TextureDescriptor const& desc) = 0;
+		virtual wgpu::TextureView CreateTextureView(wgpu::Texture texture, wgpu::TextureViewDescriptor const& desc) = 0;
+		virtual wgpu::Sampler CreateSampler(wgpu::SamplerDescriptor const& desc) = 0;
+		virtual wgpu::ShaderModule CreateShaderModule(wgpu::ShaderModuleDescriptor const& desc) = 0;
+		virtual wgpu::BindGroupLayout CreateBindGroupLayout(wgpu::BindGroupLayoutDescriptor const& desc) = 0;
+		virtual wgpu::BindGroup CreateBindGroup(wgpu::BindGroupDescriptor const& desc) = 0;
+		virtual wgpu::PipelineLayout CreatePipelineLayout(wgpu::PipelineLayoutDescriptor const& desc) = 0;
+		virtual wgpu::RenderPipeline CreateRenderPipeline(wgpu::RenderPipelineDescriptor const& desc) = 0;
+		virtual wgpu::ComputePipeline CreateComputePipeline(wgpu::ComputePipelineDescriptor const& desc) = 0;
+		virtual wgpu::QuerySet CreateQuerySet(wgpu::QuerySetDescriptor const& desc) = 0;
+
+		//Drops our reference, buffers and textures are destroyed first
+		virtual void Release(wgpu::Buffer buffer) = 0;
+		virtual void Release(wgpu::Texture texture) = 0;
+		virtual void Release(wgpu::TextureView view) = 0;
+		virtual void Release(wgpu::Sampler sampler) = 0;
+		virtual void Release(wgpu::ShaderModule module) = 0;
+		virtual void Release(wgpu::BindGroupLayout layout) = 0;
+		virtual void Release(wgpu::BindGroup bindGroup) = 0;
+		virtual void Release(wgpu::PipelineLayout layout) = 0;
+		virtual void Release(wgpu::RenderPipeline pipeline) = 0;
+		virtual void Release(wgpu::ComputePipeline pipeline) = 0;
+		virtual void Release(wgpu::RenderBundle bundle) = 0;
+		virtual void Release(wgpu::QuerySet querySet) = 0;
+
+		//Queue writes, these land before any commands submitted after them
+		virtual void WriteBuffer(wgpu::Buffer buffer, uint64_t offset, void const* pData, size_t size) = 0;
+		virtual void WriteTexture(wgpu::ImageCopyTexture const& destination, void const* pData, size_t size,
+			wgpu::TextureDataLayout const& layout, wgpu::Extent3D const& writeSize) = 0;
+
+		//Command recording, like webgpu only one pass or bundle can be open at a time.
+		//The returned encoders are owned by the device and valid until the matching End/Finish
+		virtual wgpu::CommandEncoder BeginCommands(char const* label) = 0;
+		virtual RenderEncoder& BeginRenderPass(wgpu::CommandEncoder commands, wgpu::RenderPassDescriptor const& desc) = 0;
+		virtual void EndRenderPass(RenderEncoder& pass) = 0;
+		virtual ComputeEncoder& BeginComputePass(wgpu::CommandEncoder commands, wgpu::ComputePassDescriptor const& desc) = 0;
+		virtual void EndComputePass(ComputeEncoder& pass) = 0;
+		virtual RenderEncoder& BeginRenderBundle(wgpu::RenderBundleEncoderDescriptor const& desc) = 0;
+		virtual wgpu::RenderBundle FinishRenderBundle(RenderEncoder& bundle, wgpu::RenderBundleDescriptor const& desc) = 0;
+		virtual void CopyBufferToBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t sourceOffset,
+			wgpu::Buffer destination, uint64_t destinationOffset, uint64_t size) = 0;
+		//source.layout.bytesPerRow has to be a multiple of 256
+		virtual void CopyBufferToTexture(wgpu::CommandEncoder commands, wgpu::ImageCopyBuffer const& source,
+			wgpu::ImageCopyTexture const& destination, wgpu::Extent3D const& copySize) = 0;
+		//destination.layout.bytesPerRow has to be a multiple of 256
+		virtual void CopyTextureToBuffer(wgpu::CommandEncoder commands, wgpu::ImageCopyTexture const& source,
+			wgpu::ImageCopyBuffer const& destination, wgpu::Extent3D const& copySize) = 0;
+		virtual void ResolveQuerySet(wgpu::CommandEncoder commands, wgpu::QuerySet querySet, uint32_t firstQuery, uint32_t queryCount,
+			wgpu::Buffer destination, uint64_t destinationOffset) = 0;
+		//Finishes, submits and releases the command encoder
+		virtual void Submit(wgpu::CommandEncoder commands) = 0;
+
+		//Maps a MapRead buffer once the gpu is done with it, calls onMapped from Poll and unmaps after
+		virtual void MapRead(wgpu::Buffer buffer, uint64_t offset, uint64_t size, MapReadCallback onMapped) = 0;
+		//Processes finished work and runs any pending map callbacks, doesn't block
+		virtual void Poll() = 0;
+	};
+}
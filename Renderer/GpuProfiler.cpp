@@ -0,0 +1,128 @@
+#include "GpuProfiler.h"
+#include <algorithm>
+#include <cstring>
+#include "Profiler.h"
+
+namespace
+{
+	constexpr uint32_t k_timestampBytes = sizeof(uint64_t);
+	constexpr uint32_t k_passBytes = 2 * k_timestampBytes;
+}
+
+namespace Gfx
+{
+	GpuProfiler::GpuProfiler(Gfx::Device& device)
+		: _pDevice(&device)
+		, _querySet(nullptr)
+		, _resolveBuffer(k_maxProfiledPasses * k_passBytes, wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc, "Timestamp Resolve", device)
+		, _state(std::make_shared<SharedState>())
+		, _frameIndex(0)
+		, _skippedFrames(0)
+		, _frameActive(false)
+	{
+		wgpu::QuerySetDescriptor querySetDesc{};
+		querySetDesc.label = "Pass Timestamps";
+		querySetDesc.type = wgpu::QueryType::Timestamp;
+		querySetDesc.count = 2 * k_maxProfiledPasses;
+		_querySet = device.CreateQuerySet(querySetDesc);
+
+		for (auto& readback : _readbackBuffers)
+		{
+			readback.emplace(k_maxProfiledPasses * k_passBytes, wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst, "Timestamp Readback", device);
+		}
+	}
+
+	GpuProfiler::~GpuProfiler()
+	{
+		_pDevice->Release(_querySet);
+	}
+
+	void GpuProfiler::BeginFrame()
+	{
+		_frameIndex = (_frameIndex + 1) % k_gpuProfilerFrames;
+		FrameState& frame = _state->frames[_frameIndex];
+		_frameActive = !frame.mapping;
+		if (!_frameActive)
+		{
+			++_skippedFrames;
+			return;
+		}
+		frame.passCount = 0;
+	}
+
+	uint32_t GpuProfiler::AddPass(char const* name)
+	{
+		FrameState& frame = _state->frames[_frameIndex];
+		if (!_frameActive || frame.passCount == k_maxProfiledPasses) return k_maxProfiledPasses;
+		frame.names[frame.passCount] = name;
+		return frame.passCount++;
+	}
+
+	wgpu::RenderPassTimestampWrites const* GpuProfiler::RenderPassWrites(char const* name)
+	{
+		uint32_t pass = AddPass(name);
+		if (pass == k_maxProfiledPasses) return nullptr;
+
+		wgpu::RenderPassTimestampWrites& writes = _renderWrites[pass];
+		writes.querySet = _querySet;
+		writes.beginningOfPassWriteIndex = 2 * pass;
+		writes.endOfPassWriteIndex = 2 * pass + 1;
+		return &writes;
+	}
+
+	wgpu::ComputePassTimestampWrites const* GpuProfiler::ComputePassWrites(char const* name)
+	{
+		uint32_t pass = AddPass(name);
+		if (pass == k_maxProfiledPasses) return nullptr;
+
+		wgpu::ComputePassTimestampWrites& writes = _computeWrites[pass];
+		writes.querySet = _querySet;
+		writes.beginningOfPassWriteIndex = 2 * pass;
+		writes.endOfPassWriteIndex = 2 * pass + 1;
+		return &writes;
+	}
+
+	void GpuProfiler::Resolve(wgpu::CommandEncoder commands)
+	{
+		FrameState const& frame = _state->frames[_frameIndex];
+		if (!_frameActive || frame.passCount == 0) return;
+
+		_pDevice->ResolveQuerySet(commands, _querySet, 0, 2 * frame.passCount, _resolveBuffer.Get(), 0);
+		_pDevice->CopyBufferToBuffer(commands, _resolveBuffer.Get(), 0, _readbackBuffers[_frameIndex]->Get(), 0, frame.passCount * k_passBytes);
+	}
+
+	void GpuProfiler::EndFrame()
+	{
+		FrameState& frame = _state->frames[_frameIndex];
+		if (!_frameActive || frame.passCount == 0) return;
+
+		frame.submitTime = Profiling::Now();
+		frame.mapping = true;
+
+		//Gpu clocks aren't comparable with the cpu's, so the frame's first timestamp is placed at submit.
+		//Work can't start before that, so gpu events only ever show up later than they really ran
+		auto onMapped = [state = _state, frameIndex = _frameIndex](void const* pData, uint64_t size)
+		{
+			FrameState& frame = state->frames[frameIndex];
+			frame.mapping = false;
+			if (!pData || size < frame.passCount * k_passBytes) return;
+
+			std::array<uint64_t, 2 * k_maxProfiledPasses> timestamps;
+			std::memcpy(timestamps.data(), pData, frame.passCount * k_passBytes);
+
+			//Timestamps are in nanoseconds
+			uint64_t const base = timestamps[0];
+			uint64_t last = base;
+			for (uint32_t pass = 0; pass < frame.passCount; ++pass)
+			{
+				uint64_t begin = timestamps[2 * pass];
+				uint64_t end = timestamps[2 * pass + 1];
+				if (begin < base || end < begin) continue; //Unwritten or reset queries
+				Profiling::RecordGpuEvent(frame.names[pass], frame.submitTime + (int64_t)(begin - base), frame.submitTime + (int64_t)(end - base));
+				last = std::max(last, end);
+			}
+			state->lastFrameNs = (int64_t)(last - base);
+		};
+		_pDevice->MapRead(_readbackBuffers[_frameIndex]->Get(), 0, frame.passCount * k_passBytes, onMapped);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <optional>
+#include "webgpu.h"
+#include "GfxDevice.h"
+#include "Buffer.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_maxProfiledPasses = 8;
+	constexpr uint32_t k_gpuProfilerFrames = 3; //Readbacks in flight before frames get skipped
+
+	//Timestamp queries around passes, read back a few frames later and recorded on the profiler's gpu track.
+	//Only create it when the device was requested with FeatureName::TimestampQuery.
+	//Per frame: BeginFrame, pass the writes to the pass descriptors, Resolve before finishing the encoder
+	//and EndFrame after submitting it
+	class GpuProfiler {
+	public:
+		GpuProfiler(Gfx::Device& device);
+		~GpuProfiler();
+
+		void BeginFrame();
+
+		//nullptr when the frame is skipped or out of queries, which leaves the pass unprofiled
+		wgpu::RenderPassTimestampWrites const* RenderPassWrites(char const* name);
+		wgpu::ComputePassTimestampWrites const* ComputePassWrites(char const* name);
+
+		void Resolve(wgpu::CommandEncoder commands);
+		void EndFrame();
+
+		//Frames skipped because every readback buffer was still waiting to be mapped
+		inline uint32_t SkippedFrames() const noexcept { return _skippedFrames; }
+
+		//Start of the first to end of the last profiled pass of the latest frame read back, a few frames old
+		inline float LastFrameMs() const noexcept { return (float)_state->lastFrameNs / 1'000'000.f; }
+
+	private:
+		//No copy, move
+		GpuProfiler(GpuProfiler const& other) = delete;
+		GpuProfiler(GpuProfiler&& other) = delete;
+		GpuProfiler& operator=(GpuProfiler const& other) = delete;
+		GpuProfiler& operator=(GpuProfiler&& other) = delete;
+
+		struct FrameState
+		{
+			std::array<char const*, k_maxProfiledPasses> names{};
+			uint32_t passCount = 0;
+			int64_t submitTime = 0;
+			bool mapping = false;
+		};
+
+		//Shared with the map callbacks so a readback finishing after destruction is harmless
+		struct SharedState
+		{
+			std::array<FrameState, k_gpuProfilerFrames> frames;
+			int64_t lastFrameNs = 0;
+		};
+
+		//Index of the pass' begin/end query pair, or k_maxProfiledPasses if there is none
+		uint32_t AddPass(char const* name);
+
+		Gfx::Device* _pDevice;
+		wgpu::QuerySet _querySet;
+		Gfx::Buffer _resolveBuffer;
+		std::array<std::optional<Gfx::Buffer>, k_gpuProfilerFrames> _readbackBuffers;
+		std::shared_ptr<SharedState> _state;
+		std::array<wgpu::RenderPassTimestampWrites, k_maxProfiledPasses> _renderWrites;
+		std::array<wgpu::ComputePassTimestampWrites, k_maxProfiledPasses> _computeWrites;
+		uint32_t _frameIndex;
+		uint32_t _skippedFrames;
+		bool _frameActive;
+	};
+}
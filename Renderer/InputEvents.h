@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "MathDefs.h"
+#include "Chrono.h"
+#include "SpscQueue.h"
+
+//Events waiting for the next simulation step, far more than a step's worth of input
+constexpr uint32_t k_inputQueueCapacity = 1024;
+
+enum class InputEventType : uint8_t
+{
+	Key,
+	MouseButton,
+	CursorMove,
+	Scroll,
+};
+
+//Codes, actions and mods are GLFW's values (GLFW_KEY_*, GLFW_PRESS...), so this side doesn't need GLFW
+struct InputEvent
+{
+	Clock::TimePoint time; //When the window callback ran
+	InputEventType type = InputEventType::Key;
+	int32_t code = 0; //Key or mouse button
+	int32_t action = 0;
+	int32_t mods = 0;
+	Vec2f value{ 0.f, 0.f }; //Cursor position in screen coordinates or scroll offset
+};
+
+//Window callbacks push on the thread polling events, the simulation thread pops
+class InputQueue {
+public:
+	InputQueue() = default;
+
+	//Producer only. A full queue drops the event
+	inline void Push(InputEvent const& event) noexcept
+	{
+		if (!_events.TryPush(event)) _dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//Consumer only
+	inline bool Pop(InputEvent& event) noexcept { return _events.TryPop(event); }
+
+	inline uint64_t Dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+	//No copy, move
+	InputQueue(InputQueue const& other) = delete;
+	InputQueue(InputQueue&& other) = delete;
+	InputQueue& operator=(InputQueue const& other) = delete;
+	InputQueue& operator=(InputQueue&& other) = delete;
+
+	SpscQueue<InputEvent, k_inputQueueCapacity> _events;
+	std::atomic<uint64_t> _dropped = 0;
+};
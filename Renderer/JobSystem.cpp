@@ -0,0 +1,219 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	//Failed searches before a worker goes to sleep, new work usually shows up within a few yields
+	constexpr uint32_t k_spinsBeforeSleep = 64;
+
+	thread_local Jobs::JobSystem const* t_pSystem = nullptr;
+	thread_local int32_t t_workerIndex = -1;
+	thread_local uint32_t t_stealSeed = 0x9e3779b9u;
+
+	//xorshift, only spreads out which victim gets picked first
+	uint32_t NextVictim(uint32_t workerCount)
+	{
+		t_stealSeed ^= t_stealSeed << 13;
+		t_stealSeed ^= t_stealSeed >> 17;
+		t_stealSeed ^= t_stealSeed << 5;
+		return t_stealSeed % workerCount;
+	}
+}
+
+namespace Jobs
+{
+	WorkStealingDeque::WorkStealingDeque(uint32_t capacity)
+		: _jobs(new std::atomic<Job*>[capacity])
+		, _mask((int64_t)capacity - 1)
+		, _top(0)
+		, _bottom(0)
+	{
+		assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+	}
+
+	bool WorkStealingDeque::Push(Job* pJob) noexcept
+	{
+		int64_t const bottom = _bottom.load(std::memory_order_relaxed);
+		int64_t const top = _top.load(std::memory_order_acquire);
+		if (bottom - top > _mask) return false;
+
+		_jobs[bottom & _mask].store(pJob, std::memory_order_relaxed);
+		_bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	Job* WorkStealingDeque::Pop() noexcept
+	{
+		//seq_cst store then load instead of the paper's fence, same ordering and thread sanitizer understands it
+		int64_t const bottom = _bottom.load(std::memory_order_relaxed) - 1;
+		_bottom.store(bottom, std::memory_order_seq_cst);
+		int64_t top = _top.load(std::memory_order_seq_cst);
+
+		if (top > bottom)
+		{
+			//Was empty
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* pJob = _jobs[bottom & _mask].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			//Last one, race the thieves for it
+			if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) pJob = nullptr;
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return pJob;
+	}
+
+	Job* WorkStealingDeque::Steal() noexcept
+	{
+		int64_t top = _top.load(std::memory_order_seq_cst);
+		int64_t const bottom = _bottom.load(std::memory_order_seq_cst);
+		if (top >= bottom) return nullptr;
+
+		Job* pJob = _jobs[top & _mask].load(std::memory_order_relaxed);
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+		return pJob;
+	}
+
+	uint32_t JobSystem::DefaultWorkerCount() noexcept
+	{
+		return std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	JobSystem::JobSystem(uint32_t workerCount)
+		: _queued(0)
+		, _sleeping(0)
+		, _stopping(false)
+	{
+		workerCount = std::max(workerCount, 1u);
+		for (uint32_t i = 0; i < workerCount; ++i) _workers.push_back(std::make_unique<Worker>(k_maxJobsPerWorker));
+
+		t_pSystem = this;
+		t_workerIndex = 0;
+		for (uint32_t i = 1; i < workerCount; ++i) _workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard lock(_sleepMutex);
+			_stopping = true;
+		}
+		_wake.notify_all();
+		for (std::unique_ptr<Worker>& pWorker : _workers)
+		{
+			if (pWorker->thread.joinable()) pWorker->thread.join();
+		}
+		if (t_pSystem == this) t_pSystem = nullptr;
+	}
+
+	int32_t JobSystem::CurrentWorker() const noexcept
+	{
+		return t_pSystem == this ? t_workerIndex : -1;
+	}
+
+	Job* JobSystem::AllocateJob() noexcept
+	{
+		int32_t const workerIndex = CurrentWorker();
+		if (workerIndex < 0) return nullptr;
+
+		Worker& worker = *_workers[workerIndex];
+		Job& job = worker.jobs[worker.nextJob & (k_maxJobsPerWorker - 1)];
+		if (job.inUse.load(std::memory_order_acquire)) return nullptr;
+
+		++worker.nextJob;
+		job.inUse.store(true, std::memory_order_relaxed);
+		return &job;
+	}
+
+	void JobSystem::Submit(Job* pJob)
+	{
+		//Counted before the push so a thief taking it straight away can't take _queued below zero
+		_queued.fetch_add(1, std::memory_order_seq_cst);
+		Worker& worker = *_workers[CurrentWorker()];
+		if (!worker.deque.Push(pJob))
+		{
+			_queued.fetch_sub(1, std::memory_order_relaxed);
+			Execute(*pJob);
+			return;
+		}
+
+		//Only pay for the lock when someone might be asleep, the seq_cst pair with WorkerLoop means a sleeper either
+		//sees the new job or is seen here
+		if (_sleeping.load(std::memory_order_seq_cst) > 0)
+		{
+			{
+				std::lock_guard lock(_sleepMutex);
+			}
+			_wake.notify_one();
+		}
+	}
+
+	Job* JobSystem::FindJob(uint32_t workerIndex) noexcept
+	{
+		Job* pJob = _workers[workerIndex]->deque.Pop();
+		if (!pJob)
+		{
+			uint32_t const workerCount = WorkerCount();
+			uint32_t const first = NextVictim(workerCount);
+			for (uint32_t i = 0; i < workerCount && !pJob; ++i)
+			{
+				uint32_t const victim = (first + i) % workerCount;
+				if (victim != workerIndex) pJob = _workers[victim]->deque.Steal();
+			}
+		}
+		if (pJob) _queued.fetch_sub(1, std::memory_order_relaxed);
+		return pJob;
+	}
+
+	void JobSystem::Execute(Job& job)
+	{
+		Counter* pCounter = job.pCounter;
+		job.pInvoke(job);
+		job.inUse.store(false, std::memory_order_release);
+		pCounter->_pending.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void JobSystem::Wait(Counter& counter)
+	{
+		int32_t const workerIndex = CurrentWorker();
+		while (!counter.Done())
+		{
+			Job* pJob = workerIndex >= 0 ? FindJob((uint32_t)workerIndex) : nullptr;
+			if (pJob) Execute(*pJob);
+			else std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WorkerLoop(uint32_t workerIndex)
+	{
+		t_pSystem = this;
+		t_workerIndex = (int32_t)workerIndex;
+		t_stealSeed += workerIndex * 0x85ebca6bu;
+
+		uint32_t spins = 0;
+		while (!_stopping.load(std::memory_order_relaxed))
+		{
+			if (Job* pJob = FindJob(workerIndex))
+			{
+				Execute(*pJob);
+				spins = 0;
+				continue;
+			}
+			if (++spins < k_spinsBeforeSleep)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock lock(_sleepMutex);
+			_sleeping.fetch_add(1, std::memory_order_seq_cst);
+			_wake.wait(lock, [this] { return _stopping.load(std::memory_order_relaxed) || _queued.load(std::memory_order_seq_cst) > 0; });
+			_sleeping.fetch_sub(1, std::memory_order_relaxed);
+			spins = 0;
+		}
+	}
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Jobs
+{
+	//Captures are stored inline in the job, bigger tasks should capture a pointer to their data
+	constexpr size_t k_jobStorageBytes = 64;
+	//Per worker, power of two. Past this many unfinished jobs from one thread new ones run inline
+	constexpr uint32_t k_maxJobsPerWorker = 4096;
+
+	//Number of jobs still to finish. Jobs given a counter decrement it when done, Wait returns once it's zero.
+	//Has to outlive its jobs
+	class Counter {
+	public:
+		inline bool Done() const noexcept { return _pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+		std::atomic<uint32_t> _pending = 0;
+	};
+
+	struct Job
+	{
+		void (*pInvoke)(Job& job) = nullptr;
+		Counter* pCounter = nullptr;
+		std::atomic<bool> inUse = false; //Slot can't be reused until the job has run
+		alignas(std::max_align_t) std::byte storage[k_jobStorageBytes];
+	};
+
+	//Chase-Lev deque. The owning worker pushes and pops at the bottom, any thread steals from the top.
+	//Fixed capacity, Push fails when full
+	class WorkStealingDeque {
+	public:
+		explicit WorkStealingDeque(uint32_t capacity);
+
+		//Owner only
+		bool Push(Job* pJob) noexcept;
+		Job* Pop() noexcept;
+
+		//Any thread, nullptr when empty or when another thief won the race
+		Job* Steal() noexcept;
+
+		inline bool Empty() const noexcept
+		{
+			return _top.load(std::memory_order_relaxed) >= _bottom.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::unique_ptr<std::atomic<Job*>[]> _jobs;
+		int64_t _mask;
+		//Apart so the thieves' top and the owner's bottom don't share a cache line
+		alignas(64) std::atomic<int64_t> _top;
+		alignas(64) std::atomic<int64_t> _bottom;
+	};
+
+	//Fixed pool of workers with a deque each, idle workers steal from the others. The thread that creates the system is
+	//worker 0 and takes part while it waits. Run from any other thread executes the task inline
+	class JobSystem {
+	public:
+		//Including the creating thread
+		static uint32_t DefaultWorkerCount() noexcept;
+
+		explicit JobSystem(uint32_t workerCount = DefaultWorkerCount());
+		~JobSystem();
+
+		//task() is run once on some worker, counter is decremented after
+		template<typename Task>
+		void Run(Counter& counter, Task&& task);
+
+		//Runs other jobs until counter hits zero
+		void Wait(Counter& counter);
+
+		//body(begin, end) over [0, count) in chunks of grainSize, returns when all are done. Chunks may run on
+		//the calling thread, body has to be safe to call concurrently
+		template<typename Body>
+		void ParallelFor(uint32_t count, uint32_t grainSize, Body&& body);
+
+		inline uint32_t WorkerCount() const noexcept { return (uint32_t)_workers.size(); }
+
+	private:
+		//No copy, move
+		JobSystem(JobSystem const& other) = delete;
+		JobSystem(JobSystem&& other) = delete;
+		JobSystem& operator=(JobSystem const& other) = delete;
+		JobSystem& operator=(JobSystem&& other) = delete;
+
+		struct Worker
+		{
+			explicit Worker(uint32_t capacity) : deque(capacity), jobs(new Job[capacity]), nextJob(0) {}
+
+			WorkStealingDeque deque;
+			std::unique_ptr<Job[]> jobs;
+			uint32_t nextJob;
+			std::thread thread; //Empty for worker 0
+		};
+
+		//Index of the calling thread in this system, or -1
+		int32_t CurrentWorker() const noexcept;
+		//Free slot in the worker's pool, nullptr if the calling thread isn't a worker or the pool is full of unfinished jobs
+		Job* AllocateJob() noexcept;
+		void Submit(Job* pJob);
+		Job* FindJob(uint32_t workerIndex) noexcept;
+		void Execute(Job& job);
+		void WorkerLoop(uint32_t workerIndex);
+
+		std::vector<std::unique_ptr<Worker>> _workers;
+		std::atomic<uint32_t> _queued; //Pushed and not taken yet, workers sleep while it's zero
+		std::atomic<uint32_t> _sleeping;
+		std::atomic<bool> _stopping;
+		std::mutex _sleepMutex;
+		std::condition_variable _wake;
+	};
+
+	template<typename Task>
+	void JobSystem::Run(Counter& counter, Task&& task)
+	{
+		using Stored = std::decay_t<Task>;
+		static_assert(sizeof(Stored) <= k_jobStorageBytes && alignof(Stored) <= alignof(std::max_align_t),
+			"Job capture too big, capture a pointer to the data instead");
+
+		Job* pJob = AllocateJob();
+		if (!pJob)
+		{
+			task();
+			return;
+		}
+
+		new (pJob->storage) Stored(std::forward<Task>(task));
+		pJob->pInvoke = [](Job& job) {
+			Stored* pTask = std::launder(reinterpret_cast<Stored*>(job.storage));
+			(*pTask)();
+			pTask->~Stored();
+		};
+		pJob->pCounter = &counter;
+		counter._pending.fetch_add(1, std::memory_order_relaxed);
+		Submit(pJob);
+	}
+
+	template<typename Body>
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, Body&& body)
+	{
+		if (count == 0) return;
+		grainSize = grainSize == 0 ? 1 : grainSize;
+
+		//The calling thread takes the last chunk itself instead of queueing it and waiting
+		Counter counter;
+		uint32_t begin = 0;
+		for (; count - begin > grainSize; begin += grainSize)
+		{
+			Run(counter, [&body, begin, grainSize] { body(begin, begin + grainSize); });
+		}
+		body(begin, count);
+		Wait(counter);
+	}
+}
@@ -0,0 +1,45 @@
+#include "MeshCulling.h"
+#include <algorithm>
+#include <cassert>
+
+namespace Gfx
+{
+	Frustum ExtractFrustum(Mat4f const& viewProjection) noexcept
+	{
+		//glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+		auto row = [&](int i) { return Vec4f(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+		Vec4f const x = row(0), y = row(1), z = row(2), w = row(3);
+
+		Frustum frustum;
+		frustum.planes = { w + x, w - x, w + y, w - y, z, w - z };
+		for (Vec4f& plane : frustum.planes)
+		{
+			plane /= glm::length(Vec3f(plane));
+		}
+		return frustum;
+	}
+
+	bool IsSphereVisible(Frustum const& frustum, Vec3f center, float radius) noexcept
+	{
+		for (Vec4f const& plane : frustum.planes)
+		{
+			if (glm::dot(Vec3f(plane), center) + plane.w < -radius) return false;
+		}
+		return true;
+	}
+
+	uint32_t CullMeshInstances(std::span<Mat4f const> models, BoundingSphere const& bounds, Frustum const& frustum,
+		std::span<Mat4f> visibleModels) noexcept
+	{
+		assert(visibleModels.size() >= models.size());
+
+		Vec4f const localCenter(bounds.x, bounds.y, bounds.z, 1.f);
+		uint32_t visibleCount = 0;
+		for (Mat4f const& model : models)
+		{
+			float scale = std::max({ glm::length(Vec3f(model[0])), glm::length(Vec3f(model[1])), glm::length(Vec3f(model[2])) });
+			if (IsSphereVisible(frustum, Vec3f(model * localCenter), bounds.radius * scale)) visibleModels[visibleCount++] = model;
+		}
+		return visibleCount;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include "MathDefs.h"
+#include "MeshDefs.h"
+
+namespace Gfx
+{
+	//Planes point inwards, xyz normalized so w is the signed distance from the origin
+	struct Frustum
+	{
+		std::array<Vec4f, 6> planes;
+	};
+
+	//From a projection * view matrix with [0, 1] clip depth
+	Frustum ExtractFrustum(Mat4f const& viewProjection) noexcept;
+
+	bool IsSphereVisible(Frustum const& frustum, Vec3f center, float radius) noexcept;
+
+	//Copies the models whose transformed bounds touch the frustum into visibleModels in instance order,
+	//returns how many were written. Non uniform scales use the largest axis
+	uint32_t CullMeshInstances(std::span<Mat4f const> models, BoundingSphere const& bounds, Frustum const& frustum,
+		std::span<Mat4f> visibleModels) noexcept;
+}
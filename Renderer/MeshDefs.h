@@ -5,4 +5,11 @@ struct InterleavedVertex
 	float x, y, z;
 	float nx, ny, nz;
 	float r, g, b;
-};
\ No newline at end of file
+};
+
+//In the mesh's local space
+struct BoundingSphere
+{
+	float x = 0.f, y = 0.f, z = 0.f;
+	float radius = 0.f;
+};
@@ -0,0 +1,126 @@
+#include "MeshRenderPipeline.h"
+#include <cstddef>
+#include "MeshDefs.h"
+
+namespace Gfx
+{
+	MeshRenderPipeline::MeshRenderPipeline(
+		Gfx::Device& device,
+		wgpu::ShaderModule shaders,
+		wgpu::ColorTargetState outputTarget,
+		wgpu::DepthStencilState depthStencil,
+		ShaderConstants const& constants)
+		: _pDevice(&device)
+		, _pipeline(nullptr)
+		, _pipelineLayout(nullptr)
+		, _bindLayout(nullptr)
+		, _bindGroup(nullptr)
+	{
+		std::array<wgpu::VertexAttribute, 3> vertexAttributes;
+		vertexAttributes[0].format = wgpu::VertexFormat::Float32x3;
+		vertexAttributes[0].offset = offsetof(InterleavedVertex, x);
+		vertexAttributes[0].shaderLocation = 0;
+		vertexAttributes[1].format = wgpu::VertexFormat::Float32x3;
+		vertexAttributes[1].offset = offsetof(InterleavedVertex, nx);
+		vertexAttributes[1].shaderLocation = 1;
+		vertexAttributes[2].format = wgpu::VertexFormat::Float32x3;
+		vertexAttributes[2].offset = offsetof(InterleavedVertex, r);
+		vertexAttributes[2].shaderLocation = 2;
+
+		wgpu::VertexBufferLayout vertexBufferLayout;
+		vertexBufferLayout.attributeCount = (uint32_t)vertexAttributes.size();
+		vertexBufferLayout.attributes = vertexAttributes.data();
+		vertexBufferLayout.arrayStride = sizeof(InterleavedVertex);
+		vertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
+
+		wgpu::VertexState vertexState{};
+		vertexState.bufferCount = 1;
+		vertexState.buffers = &vertexBufferLayout;
+		vertexState.entryPoint = "vs_main";
+		vertexState.module = shaders;
+		vertexState.constantCount = constants.Count();
+		vertexState.constants = constants.Data();
+
+		wgpu::FragmentState fragmentState{};
+		fragmentState.module = shaders;
+		fragmentState.constantCount = constants.Count();
+		fragmentState.constants = constants.Data();
+		fragmentState.entryPoint = "fs_main";
+		fragmentState.targetCount = 1;
+		fragmentState.targets = &outputTarget;
+
+		wgpu::BindGroupLayoutEntry& uniformBinding = _bindLayouts[0];
+		uniformBinding.binding = 0;
+		uniformBinding.visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment;
+		uniformBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		uniformBinding.buffer.minBindingSize = sizeof(MeshUniforms);
+		uniformBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& instanceBinding = _bindLayouts[1];
+		instanceBinding.binding = 1;
+		instanceBinding.visibility = wgpu::ShaderStage::Vertex;
+		instanceBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+		instanceBinding.buffer.minBindingSize = sizeof(Mat4f);
+		instanceBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutDescriptor bindLayoutDesc;
+		bindLayoutDesc.entryCount = k_MeshPipelineBindingCount;
+		bindLayoutDesc.entries = _bindLayouts.data();
+		_bindLayout = device.CreateBindGroupLayout(bindLayoutDesc);
+
+		wgpu::PipelineLayoutDescriptor meshLayoutDescriptor;
+		meshLayoutDescriptor.bindGroupLayoutCount = 1;
+		meshLayoutDescriptor.bindGroupLayouts = (WGPUBindGroupLayout*)&_bindLayout;
+		meshLayoutDescriptor.label = "Mesh layout";
+		_pipelineLayout = device.CreatePipelineLayout(meshLayoutDescriptor);
+
+		wgpu::RenderPipelineDescriptor meshPipelineDesc;
+		meshPipelineDesc.layout = _pipelineLayout;
+		meshPipelineDesc.depthStencil = &depthStencil;
+		meshPipelineDesc.vertex = vertexState;
+		meshPipelineDesc.fragment = &fragmentState;
+
+		//Obj winding isn't normalized by the loader, so both faces are drawn
+		meshPipelineDesc.primitive.topology = wgpu::PrimitiveTopology::TriangleList;
+		meshPipelineDesc.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
+		meshPipelineDesc.primitive.frontFace = wgpu::FrontFace::CCW;
+		meshPipelineDesc.primitive.cullMode = wgpu::CullMode::None;
+
+		meshPipelineDesc.multisample.count = 1;
+		meshPipelineDesc.multisample.mask = ~0u; //all bits on
+		meshPipelineDesc.multisample.alphaToCoverageEnabled = false;
+
+		meshPipelineDesc.label = "Mesh Pipeline";
+		_pipeline = device.CreateRenderPipeline(meshPipelineDesc);
+	}
+
+	MeshRenderPipeline::~MeshRenderPipeline()
+	{
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_pDevice->Release(_bindLayout);
+		_pDevice->Release(_pipeline);
+		_pDevice->Release(_pipelineLayout);
+	}
+
+	void MeshRenderPipeline::BindData(Gfx::Buffer const& uniformData, Gfx::Buffer const& instanceModels)
+	{
+		wgpu::BindGroupEntry& uniformBind = _bindEntries[0];
+		uniformBind.binding = 0;
+		uniformBind.buffer = uniformData.Get();
+		uniformBind.offset = 0;
+		uniformBind.size = sizeof(MeshUniforms);
+
+		wgpu::BindGroupEntry& instanceBind = _bindEntries[1];
+		instanceBind.binding = 1;
+		instanceBind.buffer = instanceModels.Get();
+		instanceBind.offset = 0;
+		instanceBind.size = instanceModels.Size();
+
+		wgpu::BindGroupDescriptor bindingDesc{};
+		bindingDesc.layout = _bindLayout;
+		bindingDesc.entryCount = k_MeshPipelineBindingCount;
+		bindingDesc.entries = _bindEntries.data();
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_bindGroup = _pDevice->CreateBindGroup(bindingDesc);
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include "webgpu.h"
+#include "MathDefs.h"
+#include "Buffer.h"
+#include "GfxDevice.h"
+#include "ShaderCache.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_MeshPipelineBindingCount = 2;
+
+	//Laid out like Uniforms in shader.wgsl
+	struct MeshUniforms
+	{
+		Mat4f projection;
+		Mat4f view;
+		Vec4f color;
+		float time;
+		float _pad[3] = { 0.f, 0.f, 0.f }; //struct must be 16byte aligned
+	};
+	static_assert(sizeof(MeshUniforms) % 16 == 0);
+
+	//Lit InterleavedVertex meshes, instanced with one model matrix per instance from a storage buffer.
+	//constants fill the override declarations of shader.wgsl (k_gamma), unset ones keep their defaults
+	class MeshRenderPipeline {
+	public:
+		MeshRenderPipeline(Gfx::Device& device, wgpu::ShaderModule shaders, wgpu::ColorTargetState outputTarget, wgpu::DepthStencilState depthStencil,
+			ShaderConstants const& constants = {});
+		~MeshRenderPipeline();
+
+		//instanceModels holds a Mat4f per drawn instance
+		void BindData(Gfx::Buffer const& uniformData, Gfx::Buffer const& instanceModels);
+
+		inline wgpu::RenderPipeline Get() const noexcept {
+			return _pipeline;
+		};
+
+		inline wgpu::BindGroup BindGroup() const noexcept {
+			return _bindGroup;
+		};
+
+	private:
+		//No copy, move
+		MeshRenderPipeline(MeshRenderPipeline const& other) = delete;
+		MeshRenderPipeline(MeshRenderPipeline&& other) = delete;
+		MeshRenderPipeline& operator=(MeshRenderPipeline const& other) = delete;
+		MeshRenderPipeline& operator=(MeshRenderPipeline&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::RenderPipeline _pipeline;
+		wgpu::PipelineLayout _pipelineLayout;
+		std::array<wgpu::BindGroupEntry, k_MeshPipelineBindingCount> _bindEntries;
+		std::array<wgpu::BindGroupLayoutEntry, k_MeshPipelineBindingCount> _bindLayouts;
+		wgpu::BindGroupLayout _bindLayout;
+		wgpu::BindGroup _bindGroup;
+	};
+}
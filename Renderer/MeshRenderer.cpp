@@ -0,0 +1,76 @@
+#include "MeshRenderer.h"
+#include <algorithm>
+#include <vector>
+#include "Profiler.h"
+
+namespace
+{
+	constexpr uint32_t k_meshPipelineId = 2;
+
+	uint32_t CountVertices(Object const& object)
+	{
+		size_t count = 0;
+		for (Shape const& shape : object.shapes) count += shape.points.size();
+		return (uint32_t)count;
+	}
+}
+
+MeshRenderer::MeshRenderer(Gfx::Device& device, Object const& object, wgpu::ShaderModule shader, wgpu::ColorTargetState colorTarget,
+	wgpu::DepthStencilState depthStencil, uint32_t maxInstances, Gfx::ShaderConstants const& constants)
+	: _bounds(object.bounds)
+	, _vertexCount(CountVertices(object))
+	, _maxInstances(maxInstances)
+	, _vertices(std::max(_vertexCount, 1u) * (uint32_t)sizeof(InterleavedVertex), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex, "Mesh Vertices", device)
+	, _uniforms(sizeof(Gfx::MeshUniforms), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, "Mesh Uniforms", device)
+	, _instanceModels(std::max(maxInstances, 1u) * (uint32_t)sizeof(Mat4f), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage, "Mesh Instances", device)
+	, _pipeline(device, shader, colorTarget, depthStencil, constants)
+{
+	//Shapes share the pipeline so they go in one vertex buffer back to back
+	uint32_t offset = 0;
+	for (Shape const& shape : object.shapes)
+	{
+		uint32_t size = (uint32_t)(shape.points.size() * sizeof(InterleavedVertex));
+		if (size == 0) continue;
+		_vertices.EnqueueCopy(shape.points.data(), size, offset);
+		offset += size;
+	}
+
+	_pipeline.BindData(_uniforms, _instanceModels);
+}
+
+void MeshRenderer::Update(std::span<Mat4f const> models, Mat4f const& view, Mat4f const& projection, Vec4f color, float time,
+	std::pmr::memory_resource* pScratch)
+{
+	PROFILE_FUNCTION();
+	models = models.first(std::min<size_t>(models.size(), _maxInstances));
+
+	Gfx::MeshUniforms uniforms;
+	uniforms.projection = projection;
+	uniforms.view = view;
+	uniforms.color = color;
+	uniforms.time = time;
+	_uniforms.EnqueueCopy(&uniforms, 0);
+
+	Gfx::Frustum frustum = Gfx::ExtractFrustum(projection * view);
+	_stats.instances = (uint32_t)models.size();
+	std::pmr::vector<Mat4f> visibleModels(models.size(), pScratch ? pScratch : std::pmr::get_default_resource());
+	_stats.visible = Gfx::CullMeshInstances(models, _bounds, frustum, visibleModels);
+	if (_stats.visible > 0)
+	{
+		_instanceModels.EnqueueCopy(visibleModels.data(), _stats.visible * (uint32_t)sizeof(Mat4f), 0);
+	}
+}
+
+void MeshRenderer::Submit(Gfx::DrawList& draws)
+{
+	if (_stats.visible == 0 || _vertexCount == 0) return;
+
+	Gfx::DrawCommand meshDraw;
+	meshDraw.pipeline = _pipeline.Get();
+	meshDraw.bindGroup = _pipeline.BindGroup();
+	meshDraw.vertexBuffer = _vertices.Get();
+	meshDraw.vertexBufferSize = _vertices.Size();
+	meshDraw.vertexOrIndexCount = _vertexCount;
+	meshDraw.instanceCount = _stats.visible;
+	draws.Add(Gfx::DrawKey::Make(Gfx::k_mainPass, k_meshPipelineId, 0, 0.f, 0), meshDraw);
+}
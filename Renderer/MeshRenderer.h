@@ -0,0 +1,52 @@
+#pragma once
+#include <memory_resource>
+#include <span>
+#include "webgpu.h"
+#include "MathDefs.h"
+#include "ResourceDefs.h"
+#include "GfxDevice.h"
+#include "Buffer.h"
+#include "DrawList.h"
+#include "MeshRenderPipeline.h"
+#include "MeshCulling.h"
+
+struct MeshStats
+{
+	uint32_t instances = 0;
+	uint32_t visible = 0;
+};
+
+//Draws copies of one Object in a single instanced draw. Instances are frustum culled on the cpu against
+//the object's bounding sphere and only the visible models are uploaded
+class MeshRenderer {
+public:
+	MeshRenderer(Gfx::Device& device, Object const& object, wgpu::ShaderModule shader, wgpu::ColorTargetState colorTarget,
+		wgpu::DepthStencilState depthStencil, uint32_t maxInstances, Gfx::ShaderConstants const& constants = {});
+
+	//Models past maxInstances are dropped. The culled models are gathered in pScratch, e.g. a Memory::FrameArena, or the default resource
+	void Update(std::span<Mat4f const> models, Mat4f const& view, Mat4f const& projection, Vec4f color, float time,
+		std::pmr::memory_resource* pScratch = nullptr);
+
+	//Adds the draw for this frame's visible instances, nothing if all were culled
+	void Submit(Gfx::DrawList& draws);
+
+	inline MeshStats const& Stats() const noexcept { return _stats; }
+
+private:
+	//No copy, move
+	MeshRenderer(MeshRenderer const& other) = delete;
+	MeshRenderer(MeshRenderer&& other) = delete;
+	MeshRenderer& operator=(MeshRenderer const& other) = delete;
+	MeshRenderer& operator=(MeshRenderer&& other) = delete;
+
+	BoundingSphere _bounds;
+	uint32_t _vertexCount;
+	uint32_t _maxInstances;
+
+	Gfx::Buffer _vertices;
+	Gfx::Buffer _uniforms;
+	Gfx::Buffer _instanceModels;
+	Gfx::MeshRenderPipeline _pipeline;
+
+	MeshStats _stats;
+};
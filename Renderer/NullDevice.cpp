@@ -0,0 +1,397 @@
+#include "NullDevice.h"
+#include <cassert>
+#include <iostream>
+
+namespace
+{
+	//Good enough for byte accounting, formats we don't use count as 4 bytes per texel
+	uint32_t BytesPerTexel(wgpu::TextureFormat format)
+	{
+		switch (format)
+		{
+		case wgpu::TextureFormat::R8Unorm: return 1;
+		case wgpu::TextureFormat::RG8Unorm: return 2;
+		case wgpu::TextureFormat::RGBA16Float: return 8;
+		case wgpu::TextureFormat::RGBA32Float: return 16;
+		default: return 4;
+		}
+	}
+}
+
+namespace Gfx
+{
+	NullDevice::NullDevice()
+		: _nextId(1)
+		, _liveBytes(0)
+		, _renderPass(*this)
+		, _computePass(*this)
+		, _renderBundle(*this)
+	{
+		_computePass.compute = true;
+	}
+
+	NullDevice::~NullDevice()
+	{
+		//Tests check LiveObjects() themselves, the dump is only a debugging aid
+#ifndef NDEBUG
+		if (!_objects.empty())
+		{
+			std::cout << "NullDevice destroyed with " << _objects.size() << " live objects:\n";
+			for (auto const& [id, object] : _objects)
+			{
+				std::cout << " - " << id << " type " << (uint32_t)object.type << " (" << object.label << ")\n";
+			}
+		}
+#endif
+	}
+
+	void* NullDevice::NewObject(NullObjectType type, uint64_t sizeBytes, char const* label)
+	{
+		uint64_t id = _nextId++;
+		if (_freeObjects.empty())
+		{
+			_objects.emplace(id, NullObject{ type, sizeBytes, label ? label : "" });
+		}
+		else
+		{
+			auto node = std::move(_freeObjects.back());
+			_freeObjects.pop_back();
+			node.key() = id;
+			node.mapped().type = type;
+			node.mapped().sizeBytes = sizeBytes;
+			node.mapped().label = label ? label : "";
+			_objects.insert(std::move(node));
+		}
+		_liveBytes += sizeBytes;
+		++_stats.objectsCreated;
+		return (void*)(uintptr_t)(id << k_handleShift);
+	}
+
+	void NullDevice::ReleaseObject(void const* pHandle, NullObjectType type)
+	{
+		if (!pHandle) return;
+
+		auto it = _objects.find(IdOf(pHandle));
+		assert(it != _objects.end() && "Released an object twice or one this device did not create");
+		if (it == _objects.end()) return;
+		assert(it->second.type == type);
+
+		_liveBytes -= it->second.sizeBytes;
+		_freeObjects.push_back(_objects.extract(it));
+		++_stats.objectsReleased;
+	}
+
+	wgpu::Buffer NullDevice::CreateBuffer(wgpu::BufferDescriptor const& desc)
+	{
+		return NewHandle<wgpu::Buffer, WGPUBuffer>(NullObjectType::Buffer, desc.size, desc.label);
+	}
+
+	wgpu::Texture NullDevice::CreateTexture(wgpu::TextureDescriptor const& desc)
+	{
+		uint64_t sizeBytes = (uint64_t)desc.size.width * desc.size.height * desc.size.depthOrArrayLayers * BytesPerTexel(desc.format);
+		return NewHandle<wgpu::Texture, WGPUTexture>(NullObjectType::Texture, sizeBytes, desc.label);
+	}
+
+	wgpu::TextureView NullDevice::CreateTextureView(wgpu::Texture, wgpu::TextureViewDescriptor const& desc)
+	{
+		return NewHandle<wgpu::TextureView, WGPUTextureView>(NullObjectType::TextureView, 0, desc.label);
+	}
+
+	wgpu::Sampler NullDevice::CreateSampler(wgpu::SamplerDescriptor const& desc)
+	{
+		return NewHandle<wgpu::Sampler, WGPUSampler>(NullObjectType::Sampler, 0, desc.label);
+	}
+
+	wgpu::ShaderModule NullDevice::CreateShaderModule(wgpu::ShaderModuleDescriptor const& desc)
+	{
+		return NewHandle<wgpu::ShaderModule, WGPUShaderModule>(NullObjectType::ShaderModule, 0, desc.label);
+	}
+
+	wgpu::BindGroupLayout NullDevice::CreateBindGroupLayout(wgpu::BindGroupLayoutDescriptor const& desc)
+	{
+		return NewHandle<wgpu::BindGroupLayout, WGPUBindGroupLayout>(NullObjectType::BindGroupLayout, 0, desc.label);
+	}
+
+	wgpu::BindGroup NullDevice::CreateBindGroup(wgpu::BindGroupDescriptor const& desc)
+	{
+		return NewHandle<wgpu::BindGroup, WGPUBindGroup>(NullObjectType::BindGroup, 0, desc.label);
+	}
+
+	wgpu::PipelineLayout NullDevice::CreatePipelineLayout(wgpu::PipelineLayoutDescriptor const& desc)
+	{
+		return NewHandle<wgpu::PipelineLayout, WGPUPipelineLayout>(NullObjectType::PipelineLayout, 0, desc.label);
+	}
+
+	wgpu::RenderPipeline NullDevice::CreateRenderPipeline(wgpu::RenderPipelineDescriptor const& desc)
+	{
+		return NewHandle<wgpu::RenderPipeline, WGPURenderPipeline>(NullObjectType::RenderPipeline, 0, desc.label);
+	}
+
+	wgpu::ComputePipeline NullDevice::CreateComputePipeline(wgpu::ComputePipelineDescriptor const& desc)
+	{
+		return NewHandle<wgpu::ComputePipeline, WGPUComputePipeline>(NullObjectType::ComputePipeline, 0, desc.label);
+	}
+
+	wgpu::QuerySet NullDevice::CreateQuerySet(wgpu::QuerySetDescriptor const& desc)
+	{
+		return NewHandle<wgpu::QuerySet, WGPUQuerySet>(NullObjectType::QuerySet, (uint64_t)desc.count * sizeof(uint64_t), desc.label);
+	}
+
+	void NullDevice::Release(wgpu::Buffer buffer) { ReleaseObject((WGPUBuffer)buffer, NullObjectType::Buffer); }
+	void NullDevice::Release(wgpu::Texture texture) { ReleaseObject((WGPUTexture)texture, NullObjectType::Texture); }
+	void NullDevice::Release(wgpu::TextureView view) { ReleaseObject((WGPUTextureView)view, NullObjectType::TextureView); }
+	void NullDevice::Release(wgpu::Sampler sampler) { ReleaseObject((WGPUSampler)sampler, NullObjectType::Sampler); }
+	void NullDevice::Release(wgpu::ShaderModule module) { ReleaseObject((WGPUShaderModule)module, NullObjectType::ShaderModule); }
+	void NullDevice::Release(wgpu::BindGroupLayout layout) { ReleaseObject((WGPUBindGroupLayout)layout, NullObjectType::BindGroupLayout); }
+	void NullDevice::Release(wgpu::BindGroup bindGroup) { ReleaseObject((WGPUBindGroup)bindGroup, NullObjectType::BindGroup); }
+	void NullDevice::Release(wgpu::PipelineLayout layout) { ReleaseObject((WGPUPipelineLayout)layout, NullObjectType::PipelineLayout); }
+	void NullDevice::Release(wgpu::RenderPipeline pipeline) { ReleaseObject((WGPURenderPipeline)pipeline, NullObjectType::RenderPipeline); }
+	void NullDevice::Release(wgpu::ComputePipeline pipeline) { ReleaseObject((WGPUComputePipeline)pipeline, NullObjectType::ComputePipeline); }
+
+	void NullDevice::Release(wgpu::QuerySet querySet) { ReleaseObject((WGPUQuerySet)querySet, NullObjectType::QuerySet); }
+
+	void NullDevice::Release(wgpu::RenderBundle bundle)
+	{
+		uint64_t id = IdOf((WGPURenderBundle)bundle);
+		_bundles.erase(id);
+		_bundleCounts.erase(id);
+		ReleaseObject((WGPURenderBundle)bundle, NullObjectType::RenderBundle);
+	}
+
+	void NullDevice::WriteBuffer(wgpu::Buffer buffer, uint64_t offset, void const*, size_t size)
+	{
+		_commands.push_back({ NullCommandType::WriteBuffer, IdOf((WGPUBuffer)buffer), offset, size });
+		_stats.bufferBytesWritten += size;
+		++_stats.bufferWrites;
+	}
+
+	void NullDevice::WriteTexture(wgpu::ImageCopyTexture const& destination, void const*, size_t size,
+		wgpu::TextureDataLayout const&, wgpu::Extent3D const& writeSize)
+	{
+		_commands.push_back({ NullCommandType::WriteTexture, IdOf(destination.texture), destination.origin.z, writeSize.depthOrArrayLayers });
+		_stats.textureBytesWritten += size;
+		++_stats.textureWrites;
+	}
+
+	wgpu::CommandEncoder NullDevice::BeginCommands(char const* label)
+	{
+		return NewHandle<wgpu::CommandEncoder, WGPUCommandEncoder>(NullObjectType::CommandEncoder, 0, label);
+	}
+
+	RenderEncoder& NullDevice::BeginRenderPass(wgpu::CommandEncoder commands, wgpu::RenderPassDescriptor const&)
+	{
+		assert(!_renderPass.open && "Previous render pass was not ended");
+		_commands.push_back({ NullCommandType::BeginRenderPass, IdOf((WGPUCommandEncoder)commands) });
+		_renderPass.pTarget = &_commands;
+		_renderPass.open = true;
+		++_stats.renderPasses;
+		return _renderPass;
+	}
+
+	void NullDevice::EndRenderPass(RenderEncoder& pass)
+	{
+		assert(&pass == static_cast<RenderEncoder*>(&_renderPass) && _renderPass.open);
+		_commands.push_back({ NullCommandType::EndRenderPass });
+		_renderPass.open = false;
+	}
+
+	ComputeEncoder& NullDevice::BeginComputePass(wgpu::CommandEncoder commands, wgpu::ComputePassDescriptor const&)
+	{
+		assert(!_computePass.open && "Previous compute pass was not ended");
+		_commands.push_back({ NullCommandType::BeginComputePass, IdOf((WGPUCommandEncoder)commands) });
+		_computePass.pTarget = &_commands;
+		_computePass.open = true;
+		++_stats.computePasses;
+		return _computePass;
+	}
+
+	void NullDevice::EndComputePass(ComputeEncoder& pass)
+	{
+		assert(&pass == static_cast<ComputeEncoder*>(&_computePass) && _computePass.open);
+		_commands.push_back({ NullCommandType::EndComputePass });
+		_computePass.open = false;
+	}
+
+	RenderEncoder& NullDevice::BeginRenderBundle(wgpu::RenderBundleEncoderDescriptor const&)
+	{
+		assert(!_renderBundle.open && "Previous render bundle was not finished");
+		_commands.push_back({ NullCommandType::BeginRenderBundle });
+		_bundleCommands.clear();
+		_renderBundle.pTarget = &_bundleCommands;
+		_renderBundle.bundleCounts = {};
+		_renderBundle.open = true;
+		return _renderBundle;
+	}
+
+	wgpu::RenderBundle NullDevice::FinishRenderBundle(RenderEncoder& bundle, wgpu::RenderBundleDescriptor const& desc)
+	{
+		assert(&bundle == static_cast<RenderEncoder*>(&_renderBundle) && _renderBundle.open);
+		_renderBundle.open = false;
+
+		wgpu::RenderBundle result = NewHandle<wgpu::RenderBundle, WGPURenderBundle>(NullObjectType::RenderBundle, 0, desc.label);
+		uint64_t id = IdOf((WGPURenderBundle)result);
+		_bundles[id] = _bundleCommands;
+		_bundleCounts[id] = _renderBundle.bundleCounts;
+		_commands.push_back({ NullCommandType::FinishRenderBundle, id, _bundleCommands.size() });
+		++_stats.bundlesRecorded;
+		return result;
+	}
+
+	void NullDevice::CopyBufferToBuffer(wgpu::CommandEncoder, wgpu::Buffer source, uint64_t,
+		wgpu::Buffer destination, uint64_t, uint64_t size)
+	{
+		assert(!_renderPass.open && !_computePass.open);
+		_commands.push_back({ NullCommandType::CopyBufferToBuffer, IdOf((WGPUBuffer)source), IdOf((WGPUBuffer)destination), size });
+	}
+
+	void NullDevice::CopyBufferToTexture(wgpu::CommandEncoder, wgpu::ImageCopyBuffer const& source,
+		wgpu::ImageCopyTexture const& destination, wgpu::Extent3D const& copySize)
+	{
+		assert(!_renderPass.open && !_computePass.open);
+		assert(source.layout.bytesPerRow % 256 == 0);
+		uint64_t size = (uint64_t)source.layout.bytesPerRow * copySize.height * copySize.depthOrArrayLayers;
+		_commands.push_back({ NullCommandType::CopyBufferToTexture, IdOf(destination.texture), IdOf((WGPUBuffer)source.buffer), size });
+		_stats.textureBytesCopied += size;
+		++_stats.textureCopies;
+	}
+
+	void NullDevice::CopyTextureToBuffer(wgpu::CommandEncoder, wgpu::ImageCopyTexture const& source,
+		wgpu::ImageCopyBuffer const& destination, wgpu::Extent3D const& copySize)
+	{
+		assert(!_renderPass.open && !_computePass.open);
+		assert(destination.layout.bytesPerRow % 256 == 0);
+		uint64_t size = (uint64_t)destination.layout.bytesPerRow * copySize.height * copySize.depthOrArrayLayers;
+		_commands.push_back({ NullCommandType::CopyTextureToBuffer, IdOf(source.texture), IdOf((WGPUBuffer)destination.buffer), size });
+	}
+
+	void NullDevice::ResolveQuerySet(wgpu::CommandEncoder, wgpu::QuerySet querySet, uint32_t firstQuery, uint32_t queryCount,
+		wgpu::Buffer, uint64_t)
+	{
+		assert(!_renderPass.open && !_computePass.open);
+		_commands.push_back({ NullCommandType::ResolveQuerySet, IdOf((WGPUQuerySet)querySet), firstQuery, queryCount });
+	}
+
+	void NullDevice::Submit(wgpu::CommandEncoder commands)
+	{
+		assert(!_renderPass.open && !_computePass.open);
+		_commands.push_back({ NullCommandType::Submit, IdOf((WGPUCommandEncoder)commands) });
+		++_stats.submits;
+		ReleaseObject((WGPUCommandEncoder)commands, NullObjectType::CommandEncoder);
+	}
+
+	void NullDevice::MapRead(wgpu::Buffer buffer, uint64_t offset, uint64_t size, MapReadCallback onMapped)
+	{
+		_commands.push_back({ NullCommandType::MapRead, IdOf((WGPUBuffer)buffer), offset, size });
+		_pendingMaps.push_back({ size, std::move(onMapped) });
+		++_stats.mapReads;
+	}
+
+	void NullDevice::Poll()
+	{
+		//Callbacks may queue new maps, those complete on the next poll. Both vectors keep their capacity
+		_completedMaps.swap(_pendingMaps);
+		for (PendingMap& map : _completedMaps)
+		{
+			_mapScratch.assign(map.size, 0);
+			map.onMapped(_mapScratch.data(), map.size);
+		}
+		_completedMaps.clear();
+	}
+
+	void NullDevice::Recorder::Record(NullCommand const& command)
+	{
+		assert(open && pTarget);
+		pTarget->push_back(command);
+	}
+
+	//Bundle contents only count into the stats when the bundle executes
+	void NullDevice::Recorder::CountDraw()
+	{
+		if (pTarget == &_device._commands) ++_device._stats.draws;
+		else ++bundleCounts.draws;
+	}
+
+	void NullDevice::Recorder::CountStateChange()
+	{
+		if (pTarget == &_device._commands) ++_device._stats.stateChanges;
+		else ++bundleCounts.stateChanges;
+	}
+
+	void NullDevice::Recorder::SetPipeline(wgpu::RenderPipeline pipeline)
+	{
+		Record({ NullCommandType::SetPipeline, IdOf((WGPURenderPipeline)pipeline) });
+		CountStateChange();
+	}
+
+	void NullDevice::Recorder::SetBindGroup(uint32_t groupIndex, wgpu::BindGroup bindGroup)
+	{
+		Record({ compute ? NullCommandType::SetComputeBindGroup : NullCommandType::SetBindGroup, IdOf((WGPUBindGroup)bindGroup), groupIndex });
+		CountStateChange();
+	}
+
+	void NullDevice::Recorder::SetVertexBuffer(uint32_t slot, wgpu::Buffer buffer, uint64_t offset, uint64_t size)
+	{
+		Record({ NullCommandType::SetVertexBuffer, IdOf((WGPUBuffer)buffer), ((uint64_t)slot << 32) | offset, size });
+		CountStateChange();
+	}
+
+	void NullDevice::Recorder::SetIndexBuffer(wgpu::Buffer buffer, wgpu::IndexFormat, uint64_t offset, uint64_t size)
+	{
+		Record({ NullCommandType::SetIndexBuffer, IdOf((WGPUBuffer)buffer), offset, size });
+		CountStateChange();
+	}
+
+	void NullDevice::Recorder::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t, uint32_t)
+	{
+		Record({ NullCommandType::Draw, 0, vertexCount, instanceCount });
+		CountDraw();
+	}
+
+	void NullDevice::Recorder::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t, int32_t, uint32_t)
+	{
+		Record({ NullCommandType::DrawIndexed, 0, indexCount, instanceCount });
+		CountDraw();
+	}
+
+	void NullDevice::Recorder::DrawIndirect(wgpu::Buffer indirectBuffer, uint64_t offset)
+	{
+		Record({ NullCommandType::DrawIndirect, IdOf((WGPUBuffer)indirectBuffer), offset });
+		CountDraw();
+	}
+
+	void NullDevice::Recorder::DrawIndexedIndirect(wgpu::Buffer indirectBuffer, uint64_t offset)
+	{
+		Record({ NullCommandType::DrawIndexedIndirect, IdOf((WGPUBuffer)indirectBuffer), offset });
+		CountDraw();
+	}
+
+	void NullDevice::Recorder::ExecuteBundle(wgpu::RenderBundle bundle)
+	{
+		assert(pTarget == &_device._commands && "Render bundles can't execute other bundles");
+		uint64_t id = IdOf((WGPURenderBundle)bundle);
+		assert(_device._bundles.contains(id));
+		Record({ NullCommandType::ExecuteBundle, id });
+		++_device._stats.bundlesExecuted;
+		BundleCounts const& counts = _device._bundleCounts[id];
+		_device._stats.draws += counts.draws;
+		_device._stats.stateChanges += counts.stateChanges;
+	}
+
+	void NullDevice::Recorder::SetViewport(float, float, float width, float height)
+	{
+		assert(pTarget == &_device._commands && "Render bundles can't set the viewport");
+		Record({ NullCommandType::SetViewport, 0, (uint64_t)width, (uint64_t)height });
+	}
+
+	void NullDevice::Recorder::SetPipeline(wgpu::ComputePipeline pipeline)
+	{
+		Record({ NullCommandType::SetComputePipeline, IdOf((WGPUComputePipeline)pipeline) });
+		CountStateChange();
+	}
+
+	void NullDevice::Recorder::DispatchWorkgroups(uint32_t x, uint32_t y, uint32_t z)
+	{
+		Record({ NullCommandType::Dispatch, 0, x, ((uint64_t)y << 32) | z });
+		++_device._stats.dispatches;
+	}
+}
@@ -0,0 +1,240 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	enum class NullCommandType : uint8_t
+	{
+		WriteBuffer,
+		WriteTexture,
+		BeginRenderPass,
+		EndRenderPass,
+		BeginComputePass,
+		EndComputePass,
+		BeginRenderBundle,
+		FinishRenderBundle,
+		SetPipeline,
+		SetBindGroup,
+		SetVertexBuffer,
+		SetIndexBuffer,
+		Draw,
+		DrawIndexed,
+		DrawIndirect,
+		DrawIndexedIndirect,
+		ExecuteBundle,
+		SetViewport,
+		SetComputePipeline,
+		SetComputeBindGroup,
+		Dispatch,
+		CopyBufferToBuffer,
+		CopyBufferToTexture,
+		CopyTextureToBuffer,
+		ResolveQuerySet,
+		Submit,
+		MapRead,
+	};
+
+	//object is the id of the handle the command refers to (0 for none), args depend on the command
+	//e.g. offset/size for writes, counts for draws and workgroup counts for dispatches
+	struct NullCommand
+	{
+		NullCommandType type;
+		uint64_t object = 0;
+		uint64_t arg0 = 0;
+		uint64_t arg1 = 0;
+	};
+
+	enum class NullObjectType : uint8_t
+	{
+		Buffer,
+		Texture,
+		TextureView,
+		Sampler,
+		ShaderModule,
+		BindGroupLayout,
+		BindGroup,
+		PipelineLayout,
+		RenderPipeline,
+		ComputePipeline,
+		CommandEncoder,
+		RenderBundle,
+		QuerySet,
+	};
+
+	struct NullObject
+	{
+		NullObjectType type;
+		uint64_t sizeBytes = 0; //Buffers and textures only
+		std::string label;
+	};
+
+	//Running totals since construction or the last ResetStats
+	struct NullDeviceStats
+	{
+		uint64_t bufferBytesWritten = 0;
+		uint64_t textureBytesWritten = 0;
+		uint32_t bufferWrites = 0;
+		uint32_t textureWrites = 0;
+		uint64_t textureBytesCopied = 0; //Staging bytes read by buffer to texture copies, row padding included
+		uint32_t textureCopies = 0;
+		uint32_t renderPasses = 0;
+		uint32_t computePasses = 0;
+		uint32_t bundlesRecorded = 0;
+		uint32_t bundlesExecuted = 0;
+		uint32_t draws = 0; //Includes the draws inside executed bundles
+		uint32_t dispatches = 0;
+		uint32_t stateChanges = 0; //Pipeline, bind group and vertex/index buffer sets, including those inside executed bundles
+		uint32_t submits = 0;
+		uint32_t mapReads = 0;
+		uint32_t objectsCreated = 0;
+		uint32_t objectsReleased = 0;
+	};
+
+	//Device without a gpu: hands out placeholder handles and records commands, byte counts and object
+	//lifetimes instead of executing anything. Meant for headless benchmarks and regression tests of the
+	//cpu side of frame building.
+	class NullDevice final : public Device {
+	public:
+		NullDevice();
+		~NullDevice() override;
+
+		wgpu::Buffer CreateBuffer(wgpu::BufferDescriptor const& desc) override;
+		wgpu::Texture CreateTexture(wgpu::TextureDescriptor const& desc) override;
+		wgpu::TextureView CreateTextureView(wgpu::Texture texture, wgpu::TextureViewDescriptor const& desc) override;
+		wgpu::Sampler CreateSampler(wgpu::SamplerDescriptor const& desc) override;
+		wgpu::ShaderModule CreateShaderModule(wgpu::ShaderModuleDescriptor const& desc) override;
+		wgpu::BindGroupLayout CreateBindGroupLayout(wgpu::BindGroupLayoutDescriptor const& desc) override;
+		wgpu::BindGroup CreateBindGroup(wgpu::BindGroupDescriptor const& desc) override;
+		wgpu::PipelineLayout CreatePipelineLayout(wgpu::PipelineLayoutDescriptor const& desc) override;
+		wgpu::RenderPipeline CreateRenderPipeline(wgpu::RenderPipelineDescriptor const& desc) override;
+		wgpu::ComputePipeline CreateComputePipeline(wgpu::ComputePipelineDescriptor const& desc) override;
+		wgpu::QuerySet CreateQuerySet(wgpu::QuerySetDescriptor const& desc) override;
+
+		void Release(wgpu::Buffer buffer) override;
+		void Release(wgpu::Texture texture) override;
+		void Release(wgpu::TextureView view) override;
+		void Release(wgpu::Sampler sampler) override;
+		void Release(wgpu::ShaderModule module) override;
+		void Release(wgpu::BindGroupLayout layout) override;
+		void Release(wgpu::BindGroup bindGroup) override;
+		void Release(wgpu::PipelineLayout layout) override;
+		void Release(wgpu::RenderPipeline pipeline) override;
+		void Release(wgpu::ComputePipeline pipeline) override;
+		void Release(wgpu::RenderBundle bundle) override;
+		void Release(wgpu::QuerySet querySet) override;
+
+		void WriteBuffer(wgpu::Buffer buffer, uint64_t offset, void const* pData, size_t size) override;
+		void WriteTexture(wgpu::ImageCopyTexture const& destination, void const* pData, size_t size,
+			wgpu::TextureDataLayout const& layout, wgpu::Extent3D const& writeSize) override;
+
+		wgpu::CommandEncoder BeginCommands(char const* label) override;
+		RenderEncoder& BeginRenderPass(wgpu::CommandEncoder commands, wgpu::RenderPassDescriptor const& desc) override;
+		void EndRenderPass(RenderEncoder& pass) override;
+		ComputeEncoder& BeginComputePass(wgpu::CommandEncoder commands, wgpu::ComputePassDescriptor const& desc) override;
+		void EndComputePass(ComputeEncoder& pass) override;
+		RenderEncoder& BeginRenderBundle(wgpu::RenderBundleEncoderDescriptor const& desc) override;
+		wgpu::RenderBundle FinishRenderBundle(RenderEncoder& bundle, wgpu::RenderBundleDescriptor const& desc) override;
+		void CopyBufferToBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t sourceOffset,
+			wgpu::Buffer destination, uint64_t destinationOffset, uint64_t size) override;
+		void CopyBufferToTexture(wgpu::CommandEncoder commands, wgpu::ImageCopyBuffer const& source,
+			wgpu::ImageCopyTexture const& destination, wgpu::Extent3D const& copySize) override;
+		void CopyTextureToBuffer(wgpu::CommandEncoder commands, wgpu::ImageCopyTexture const& source,
+			wgpu::ImageCopyBuffer const& destination, wgpu::Extent3D const& copySize) override;
+		void ResolveQuerySet(wgpu::CommandEncoder commands, wgpu::QuerySet querySet, uint32_t firstQuery, uint32_t queryCount,
+			wgpu::Buffer destination, uint64_t destinationOffset) override;
+		void Submit(wgpu::CommandEncoder commands) override;
+
+		void MapRead(wgpu::Buffer buffer, uint64_t offset, uint64_t size, MapReadCallback onMapped) override;
+		void Poll() override;
+
+		//Commands recorded since the last ClearCommands, keeps its capacity so a steady frame doesn't allocate
+		inline std::vector<NullCommand> const& Commands() const noexcept { return _commands; }
+		inline void ClearCommands() noexcept { _commands.clear(); }
+
+		inline NullDeviceStats const& Stats() const noexcept { return _stats; }
+		inline void ResetStats() noexcept { _stats = {}; }
+
+		//Objects created and not yet released, keyed by handle id
+		inline std::unordered_map<uint64_t, NullObject> const& LiveObjects() const noexcept { return _objects; }
+		inline uint64_t LiveBytes() const noexcept { return _liveBytes; }
+
+		static uint64_t IdOf(void const* pHandle) noexcept { return (uint64_t)(uintptr_t)pHandle >> k_handleShift; }
+
+	private:
+		struct BundleCounts
+		{
+			uint32_t draws = 0;
+			uint32_t stateChanges = 0;
+		};
+
+		//Records into either the pass or the bundle being built
+		class Recorder final : public RenderEncoder, public ComputeEncoder {
+		public:
+			Recorder(NullDevice& device) : _device(device) {}
+
+			void SetPipeline(wgpu::RenderPipeline pipeline) override;
+			void SetBindGroup(uint32_t groupIndex, wgpu::BindGroup bindGroup) override;
+			void SetVertexBuffer(uint32_t slot, wgpu::Buffer buffer, uint64_t offset, uint64_t size) override;
+			void SetIndexBuffer(wgpu::Buffer buffer, wgpu::IndexFormat format, uint64_t offset, uint64_t size) override;
+			void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
+			void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) override;
+			void DrawIndirect(wgpu::Buffer indirectBuffer, uint64_t offset) override;
+			void DrawIndexedIndirect(wgpu::Buffer indirectBuffer, uint64_t offset) override;
+			void ExecuteBundle(wgpu::RenderBundle bundle) override;
+			void SetViewport(float x, float y, float width, float height) override;
+
+			void SetPipeline(wgpu::ComputePipeline pipeline) override;
+			void DispatchWorkgroups(uint32_t x, uint32_t y, uint32_t z) override;
+
+			void Record(NullCommand const& command);
+			void CountDraw();
+			void CountStateChange();
+
+			std::vector<NullCommand>* pTarget = nullptr;
+			BundleCounts bundleCounts; //Of the bundle being built
+			bool open = false;
+			bool compute = false;
+
+		private:
+			NullDevice& _device;
+		};
+
+		//Placeholder handles are ids shifted so they look like aligned pointers, never 0
+		static constexpr uint32_t k_handleShift = 4;
+
+		void* NewObject(NullObjectType type, uint64_t sizeBytes, char const* label);
+		void ReleaseObject(void const* pHandle, NullObjectType type);
+
+		template<typename Handle, typename Raw>
+		Handle NewHandle(NullObjectType type, uint64_t sizeBytes, char const* label)
+		{
+			return Handle{ (Raw)NewObject(type, sizeBytes, label) };
+		}
+
+		std::unordered_map<uint64_t, NullObject> _objects;
+		//Released entries are reused so objects created every frame (command encoders) don't allocate
+		std::vector<std::unordered_map<uint64_t, NullObject>::node_type> _freeObjects;
+		std::unordered_map<uint64_t, std::vector<NullCommand>> _bundles;
+		std::unordered_map<uint64_t, BundleCounts> _bundleCounts;
+		std::vector<NullCommand> _commands;
+		std::vector<NullCommand> _bundleCommands;
+		//Maps complete on the next Poll with zeroed data, like a gpu that finished instantly
+		struct PendingMap
+		{
+			uint64_t size;
+			MapReadCallback onMapped;
+		};
+		std::vector<PendingMap> _pendingMaps;
+		std::vector<PendingMap> _completedMaps;
+		std::vector<uint8_t> _mapScratch;
+		NullDeviceStats _stats;
+		uint64_t _nextId;
+		uint64_t _liveBytes;
+		Recorder _renderPass;
+		Recorder _computePass;
+		Recorder _renderBundle;
+	};
+}
@@ -0,0 +1,184 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t k_gpuTrackId = 0;
+
+	//Seqlock per slot: odd sequence means the owner is writing it, a reader that sees the sequence
+	//change while copying drops the event instead of waiting
+	struct EventSlot
+	{
+		std::atomic<uint32_t> sequence{ 0 };
+		std::atomic<char const*> name{ nullptr };
+		std::atomic<int64_t> start{ 0 };
+		std::atomic<int64_t> end{ 0 };
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> allocatedBytes{ 0 };
+	};
+
+	struct ThreadBuffer
+	{
+		explicit ThreadBuffer(uint32_t trackId) : id(trackId), slots(new EventSlot[Profiling::k_eventsPerThread]) {}
+
+		uint32_t const id;
+		std::atomic<char const*> name{ nullptr };
+		std::atomic<uint64_t> written{ 0 };
+		std::unique_ptr<EventSlot[]> slots;
+	};
+
+	//Buffers are never freed so events of finished threads still make it into the trace
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		ThreadBuffer* pGpu;
+
+		Registry()
+		{
+			buffers.push_back(std::make_unique<ThreadBuffer>(k_gpuTrackId));
+			pGpu = buffers.back().get();
+			pGpu->name.store("GPU", std::memory_order_relaxed);
+		}
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	thread_local ThreadBuffer* t_pBuffer = nullptr;
+
+	ThreadBuffer& GetThreadBuffer()
+	{
+		if (!t_pBuffer)
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard lock(registry.mutex);
+			registry.buffers.push_back(std::make_unique<ThreadBuffer>((uint32_t)registry.buffers.size()));
+			t_pBuffer = registry.buffers.back().get();
+		}
+		return *t_pBuffer;
+	}
+
+	void Write(ThreadBuffer& buffer, char const* name, int64_t start, int64_t end, uint64_t allocations, uint64_t allocatedBytes) noexcept
+	{
+		uint64_t index = buffer.written.load(std::memory_order_relaxed);
+		EventSlot& slot = buffer.slots[index % Profiling::k_eventsPerThread];
+
+		uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+		slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.start.store(start, std::memory_order_relaxed);
+		slot.end.store(end, std::memory_order_relaxed);
+		slot.allocations.store(allocations, std::memory_order_relaxed);
+		slot.allocatedBytes.store(allocatedBytes, std::memory_order_relaxed);
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+
+		buffer.written.store(index + 1, std::memory_order_release);
+	}
+
+	void WriteEscaped(std::ostream& out, std::string_view text)
+	{
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\') out << '\\' << c;
+			else if ((unsigned char)c < 0x20) out << ' ';
+			else out << c;
+		}
+	}
+}
+
+namespace Profiling
+{
+	int64_t Now() noexcept
+	{
+		static auto const epoch = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+	}
+
+	void RecordEvent(char const* name, int64_t start, int64_t end, uint64_t allocations, uint64_t allocatedBytes) noexcept
+	{
+		Write(GetThreadBuffer(), name, start, end, allocations, allocatedBytes);
+	}
+
+	void RecordGpuEvent(char const* name, int64_t start, int64_t end) noexcept
+	{
+		Write(*GetRegistry().pGpu, name, start, end, 0, 0);
+	}
+
+	void SetThreadName(char const* name) noexcept
+	{
+		GetThreadBuffer().name.store(name, std::memory_order_relaxed);
+	}
+
+	bool WriteChromeTrace(std::filesystem::path const& path)
+	{
+		std::ofstream out(path, std::ios::trunc);
+		if (!out)
+		{
+			std::cout << "Failed to open trace file " << path << "\n";
+			return false;
+		}
+
+		Registry& registry = GetRegistry();
+		std::lock_guard lock(registry.mutex);
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		out << std::fixed << std::setprecision(3);
+		bool first = true;
+		uint64_t eventCount = 0;
+		for (auto const& pBuffer : registry.buffers)
+		{
+			if (char const* threadName = pBuffer->name.load(std::memory_order_relaxed))
+			{
+				out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << pBuffer->id << ",\"args\":{\"name\":\"";
+				WriteEscaped(out, threadName);
+				out << "\"}}";
+				first = false;
+			}
+
+			uint64_t written = pBuffer->written.load(std::memory_order_acquire);
+			uint64_t oldest = written - std::min<uint64_t>(written, k_eventsPerThread);
+			for (uint64_t i = oldest; i < written; ++i)
+			{
+				EventSlot const& slot = pBuffer->slots[i % k_eventsPerThread];
+				uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+				if (sequence & 1) continue;
+				char const* name = slot.name.load(std::memory_order_relaxed);
+				int64_t start = slot.start.load(std::memory_order_relaxed);
+				int64_t end = slot.end.load(std::memory_order_relaxed);
+				uint64_t allocations = slot.allocations.load(std::memory_order_relaxed);
+				uint64_t allocatedBytes = slot.allocatedBytes.load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slot.sequence.load(std::memory_order_relaxed) != sequence || !name) continue;
+
+				//Chrome trace times are in microseconds
+				out << (first ? "" : ",\n") << "{\"name\":\"";
+				WriteEscaped(out, name);
+				out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << pBuffer->id
+					<< ",\"ts\":" << (double)start / 1000.0 << ",\"dur\":" << (double)(end - start) / 1000.0;
+				//Shown in the event's details, only scopes that allocated get them
+				if (allocations > 0) out << ",\"args\":{\"allocations\":" << allocations << ",\"bytes\":" << allocatedBytes << "}";
+				out << "}";
+				first = false;
+				++eventCount;
+			}
+		}
+		out << "\n]}\n";
+
+		std::cout << "Wrote " << eventCount << " profile events to " << path << "\n";
+		return (bool)out;
+	}
+}
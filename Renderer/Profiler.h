@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include "AllocationTracker.h"
+
+//Scoped cpu profiling, events go into per thread ring buffers and are exported as a Chrome trace
+//(chrome://tracing or ui.perfetto.dev). Nested scopes show up as a hierarchy since they nest in time.
+//Names must outlive the export, use string literals.
+//Built with RENDERER_PROFILING off the macros compile to nothing.
+//With RENDERER_TRACK_ALLOCATIONS scopes also record the heap allocations made on their thread while open.
+#ifdef RENDERER_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ::Profiling::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_THREAD(name) ::Profiling::SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+namespace Profiling
+{
+	//Per thread, when full the oldest events are overwritten
+	constexpr uint32_t k_eventsPerThread = 1 << 14;
+
+	//Nanoseconds since the profiler's epoch (first call)
+	int64_t Now() noexcept;
+
+	//Lock free, only the first event on a new thread takes the registry lock
+	void RecordEvent(char const* name, int64_t start, int64_t end, uint64_t allocations = 0, uint64_t allocatedBytes = 0) noexcept;
+
+	//Events on the gpu track. Single writer, call from one thread only (the one that polls the device)
+	void RecordGpuEvent(char const* name, int64_t start, int64_t end) noexcept;
+
+	void SetThreadName(char const* name) noexcept;
+
+	//Safe to call while other threads are recording, events being written during the export are skipped
+	bool WriteChromeTrace(std::filesystem::path const& path);
+
+	class Scope {
+	public:
+#ifdef RENDERER_TRACK_ALLOCATIONS
+		explicit Scope(char const* name) noexcept : _name(name), _allocations(Memory::ThreadAllocations()), _start(Now()) {}
+		~Scope()
+		{
+			int64_t const end = Now();
+			Memory::AllocationCounters const allocated = Memory::ThreadAllocations() - _allocations;
+			RecordEvent(_name, _start, end, allocated.allocations, allocated.bytes);
+		}
+#else
+		explicit Scope(char const* name) noexcept : _name(name), _start(Now()) {}
+		~Scope() { RecordEvent(_name, _start, Now()); }
+#endif
+
+	private:
+		//No copy, move
+		Scope(Scope const& other) = delete;
+		Scope(Scope&& other) = delete;
+		Scope& operator=(Scope const& other) = delete;
+		Scope& operator=(Scope&& other) = delete;
+
+		char const* _name;
+#ifdef RENDERER_TRACK_ALLOCATIONS
+		Memory::AllocationCounters _allocations;
+#endif
+		int64_t _start;
+	};
+}
@@ -1,4 +1,6 @@
+#pragma once
 #include <array>
+#include <cstdint>
 #include "MeshDefs.h"
 
 namespace Gfx
@@ -22,5 +24,19 @@ namespace Gfx
 		};
 	};
 
+	//Same quad as above with the shared corners deduplicated
+	struct IndexedQuad
+	{
+		std::array<QuadVertex, 4> vertices = {
+			//Bottom left to top left in counter clockwise order
+			QuadVertex{0.f, 0.f, 0.f, 0.f, 1.f},
+			QuadVertex{1.f, 0.f, 0.f, 1.f, 1.f},
+			QuadVertex{1.f, 1.f, 0.f, 1.f, 0.f},
+			QuadVertex{0.f, 1.f, 0.f, 0.f, 0.f},
+		};
+
+		std::array<uint16_t, 6> indices = { 0, 1, 2, 2, 3, 0 };
+	};
+
 }
 
@@ -0,0 +1,118 @@
+#include "QuadCullPipeline.h"
+#include "QuadDefs.h"
+
+namespace Gfx
+{
+	QuadCullPipeline::QuadCullPipeline(Gfx::Device& device, wgpu::ShaderModule shader)
+		: _pDevice(&device)
+		, _pipeline(nullptr)
+		, _pipelineLayout(nullptr)
+		, _bindLayout(nullptr)
+		, _bindGroup(nullptr)
+	{
+		wgpu::BindGroupLayoutEntry& transformBinding = _bindLayouts[0];
+		transformBinding.binding = 0;
+		transformBinding.visibility = wgpu::ShaderStage::Compute;
+		transformBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+		transformBinding.buffer.minBindingSize = sizeof(QuadTransform);
+		transformBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& cameraUniformBinding = _bindLayouts[1];
+		cameraUniformBinding.binding = 1;
+		cameraUniformBinding.visibility = wgpu::ShaderStage::Compute;
+		cameraUniformBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		cameraUniformBinding.buffer.minBindingSize = sizeof(CamUniforms);
+		cameraUniformBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& visibleBinding = _bindLayouts[2];
+		visibleBinding.binding = 2;
+		visibleBinding.visibility = wgpu::ShaderStage::Compute;
+		visibleBinding.buffer.type = wgpu::BufferBindingType::Storage;
+		visibleBinding.buffer.minBindingSize = sizeof(uint32_t);
+		visibleBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& drawArgsBinding = _bindLayouts[3];
+		drawArgsBinding.binding = 3;
+		drawArgsBinding.visibility = wgpu::ShaderStage::Compute;
+		drawArgsBinding.buffer.type = wgpu::BufferBindingType::Storage;
+		drawArgsBinding.buffer.minBindingSize = sizeof(DrawIndirectArgs);
+		drawArgsBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutDescriptor bindLayoutDesc;
+		bindLayoutDesc.entryCount = k_QuadCullBindingCount;
+		bindLayoutDesc.entries = _bindLayouts.data();
+		_bindLayout = device.CreateBindGroupLayout(bindLayoutDesc);
+
+		wgpu::PipelineLayoutDescriptor cullLayoutDescriptor;
+		cullLayoutDescriptor.bindGroupLayoutCount = 1;
+		cullLayoutDescriptor.bindGroupLayouts = (WGPUBindGroupLayout*)&_bindLayout;
+		cullLayoutDescriptor.label = "Quad cull layout";
+		_pipelineLayout = device.CreatePipelineLayout(cullLayoutDescriptor);
+
+		wgpu::ComputePipelineDescriptor cullPipelineDesc;
+		cullPipelineDesc.layout = _pipelineLayout;
+		cullPipelineDesc.compute.module = shader;
+		cullPipelineDesc.compute.entryPoint = "cs_main";
+		cullPipelineDesc.compute.constantCount = 0;
+		cullPipelineDesc.compute.constants = nullptr;
+		cullPipelineDesc.label = "Quad Cull Pipeline";
+		_pipeline = device.CreateComputePipeline(cullPipelineDesc);
+	}
+
+	QuadCullPipeline::~QuadCullPipeline()
+	{
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_pDevice->Release(_bindLayout);
+		_pDevice->Release(_pipeline);
+		_pDevice->Release(_pipelineLayout);
+	}
+
+	void QuadCullPipeline::BindData(Gfx::Buffer const& transformData, Gfx::Buffer const& cameraData,
+		Gfx::Buffer const& visibleInstances, Gfx::Buffer const& drawArgs)
+	{
+		wgpu::BindGroupEntry& transformBind = _bindEntries[0];
+		transformBind.binding = 0;
+		transformBind.buffer = transformData.Get();
+		transformBind.offset = 0;
+		transformBind.size = transformData.Size();
+
+		wgpu::BindGroupEntry& camBind = _bindEntries[1];
+		camBind.binding = 1;
+		camBind.buffer = cameraData.Get();
+		camBind.offset = 0;
+		camBind.size = cameraData.Size();
+
+		wgpu::BindGroupEntry& visibleBind = _bindEntries[2];
+		visibleBind.binding = 2;
+		visibleBind.buffer = visibleInstances.Get();
+		visibleBind.offset = 0;
+		visibleBind.size = visibleInstances.Size();
+
+		wgpu::BindGroupEntry& drawArgsBind = _bindEntries[3];
+		drawArgsBind.binding = 3;
+		drawArgsBind.buffer = drawArgs.Get();
+		drawArgsBind.offset = 0;
+		drawArgsBind.size = drawArgs.Size();
+
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+
+		wgpu::BindGroupDescriptor bindingDesc{};
+		bindingDesc.layout = _bindLayout;
+		bindingDesc.entryCount = k_QuadCullBindingCount;
+		bindingDesc.entries = _bindEntries.data();
+		_bindGroup = _pDevice->CreateBindGroup(bindingDesc);
+	}
+
+	void QuadCullPipeline::Dispatch(wgpu::CommandEncoder commands, uint32_t instanceCount, wgpu::ComputePassTimestampWrites const* pTimestamps)
+	{
+		wgpu::ComputePassDescriptor cullPassDesc{};
+		cullPassDesc.label = "Quad Cull Pass";
+		cullPassDesc.timestampWrites = pTimestamps;
+
+		Gfx::ComputeEncoder& cullPass = _pDevice->BeginComputePass(commands, cullPassDesc);
+		cullPass.SetPipeline(_pipeline);
+		cullPass.SetBindGroup(0, _bindGroup);
+		cullPass.DispatchWorkgroups((instanceCount + k_cullWorkgroupSize - 1) / k_cullWorkgroupSize, 1, 1);
+		_pDevice->EndComputePass(cullPass);
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include "webgpu.h"
+#include "Buffer.h"
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_QuadCullBindingCount = 4;
+	constexpr uint32_t k_cullWorkgroupSize = 64; //Defined into quadCull.wgsl when it is loaded
+
+	//Compute pre-pass that compacts the quads overlapping the camera into a visible instance list
+	//and bumps the instance count of the indirect draw args to match
+	class QuadCullPipeline {
+	public:
+		QuadCullPipeline(Gfx::Device& device, wgpu::ShaderModule shader);
+		~QuadCullPipeline();
+
+		void BindData(Gfx::Buffer const& transformData, Gfx::Buffer const& cameraData,
+			Gfx::Buffer const& visibleInstances, Gfx::Buffer const& drawArgs);
+
+		//Draw args instance count must be reset to 0 before this runs
+		void Dispatch(wgpu::CommandEncoder commands, uint32_t instanceCount, wgpu::ComputePassTimestampWrites const* pTimestamps = nullptr);
+
+		inline wgpu::ComputePipeline Get() const noexcept {
+			return _pipeline;
+		};
+
+	private:
+		//No copy, move
+		QuadCullPipeline(QuadCullPipeline const& other) = delete;
+		QuadCullPipeline(QuadCullPipeline&& other) = delete;
+		QuadCullPipeline& operator=(QuadCullPipeline const& other) = delete;
+		QuadCullPipeline& operator=(QuadCullPipeline&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::ComputePipeline _pipeline;
+		wgpu::PipelineLayout _pipelineLayout;
+		std::array<wgpu::BindGroupEntry, k_QuadCullBindingCount> _bindEntries;
+		std::array<wgpu::BindGroupLayoutEntry, k_QuadCullBindingCount> _bindLayouts;
+		wgpu::BindGroupLayout _bindLayout;
+		wgpu::BindGroup _bindGroup;
+	};
+}
@@ -0,0 +1,28 @@
+#include "QuadCulling.h"
+#include <cassert>
+
+namespace Gfx
+{
+	bool IsQuadVisible(QuadTransform const& transform, CamUniforms const& camera) noexcept
+	{
+		Vec2f corner0 = Vec2f(transform.position.x, transform.position.y) - camera.position;
+		Vec2f corner1 = corner0 + transform.scale;
+		Vec2f lo = glm::min(corner0, corner1);
+		Vec2f hi = glm::max(corner0, corner1);
+
+		return !(hi.x < -camera.extents.x || hi.y < -camera.extents.y
+			|| lo.x > camera.extents.x || lo.y > camera.extents.y);
+	}
+
+	uint32_t CullQuads(std::span<QuadTransform const> transforms, CamUniforms const& camera, std::span<uint32_t> visibleInstances) noexcept
+	{
+		assert(visibleInstances.size() >= transforms.size());
+
+		uint32_t visibleCount = 0;
+		for (uint32_t instance = 0; instance < transforms.size(); ++instance)
+		{
+			if (IsQuadVisible(transforms[instance], camera)) visibleInstances[visibleCount++] = instance;
+		}
+		return visibleCount;
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "QuadDefs.h"
+
+//CPU reference of the culling kernel in quadCull.wgsl, usable without a device
+namespace Gfx
+{
+	bool IsQuadVisible(QuadTransform const& transform, CamUniforms const& camera) noexcept;
+
+	//Writes the ids of visible quads into visibleInstances in instance order, returns how many were written.
+	//The gpu kernel produces the same set but in no particular order
+	uint32_t CullQuads(std::span<QuadTransform const> transforms, CamUniforms const& camera, std::span<uint32_t> visibleInstances) noexcept;
+}
@@ -26,4 +26,32 @@ struct AnimUniform
 	float _padding[2] = {0.f,0.f};
 };
 
-static_assert(sizeof(AnimUniform) % 16 == 0);
\ No newline at end of file
+static_assert(sizeof(AnimUniform) % 16 == 0);
+
+//Drives AnimUniform::currentFrameIndex on the gpu, laid out like SpriteAnimState in spriteAnim.wgsl
+struct SpriteAnimState
+{
+	uint32_t clipLength = 1; //Frames in the clip
+	uint32_t ticksPerFrame = 1; //Simulation steps each frame is shown for
+	uint32_t phase = 0; //Frame offset, so sprites sharing a clip don't all flip together
+	uint32_t _pad = 0;
+};
+static_assert(sizeof(SpriteAnimState) % 16 == 0);
+
+//Draw order of a sprite entity, cpu side only
+struct SpriteLayer
+{
+	uint32_t layer = 0;
+};
+
+//Laid out as drawIndexedIndirect arguments, drawIndirect only reads the first 4 members
+//(baseVertex doubles as firstInstance there, both stay 0)
+struct DrawIndirectArgs
+{
+	uint32_t vertexOrIndexCount = 0;
+	uint32_t instanceCount = 0;
+	uint32_t firstVertexOrIndex = 0;
+	int32_t baseVertex = 0;
+	uint32_t firstInstance = 0;
+};
+static_assert(sizeof(DrawIndirectArgs) == 5 * sizeof(uint32_t));
@@ -7,16 +7,20 @@ namespace Gfx
 {
 
 	QuadRenderPipeline::QuadRenderPipeline(
-		wgpu::Device device,
+		Gfx::Device& device,
 		wgpu::ShaderModule shaders,
 		wgpu::ColorTargetState outputTarget,
-		wgpu::DepthStencilState depthStencil)
-		: _pipeline(nullptr)
+		wgpu::DepthStencilState depthStencil,
+		QuadGeometry geometry)
+		: _pDevice(&device)
+		, _pipeline(nullptr)
+		, _pipelineLayout(nullptr)
 		, _bindLayout(nullptr)
 		, _bindGroup(nullptr)
 		, _sampler(nullptr)
+		, _geometry(geometry)
 	{
-		std::vector<wgpu::VertexAttribute> quadVertexAttributes{ 2 };
+		std::array<wgpu::VertexAttribute, 2> quadVertexAttributes;
 		quadVertexAttributes[0].format = wgpu::VertexFormat::Float32x3;
 		quadVertexAttributes[0].offset = 0;
 		quadVertexAttributes[0].shaderLocation = 0;
@@ -31,10 +35,19 @@ namespace Gfx
 		quadVertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
 
 		wgpu::VertexState vertexState{};
-		vertexState.bufferCount = 1;
-		vertexState.buffers = &quadVertexBufferLayout;
+		if (geometry == QuadGeometry::VertexPulling)
+		{
+			vertexState.bufferCount = 0;
+			vertexState.buffers = nullptr;
+			vertexState.entryPoint = "vs_main_pulled";
+		}
+		else
+		{
+			vertexState.bufferCount = 1;
+			vertexState.buffers = &quadVertexBufferLayout;
+			vertexState.entryPoint = "vs_main";
+		}
 		vertexState.module = shaders;
-		vertexState.entryPoint = "vs_main";
 		vertexState.constantCount = 0;
 		vertexState.constants = nullptr;
 
@@ -49,7 +62,7 @@ namespace Gfx
 		wgpu::BindGroupLayoutEntry& transformBinding = _bindLayouts[0];
 		transformBinding.binding = 0; //Slot id
 		transformBinding.visibility = wgpu::ShaderStage::Vertex;
-		transformBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		transformBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
 		transformBinding.buffer.minBindingSize = sizeof(QuadTransform);
 		transformBinding.buffer.hasDynamicOffset = false;
 
@@ -71,17 +84,24 @@ namespace Gfx
 		cameraUniformBinding.buffer.minBindingSize = sizeof(CamUniforms);
 		cameraUniformBinding.buffer.hasDynamicOffset = false;
 
-		wgpu::BindGroupLayoutEntry& animationUniformBinding = _bindLayouts[4];
-		animationUniformBinding.binding = 4;
-		animationUniformBinding.visibility = wgpu::ShaderStage::Fragment;
-		animationUniformBinding.buffer.type = wgpu::BufferBindingType::Uniform;
-		animationUniformBinding.buffer.minBindingSize = sizeof(AnimUniform);
-		animationUniformBinding.buffer.hasDynamicOffset = false;
+		wgpu::BindGroupLayoutEntry& animationBinding = _bindLayouts[4];
+		animationBinding.binding = 4;
+		animationBinding.visibility = wgpu::ShaderStage::Fragment;
+		animationBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+		animationBinding.buffer.minBindingSize = sizeof(AnimUniform);
+		animationBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& visibleInstancesBinding = _bindLayouts[5];
+		visibleInstancesBinding.binding = 5;
+		visibleInstancesBinding.visibility = wgpu::ShaderStage::Vertex;
+		visibleInstancesBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+		visibleInstancesBinding.buffer.minBindingSize = sizeof(uint32_t);
+		visibleInstancesBinding.buffer.hasDynamicOffset = false;
 
 		wgpu::BindGroupLayoutDescriptor bindLayoutDesc;
 		bindLayoutDesc.entryCount = k_QuadPipelineBindingCount;
 		bindLayoutDesc.entries = _bindLayouts.data();
-		_bindLayout = device.createBindGroupLayout(bindLayoutDesc);
+		_bindLayout = device.CreateBindGroupLayout(bindLayoutDesc);
 
 		wgpu::SamplerDescriptor spriteSamplerDesc;
 		spriteSamplerDesc.addressModeU = wgpu::AddressMode::ClampToEdge;
@@ -94,16 +114,16 @@ namespace Gfx
 		spriteSamplerDesc.lodMaxClamp = 1.0f;
 		spriteSamplerDesc.compare = wgpu::CompareFunction::Undefined;
 		spriteSamplerDesc.maxAnisotropy = 1;
-		_sampler = device.createSampler(spriteSamplerDesc);
+		_sampler = device.CreateSampler(spriteSamplerDesc);
 
 		wgpu::PipelineLayoutDescriptor quadLayoutDescriptor;
 		quadLayoutDescriptor.bindGroupLayoutCount = 1;
 		quadLayoutDescriptor.bindGroupLayouts = (WGPUBindGroupLayout*)&_bindLayout;
 		quadLayoutDescriptor.label = "Quad layout";
-		wgpu::PipelineLayout quadPipelineLayout = device.createPipelineLayout(quadLayoutDescriptor);
+		_pipelineLayout = device.CreatePipelineLayout(quadLayoutDescriptor);
 
 		wgpu::RenderPipelineDescriptor quadPipelineDesc;
-		quadPipelineDesc.layout = quadPipelineLayout;
+		quadPipelineDesc.layout = _pipelineLayout;
 		quadPipelineDesc.depthStencil = &depthStencil;
 		quadPipelineDesc.vertex = vertexState;
 		quadPipelineDesc.fragment = &fragmentState;
@@ -118,24 +138,26 @@ namespace Gfx
 		quadPipelineDesc.multisample.alphaToCoverageEnabled = false;
 
 		quadPipelineDesc.label = "Quad Pipeline";
-		_pipeline = device.createRenderPipeline(quadPipelineDesc);
+		_pipeline = device.CreateRenderPipeline(quadPipelineDesc);
 	}
 
 	QuadRenderPipeline::~QuadRenderPipeline()
 	{
-		_bindGroup.release();
-		_bindLayout.release();
-		_sampler.release();
-		_pipeline.release();
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_pDevice->Release(_bindLayout);
+		_pDevice->Release(_sampler);
+		_pDevice->Release(_pipeline);
+		_pDevice->Release(_pipelineLayout);
 	}
 
-	void QuadRenderPipeline::BindData(Gfx::Buffer const& transformData, Gfx::Texture const& texture, Gfx::Buffer const& cameraData, Gfx::Buffer const& animationData, wgpu::Device device)
+	void QuadRenderPipeline::BindData(Gfx::Buffer const& transformData, Gfx::Texture const& texture, Gfx::Buffer const& cameraData, Gfx::Buffer const& animationData,
+		Gfx::Buffer const& visibleInstances)
 	{
-		wgpu::BindGroupEntry& uniformBind = _bindEntries[0];
-		uniformBind.binding = 0;
-		uniformBind.buffer = transformData.Get();
-		uniformBind.offset = 0;
-		uniformBind.size = transformData.Size();
+		wgpu::BindGroupEntry& transformBind = _bindEntries[0];
+		transformBind.binding = 0;
+		transformBind.buffer = transformData.Get();
+		transformBind.offset = 0;
+		transformBind.size = transformData.Size();
 
 		wgpu::BindGroupEntry& textureBind = _bindEntries[1];
 		textureBind.binding = 1;
@@ -157,10 +179,17 @@ namespace Gfx
 		animBind.offset = 0;
 		animBind.size = animationData.Size();
 
+		wgpu::BindGroupEntry& visibleBind = _bindEntries[5];
+		visibleBind.binding = 5;
+		visibleBind.buffer = visibleInstances.Get();
+		visibleBind.offset = 0;
+		visibleBind.size = visibleInstances.Size();
+
 		wgpu::BindGroupDescriptor bindingDesc{};
 		bindingDesc.layout = _bindLayout;
 		bindingDesc.entryCount = k_QuadPipelineBindingCount;
 		bindingDesc.entries = _bindEntries.data();
-		_bindGroup = device.createBindGroup(bindingDesc);
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_bindGroup = _pDevice->CreateBindGroup(bindingDesc);
 	}
 }
\ No newline at end of file
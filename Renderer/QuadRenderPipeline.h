@@ -4,18 +4,44 @@
 #include "MathDefs.h"
 #include "Buffer.h"
 #include "Texture.h"
+#include "GfxDevice.h"
 
 namespace Gfx
 {
-	constexpr uint32_t k_QuadPipelineBindingCount = 5;
+	constexpr uint32_t k_QuadPipelineBindingCount = 6;
+
+	//Where the vertex stage gets the quad corners from
+	enum class QuadGeometry
+	{
+		VertexBuffer, //6 QuadVertex per instance from a vertex buffer
+		Indexed, //4 QuadVertex + 6 uint16 indices per instance
+		VertexPulling, //Corners generated from vertex_index, no vertex buffer bound
+	};
+
+	//Bytes the vertex stage fetches from vertex/index buffers to draw instanceCount quads.
+	//Indexed assumes the post transform cache catches the 2 shared corners of each instance
+	constexpr uint64_t QuadVertexFetchBytes(QuadGeometry geometry, uint64_t instanceCount)
+	{
+		constexpr uint64_t k_vertexBytes = 5 * sizeof(float);
+		switch (geometry)
+		{
+		case QuadGeometry::VertexBuffer: return instanceCount * 6 * k_vertexBytes;
+		case QuadGeometry::Indexed: return instanceCount * (4 * k_vertexBytes + 6 * sizeof(uint16_t));
+		case QuadGeometry::VertexPulling: return 0;
+		}
+		return 0;
+	}
 
 	class QuadRenderPipeline {
 	public:
-		QuadRenderPipeline(wgpu::Device device, wgpu::ShaderModule shaders, wgpu::ColorTargetState outputTarget, wgpu::DepthStencilState depthStencil);
+		QuadRenderPipeline(Gfx::Device& device, wgpu::ShaderModule shaders, wgpu::ColorTargetState outputTarget, wgpu::DepthStencilState depthStencil,
+			QuadGeometry geometry = QuadGeometry::VertexBuffer);
 		~QuadRenderPipeline();
 
+		//visibleInstances maps instance_index to the quad to draw, see QuadCullPipeline
 		void BindData(Gfx::Buffer const& transformData, Gfx::Texture const& texture,
-			Gfx::Buffer const& cameraData, Gfx::Buffer const& animationData, wgpu::Device device);
+			Gfx::Buffer const& cameraData, Gfx::Buffer const& animationData,
+			Gfx::Buffer const& visibleInstances);
 
 		inline wgpu::RenderPipeline Get() const noexcept {
 			return _pipeline;
@@ -25,6 +51,10 @@ namespace Gfx
 			return _bindGroup;
 		};
 
+		inline QuadGeometry Geometry() const noexcept {
+			return _geometry;
+		};
+
 	private:
 		//No copy, move
 		QuadRenderPipeline(QuadRenderPipeline const& other) = delete;
@@ -32,11 +62,14 @@ namespace Gfx
 		QuadRenderPipeline& operator=(QuadRenderPipeline const& other) = delete;
 		QuadRenderPipeline& operator=(QuadRenderPipeline&& other) = delete;
 
+		Gfx::Device* _pDevice;
 		wgpu::RenderPipeline _pipeline;
+		wgpu::PipelineLayout _pipelineLayout;
 		std::array<wgpu::BindGroupEntry, k_QuadPipelineBindingCount> _bindEntries;
 		std::array<wgpu::BindGroupLayoutEntry, k_QuadPipelineBindingCount> _bindLayouts;
 		wgpu::BindGroupLayout _bindLayout;
 		wgpu::BindGroup _bindGroup;
 		wgpu::Sampler _sampler;
+		QuadGeometry _geometry;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "RadixSort.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace
+{
+	constexpr uint32_t k_radixBits = 8;
+	constexpr uint32_t k_radixSize = 1u << k_radixBits;
+	constexpr uint32_t k_numPasses = 64 / k_radixBits;
+
+	using Histogram = std::array<size_t, k_radixSize>;
+
+	inline uint32_t Digit(uint64_t key, uint32_t pass)
+	{
+		return (uint32_t)(key >> (pass * k_radixBits)) & (k_radixSize - 1);
+	}
+
+	//State shared by all slices of a single sort
+	struct SortState
+	{
+		Gfx::SortItem* pSrc;
+		Gfx::SortItem* pDst;
+		size_t count;
+		uint32_t sliceCount;
+		uint32_t pass = 0;
+		bool skipPass = false;
+		std::array<Histogram, Gfx::k_maxSortSlices> counts; //Per slice digit counts, turned into write offsets
+
+		inline size_t SliceBegin(uint32_t slice) const noexcept
+		{
+			size_t sliceSize = (count + sliceCount - 1) / sliceCount;
+			return std::min(count, slice * sliceSize);
+		}
+
+		void CountSlice(uint32_t slice) noexcept
+		{
+			Histogram& sliceCounts = counts[slice];
+			sliceCounts.fill(0);
+			for (size_t i = SliceBegin(slice), end = SliceBegin(slice + 1); i < end; ++i) ++sliceCounts[Digit(pSrc[i].key, pass)];
+		}
+
+		//Once every slice has been counted
+		void ComputeOffsets() noexcept
+		{
+			skipPass = false;
+			size_t offset = 0;
+			for (uint32_t digit = 0; digit < k_radixSize; ++digit)
+			{
+				size_t digitTotal = 0;
+				for (uint32_t t = 0; t < sliceCount; ++t)
+				{
+					size_t digitCount = counts[t][digit];
+					counts[t][digit] = offset;
+					offset += digitCount;
+					digitTotal += digitCount;
+				}
+				if (digitTotal == count) skipPass = true;
+			}
+		}
+
+		void ScatterSlice(uint32_t slice) noexcept
+		{
+			Histogram& offsets = counts[slice];
+			for (size_t i = SliceBegin(slice), end = SliceBegin(slice + 1); i < end; ++i)
+			{
+				Gfx::SortItem const& item = pSrc[i];
+				pDst[offsets[Digit(item.key, pass)]++] = item;
+			}
+		}
+
+		//Once every slice has been scattered
+		void FinishPass() noexcept
+		{
+			if (!skipPass) std::swap(pSrc, pDst);
+			++pass;
+		}
+	};
+}
+
+namespace Gfx
+{
+	void RadixSort(std::span<SortItem> items, std::span<SortItem> scratch, Jobs::JobSystem* pJobs)
+	{
+		assert(scratch.size() >= items.size());
+		if (items.size() < 2) return;
+
+		size_t maxUsefulSlices = std::max<size_t>(1, items.size() / k_minItemsPerSortSlice);
+		uint32_t workers = pJobs ? pJobs->WorkerCount() : 1;
+
+		SortState state;
+		state.pSrc = items.data();
+		state.pDst = scratch.data();
+		state.count = items.size();
+		state.sliceCount = (uint32_t)std::clamp<size_t>(workers, 1, std::min<size_t>(k_maxSortSlices, maxUsefulSlices));
+
+		//The pool's workers are already running, each pass only forks and joins twice
+		for (uint32_t pass = 0; pass < k_numPasses; ++pass)
+		{
+			if (state.sliceCount == 1)
+			{
+				state.CountSlice(0);
+				state.ComputeOffsets();
+				if (!state.skipPass) state.ScatterSlice(0);
+			}
+			else
+			{
+				pJobs->ParallelFor(state.sliceCount, 1, [&state](uint32_t begin, uint32_t end) {
+					for (uint32_t slice = begin; slice < end; ++slice) state.CountSlice(slice);
+				});
+				state.ComputeOffsets();
+				if (!state.skipPass)
+				{
+					pJobs->ParallelFor(state.sliceCount, 1, [&state](uint32_t begin, uint32_t end) {
+						for (uint32_t slice = begin; slice < end; ++slice) state.ScatterSlice(slice);
+					});
+				}
+			}
+			state.FinishPass();
+		}
+
+		//Odd number of applied passes leaves the result in scratch
+		if (state.pSrc != items.data()) std::copy(state.pSrc, state.pSrc + state.count, items.data());
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "JobSystem.h"
+
+namespace Gfx
+{
+	struct SortItem
+	{
+		uint64_t key;
+		uint32_t index; //Payload, usually the index of whatever the key was built from
+	};
+
+	constexpr uint32_t k_maxSortSlices = 16;
+	constexpr size_t k_minItemsPerSortSlice = 16 * 1024;
+
+	//Stable LSD radix sort on the full 64 bit key, 8 bits per pass.
+	//Passes where every key shares the same digit are skipped, so keys with unused high bits are cheap.
+	//scratch must be at least as large as items. With pJobs large inputs are split into up to one slice per worker,
+	//small inputs and calls without a job system are sorted on the calling thread only.
+	void RadixSort(std::span<SortItem> items, std::span<SortItem> scratch, Jobs::JobSystem* pJobs = nullptr);
+}
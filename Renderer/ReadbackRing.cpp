@@ -0,0 +1,156 @@
+#include "ReadbackRing.h"
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	constexpr uint64_t k_copyAlignment = 4;
+	constexpr uint64_t k_bytesPerRowAlignment = 256;
+
+	constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+namespace Gfx
+{
+	ReadbackRing::ReadbackRing(Gfx::Device& device, uint32_t slotCount)
+		: _pDevice(&device)
+		, _slots(std::max(slotCount, 1u))
+		, _state(std::make_shared<SharedState>())
+		, _next(0)
+	{
+		_state->slots.assign(_slots.size(), SlotState::Free);
+	}
+
+	ReadbackRing::~ReadbackRing()
+	{
+		//Maps still in flight fail once their buffers are released, their callbacks are dropped
+		_state->alive = false;
+	}
+
+	std::optional<uint32_t> ReadbackRing::AcquireSlot(uint64_t size)
+	{
+		++_state->stats.requested;
+		for (uint32_t i = 0; i < _slots.size(); ++i)
+		{
+			uint32_t index = (_next + i) % (uint32_t)_slots.size();
+			if (_state->slots[index] != SlotState::Free) continue;
+
+			Slot& slot = _slots[index];
+			if (!slot.buffer || slot.buffer->Size() < size)
+			{
+				slot.buffer.reset();
+				slot.buffer.emplace((uint32_t)AlignUp(size, k_bytesPerRowAlignment), wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+					"Readback", *_pDevice);
+			}
+			_next = (index + 1) % (uint32_t)_slots.size();
+			return index;
+		}
+
+		++_state->stats.rejected;
+		return std::nullopt;
+	}
+
+	bool ReadbackRing::ReadBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t offset, uint64_t size, ReadbackCallback onReady)
+	{
+		assert(offset % k_copyAlignment == 0 && size % k_copyAlignment == 0);
+		std::optional<uint32_t> oSlot = AcquireSlot(size);
+		if (!oSlot) return false;
+
+		Slot& slot = _slots[*oSlot];
+		_pDevice->CopyBufferToBuffer(commands, source, offset, slot.buffer->Get(), 0, size);
+		slot.size = size;
+		slot.bytesPerRow = 0;
+		slot.onReady = std::move(onReady);
+		_state->slots[*oSlot] = SlotState::Recorded;
+		return true;
+	}
+
+	bool ReadbackRing::ReadTexture(wgpu::CommandEncoder commands, Gfx::Texture const& texture, wgpu::Origin3D origin, wgpu::Extent3D size,
+		ReadbackCallback onReady)
+	{
+		return ReadTexture(commands, texture.Get(), texture.BytesPerTexel(), origin, size, std::move(onReady));
+	}
+
+	bool ReadbackRing::ReadTexture(wgpu::CommandEncoder commands, wgpu::Texture texture, uint32_t bytesPerTexel, wgpu::Origin3D origin,
+		wgpu::Extent3D size, ReadbackCallback onReady)
+	{
+		uint32_t const bytesPerRow = (uint32_t)AlignUp((uint64_t)bytesPerTexel * size.width, k_bytesPerRowAlignment);
+		uint64_t const bytes = (uint64_t)bytesPerRow * size.height * size.depthOrArrayLayers;
+		std::optional<uint32_t> oSlot = AcquireSlot(bytes);
+		if (!oSlot) return false;
+
+		Slot& slot = _slots[*oSlot];
+		wgpu::ImageCopyTexture source;
+		source.texture = texture;
+		source.mipLevel = 0;
+		source.origin = origin;
+		source.aspect = wgpu::TextureAspect::All;
+
+		wgpu::ImageCopyBuffer destination;
+		destination.buffer = slot.buffer->Get();
+		destination.layout.offset = 0;
+		destination.layout.bytesPerRow = bytesPerRow;
+		destination.layout.rowsPerImage = size.height;
+
+		_pDevice->CopyTextureToBuffer(commands, source, destination, size);
+		slot.size = bytes;
+		slot.bytesPerRow = bytesPerRow;
+		slot.onReady = std::move(onReady);
+		_state->slots[*oSlot] = SlotState::Recorded;
+		return true;
+	}
+
+	std::future<std::vector<std::byte>> ReadbackRing::ReadBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t offset, uint64_t size)
+	{
+		//std::function needs a copyable callable, so the promise is shared
+		auto promise = std::make_shared<std::promise<std::vector<std::byte>>>();
+		std::future<std::vector<std::byte>> result = promise->get_future();
+		auto onReady = [promise](ReadbackData const& data) {
+			promise->set_value(std::vector<std::byte>(data.bytes.begin(), data.bytes.end()));
+		};
+		if (!ReadBuffer(commands, source, offset, size, onReady)) return {};
+		return result;
+	}
+
+	void ReadbackRing::Submitted()
+	{
+		for (uint32_t index = 0; index < _slots.size(); ++index)
+		{
+			if (_state->slots[index] != SlotState::Recorded) continue;
+			_state->slots[index] = SlotState::Mapping;
+
+			Slot& slot = _slots[index];
+			auto onMapped = [state = _state, index, size = slot.size, bytesPerRow = slot.bytesPerRow, onReady = std::move(slot.onReady)](void const* pData, uint64_t)
+			{
+				if (state->alive)
+				{
+					ReadbackData data;
+					data.bytesPerRow = bytesPerRow;
+					if (pData)
+					{
+						data.bytes = std::span<std::byte const>(static_cast<std::byte const*>(pData), size);
+						++state->stats.completed;
+						state->stats.bytes += size;
+					}
+					else
+					{
+						++state->stats.failed;
+					}
+					if (onReady) onReady(data);
+				}
+				//Freed after the callback, it can't be reused while it's still mapped
+				state->slots[index] = SlotState::Free;
+			};
+			slot.onReady = nullptr;
+			_pDevice->MapRead(slot.buffer->Get(), 0, slot.size, std::move(onMapped));
+		}
+	}
+
+	uint32_t ReadbackRing::InFlight() const
+	{
+		return (uint32_t)std::count_if(_state->slots.begin(), _state->slots.end(), [](SlotState state) { return state != SlotState::Free; });
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include "webgpu.h"
+#include "GfxDevice.h"
+#include "Buffer.h"
+#include "Texture.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_readbackSlots = 4;
+
+	//bytes is empty if the map failed. bytesPerRow is 0 for buffer reads, texture rows are padded to 256 bytes
+	struct ReadbackData
+	{
+		std::span<std::byte const> bytes;
+		uint32_t bytesPerRow = 0;
+	};
+	//Only valid during the callback, the buffer is unmapped right after
+	using ReadbackCallback = std::function<void(ReadbackData const& data)>;
+
+	struct ReadbackStats
+	{
+		uint32_t requested = 0;
+		uint32_t completed = 0;
+		uint32_t failed = 0;
+		uint32_t rejected = 0; //Every slot was busy
+		uint64_t bytes = 0;
+	};
+
+	//Pool of MapRead buffers used round robin for gpu to cpu copies (picking, gpu stats, screenshots).
+	//Read* records the copy into the frame's commands, Submitted starts mapping once they've been submitted,
+	//and results arrive from Device::Poll a few frames later, the frame never waits on them.
+	//Slots grow to fit the biggest read they've served
+	class ReadbackRing {
+	public:
+		explicit ReadbackRing(Gfx::Device& device, uint32_t slotCount = k_readbackSlots);
+		~ReadbackRing();
+
+		//offset and size must be multiples of 4, like any buffer copy. False if no slot was free, try again next frame
+		bool ReadBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t offset, uint64_t size, ReadbackCallback onReady);
+		//The texture needs CopySrc usage
+		bool ReadTexture(wgpu::CommandEncoder commands, Gfx::Texture const& texture, wgpu::Origin3D origin, wgpu::Extent3D size,
+			ReadbackCallback onReady);
+		//For textures not owned by a Gfx::Texture, like the swap chain's
+		bool ReadTexture(wgpu::CommandEncoder commands, wgpu::Texture texture, uint32_t bytesPerTexel, wgpu::Origin3D origin, wgpu::Extent3D size,
+			ReadbackCallback onReady);
+
+		//Invalid if no slot was free. Resolves inside Device::Poll, so never block on it from the polling thread.
+		//The vector is empty if the map failed, and the promise is broken if the ring goes away first
+		std::future<std::vector<std::byte>> ReadBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t offset, uint64_t size);
+
+		//Call after submitting the commands the reads were recorded in
+		void Submitted();
+
+		uint32_t InFlight() const;
+		inline ReadbackStats const& Stats() const noexcept { return _state->stats; }
+
+	private:
+		//No copy, move
+		ReadbackRing(ReadbackRing const& other) = delete;
+		ReadbackRing(ReadbackRing&& other) = delete;
+		ReadbackRing& operator=(ReadbackRing const& other) = delete;
+		ReadbackRing& operator=(ReadbackRing&& other) = delete;
+
+		enum class SlotState : uint8_t
+		{
+			Free,
+			Recorded, //Copy recorded, waiting for the submit
+			Mapping,
+		};
+
+		struct Slot
+		{
+			std::optional<Gfx::Buffer> buffer;
+			uint64_t size = 0;
+			uint32_t bytesPerRow = 0;
+			ReadbackCallback onReady;
+		};
+
+		//Shared with the map callbacks so a readback finishing after destruction is harmless
+		struct SharedState
+		{
+			std::vector<SlotState> slots;
+			ReadbackStats stats;
+			bool alive = true;
+		};
+
+		//Index of a free slot holding at least size bytes, or nullopt
+		std::optional<uint32_t> AcquireSlot(uint64_t size);
+
+		Gfx::Device* _pDevice;
+		std::vector<Slot> _slots;
+		std::shared_ptr<SharedState> _state;
+		uint32_t _next;
+	};
+}
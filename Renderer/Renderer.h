@@ -1,5 +1,6 @@
 #pragma once
 #include <GLFW/glfw3.h>
+#include "InputEvents.h"
 
 constexpr uint32_t k_screenWidth = 800;
 constexpr uint32_t k_screenHeight = 600;
@@ -9,7 +10,7 @@ class Window
 public:
 	Window() : pWindow(nullptr)
 	{
-		glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 		pWindow = glfwCreateWindow(k_screenWidth, k_screenHeight, "WebGpu", nullptr, nullptr);
 	}
@@ -26,7 +27,38 @@ public:
 
 	inline GLFWwindow* get() { return pWindow; }
 
+	//Key, mouse button, cursor and scroll callbacks push timestamped events into queue, which has to outlive the window.
+	//They run inside glfwPollEvents, so the polling thread is the queue's producer
+	void RouteInput(InputQueue& queue)
+	{
+		glfwSetWindowUserPointer(pWindow, &queue);
+		glfwSetKeyCallback(pWindow, [](GLFWwindow* pGlfwWindow, int key, int /*scancode*/, int action, int mods) {
+			PushInput(pGlfwWindow, InputEventType::Key, key, action, mods, Vec2f{ 0.f, 0.f });
+		});
+		glfwSetMouseButtonCallback(pWindow, [](GLFWwindow* pGlfwWindow, int button, int action, int mods) {
+			PushInput(pGlfwWindow, InputEventType::MouseButton, button, action, mods, Vec2f{ 0.f, 0.f });
+		});
+		glfwSetCursorPosCallback(pWindow, [](GLFWwindow* pGlfwWindow, double x, double y) {
+			PushInput(pGlfwWindow, InputEventType::CursorMove, 0, 0, 0, Vec2f{ (float)x, (float)y });
+		});
+		glfwSetScrollCallback(pWindow, [](GLFWwindow* pGlfwWindow, double x, double y) {
+			PushInput(pGlfwWindow, InputEventType::Scroll, 0, 0, 0, Vec2f{ (float)x, (float)y });
+		});
+	}
+
 private:
+	static void PushInput(GLFWwindow* pGlfwWindow, InputEventType type, int code, int action, int mods, Vec2f value)
+	{
+		InputEvent event;
+		event.time = Clock::Clock::now();
+		event.type = type;
+		event.code = code;
+		event.action = action;
+		event.mods = mods;
+		event.value = value;
+		static_cast<InputQueue*>(glfwGetWindowUserPointer(pGlfwWindow))->Push(event);
+	}
+
 	GLFWwindow* pWindow;
 };
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vector>
 #include "MeshDefs.h"
 #include "webgpu.h"
@@ -7,11 +8,13 @@
 struct Shape
 {
 	std::vector<InterleavedVertex> points;
+	BoundingSphere bounds;
 };
 
 struct Object
 {
 	std::vector<Shape> shapes;
+	BoundingSphere bounds; //Encloses every shape
 };
 
 struct TextureResource
@@ -25,4 +28,23 @@ struct TextureResource
 
 	uint32_t SizeBytes() const noexcept{ return numChannels * width * height * channelDepthBytes; }
 	wgpu::Extent3D Extents() const noexcept { return { width, height, 1 }; }
+};
+
+//Placement of a glyph relative to the pen position at the top of the line, all in pixels
+struct GlyphResource
+{
+	float advance = 0.f;
+	float x0 = 0.f, y0 = 0.f, x1 = 0.f, y1 = 0.f;
+	float u0 = 0.f, v0 = 0.f, u1 = 0.f, v1 = 0.f;
+};
+
+//Printable ascii only
+constexpr uint32_t k_firstFontGlyph = 32;
+constexpr uint32_t k_fontGlyphCount = 127 - k_firstFontGlyph;
+
+struct FontResource
+{
+	TextureResource atlas; //RGBA8, coverage in alpha
+	std::array<GlyphResource, k_fontGlyphCount> glyphs;
+	float lineHeight = 0.f;
 };
\ No newline at end of file
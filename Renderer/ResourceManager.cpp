@@ -1,14 +1,26 @@
 #include "ResourceManager.h"
+#include <optional>
+#include <vector>
 #include "Utils.h"
 
-void ResourceManager::LoadAllAnimations(std::filesystem::path const& parentFolder)
+void ResourceManager::LoadAllAnimations(std::filesystem::path const& parentFolder, Jobs::JobSystem* pJobs)
 {
 	std::cout << "Attempting to load Animations in " << parentFolder << "\n";
+	std::vector<std::filesystem::path> folders;
 	for (auto const& dir : std::filesystem::directory_iterator{ parentFolder }) {
-		if (dir.is_directory()) {
-			auto oAnim = Utils::LoadAnimationTexture(dir);
-			if (oAnim) m_anims.emplace((*oAnim).label, *oAnim);
-		}
+		if (dir.is_directory()) folders.push_back(dir.path());
+	}
+
+	//Decoding is the slow part so the folders load in parallel, the map is only touched afterwards
+	std::vector<std::optional<TextureResource>> loaded(folders.size());
+	auto load = [&folders, &loaded](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) loaded[i] = Utils::LoadAnimationTexture(folders[i]);
+	};
+	if (pJobs) pJobs->ParallelFor((uint32_t)folders.size(), 1, load);
+	else load(0, (uint32_t)folders.size());
+
+	for (std::optional<TextureResource>& oAnim : loaded) {
+		if (oAnim) m_anims.emplace(oAnim->label, std::move(*oAnim));
 	}
 }
 
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <string>
 #include "ResourceDefs.h"
+#include "JobSystem.h"
 
 //Loads and holds memory of all resources in the file paths given
 class ResourceManager {
@@ -11,8 +12,8 @@ public:
 	using AnimationMapKey = std::string;
 	using AnimationMap = std::unordered_map<AnimationMapKey, TextureResource>;
 
-	//recurses through the folder given loading animations in sub folders
-	void LoadAllAnimations(std::filesystem::path const& parentFolder);
+	//recurses through the folder given loading animations in sub folders, each folder is a job when pJobs is given
+	void LoadAllAnimations(std::filesystem::path const& parentFolder, Jobs::JobSystem* pJobs = nullptr);
 
 	TextureResource const& GetAnimation(AnimationMapKey id) const noexcept;
 
@@ -0,0 +1,3 @@
+//Bit i of each mask is the x/y of corner i, same counter clockwise order as Gfx::Quad
+const k_cornerMaskX = 0x0Eu;
+const k_cornerMaskY = 0x1Cu;
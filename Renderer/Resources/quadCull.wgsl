@@ -0,0 +1,43 @@
+struct Camera {
+    //x,y are camera center, z,w are camera extents (width, height)
+    posExtent: vec4f,
+}
+
+struct Transform {
+    position: vec3f,
+    _padding0: f32,
+    scale: vec2f,
+    _padding: vec2f,
+}
+
+@group(0) @binding(0) var<storage, read> transforms: array<Transform>;
+@group(0) @binding(1) var<uniform> uCamera: Camera;
+@group(0) @binding(2) var<storage, read_write> visibleInstances: array<u32>;
+//DrawIndirectArgs, instance count is the second member for both drawIndirect and drawIndexedIndirect
+@group(0) @binding(3) var<storage, read_write> drawArgs: array<atomic<u32>, 5>;
+
+//Set from Gfx::k_cullWorkgroupSize
+#ifndef k_cullWorkgroupSize
+#define k_cullWorkgroupSize 64
+#endif
+
+@compute @workgroup_size(k_cullWorkgroupSize)
+fn cs_main(@builtin(global_invocation_id) id: vec3u) {
+    let instance = id.x;
+    if (instance >= arrayLength(&transforms)) {
+        return;
+    }
+
+    //Same view space as vs_main in quadShader.wgsl, visible when it overlaps [-extent, extent]
+    let transform = transforms[instance];
+    let corner0 = transform.position.xy - uCamera.posExtent.xy;
+    let corner1 = corner0 + transform.scale;
+    let lo = min(corner0, corner1);
+    let hi = max(corner0, corner1);
+    if (any(hi < -uCamera.posExtent.zw) || any(lo > uCamera.posExtent.zw)) {
+        return;
+    }
+
+    let slot = atomicAdd(&drawArgs[1], 1u);
+    visibleInstances[slot] = instance;
+}
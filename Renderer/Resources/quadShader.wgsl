@@ -29,20 +29,21 @@ struct Transform {
     _padding: vec2f,
 }
 
-const k_maxInstancesPerDraw = 100;
-
-@group(0) @binding(0) var<uniform> uTransforms: array<Transform, k_maxInstancesPerDraw>;
+//Storage rather than uniform arrays so they are sized by the buffers, one entry per terrain cell
+@group(0) @binding(0) var<storage, read> transforms: array<Transform>;
 @group(0) @binding(1) var textures: texture_2d_array<f32>;
 @group(0) @binding(2) var txSampler: sampler;
 @group(0) @binding(3) var<uniform> uCamera: Camera;
-@group(0) @binding(4) var<uniform> uAnimations: array<Animation, k_maxInstancesPerDraw>;
+@group(0) @binding(4) var<storage, read> animations: array<Animation>;
+//Written by the cull pass in quadCull.wgsl, maps instance_index to the quad to draw
+@group(0) @binding(5) var<storage, read> visibleInstances: array<u32>;
 
-@vertex
-fn vs_main(in: VertexInput, @builtin(instance_index) instance: u32) -> VertexOutput {
+fn transformQuad(position: vec3f, texCoord: vec2f, visibleIndex: u32) -> VertexOutput {
     var out: VertexOutput;
-    var transform = uTransforms[instance];
+    let instance = visibleInstances[visibleIndex];
+    var transform = transforms[instance];
     //Model transform
-    out.position = vec4f((transform.position.xy + transform.scale.xy * in.position.xy).xy, transform.position.z + in.position.z, 1.0f);
+    out.position = vec4f((transform.position.xy + transform.scale.xy * position.xy).xy, transform.position.z + position.z, 1.0f);
     //View space
     out.position = vec4f(out.position.xy - uCamera.posExtent.xy, out.position.z, out.position.w);
     //NDC projection 
@@ -50,14 +51,27 @@ fn vs_main(in: VertexInput, @builtin(instance_index) instance: u32) -> VertexOut
                          out.position.y / uCamera.posExtent.w,
                          out.position.zw
         );
-    out.texCoord = in.texCoord;
+    out.texCoord = texCoord;
     out.instance = instance;
     return out;
 }
 
+@vertex
+fn vs_main(in: VertexInput, @builtin(instance_index) instance: u32) -> VertexOutput {
+    return transformQuad(in.position, in.texCoord, instance);
+}
+
+#include "quadCorners.wgsl"
+
+@vertex
+fn vs_main_pulled(@builtin(vertex_index) vertex: u32, @builtin(instance_index) instance: u32) -> VertexOutput {
+    let corner = vec2f(f32((k_cornerMaskX >> vertex) & 1u), f32((k_cornerMaskY >> vertex) & 1u));
+    return transformQuad(vec3f(corner, 0.0f), vec2f(corner.x, 1.0f - corner.y), instance);
+}
+
 @fragment
 fn fs_main(in: VertexOutput) -> @location(0) vec4f {
-    let anim: Animation = uAnimations[in.instance];
+    let anim: Animation = animations[in.instance];
     let dims: vec2f = vec2f(textureDimensions(textures));
     let offset: vec2f = vec2f(f32(anim.currFrame) * anim.frameDim.x + anim.startCoord.x, anim.startCoord.y);
     let normOffset: vec2f = offset / dims; //offset in texture space
@@ -10,31 +10,34 @@ struct VertexOutput {
 	@location(1) normal: vec3f,
 };
 
+//Per frame, models are per instance in uInstances
 struct Uniforms {
 	projection: mat4x4f,
 	view: mat4x4f,
-	model: mat4x4f,
 	color: vec4f,
 	time: f32,
 };
 
+//Pipeline overridable, see Gfx::ShaderConstants
+override k_gamma: f32 = 2.2;
+
 //variable sits within the uniform address space
 @group(0) @binding(0) var<uniform> uUniforms: Uniforms;
-@group(0) @binding(1) var gradientTexture: texture_2d<f32>;
+//Models of the instances that survived culling, instance_index indexes it directly
+@group(0) @binding(1) var<storage, read> uInstances: array<mat4x4f>;
 
 @vertex
-fn vs_main(in: VertexInput) -> VertexOutput {
+fn vs_main(in: VertexInput, @builtin(instance_index) instance: u32) -> VertexOutput {
 	var out: VertexOutput;
-    out.position = uUniforms.projection * uUniforms.view * uUniforms.model * vec4f(in.position, 1.0);
+	let model = uInstances[instance];
+	out.position = uUniforms.projection * uUniforms.view * model * vec4f(in.position, 1.0);
 	out.color = in.color;
-	out.normal = (uUniforms.model * vec4f(in.normal, 0.0)).xyz;
+	out.normal = (model * vec4f(in.normal, 0.0)).xyz;
 	return out;
 }
 
 @fragment
 fn fs_main(in: VertexOutput) -> @location(0) vec4f {
-	let texColor = textureLoad(gradientTexture, vec2i(in.position.xy), 0).rgb;
-
 	let normal = normalize(in.normal);
 
 	let lightColor1 = vec3f(1.0, 0.9, 0.6);
@@ -44,11 +47,11 @@ fn fs_main(in: VertexOutput) -> @location(0) vec4f {
 	let shading1 = max(0.0, dot(lightDirection1, normal));
 	let shading2 = max(0.0, dot(lightDirection2, normal));
 	let shading = shading1 * lightColor1 + shading2 * lightColor2;
-	let color = texColor * shading;
+	let color = in.color * uUniforms.color.rgb * shading;
 
 	// We apply a gamma-correction to the color
 	// We need to convert our input sRGB color into linear before the target
 	// surface converts it back to sRGB.
-	let corrected_color = pow(color, vec3f(2.2));
+	let corrected_color = pow(color, vec3f(k_gamma));
 	return vec4f(corrected_color, uUniforms.color.a);
 }
@@ -0,0 +1,43 @@
+struct Animation {
+    startCoord: vec2f,
+    frameDim: vec2f,
+    currFrame: u32,
+    animId: u32,
+    _padding: vec2f,
+}
+
+struct SpriteAnimState {
+    clipLength: u32,
+    ticksPerFrame: u32,
+    phase: u32,
+    _padding: u32,
+}
+
+struct Tick {
+    tick: u32,
+    _padding0: u32,
+    _padding1: vec2u,
+}
+
+@group(0) @binding(0) var<storage, read> states: array<SpriteAnimState>;
+@group(0) @binding(1) var<uniform> uTick: Tick;
+//Same buffer quadShader.wgsl reads as animations, only the frame index is written
+@group(0) @binding(2) var<storage, read_write> animations: array<Animation>;
+
+//Set from Gfx::k_spriteAnimWorkgroupSize
+#ifndef k_spriteAnimWorkgroupSize
+#define k_spriteAnimWorkgroupSize 64
+#endif
+
+//Gfx::SpriteFrame is the cpu reference, integer only so both give the same frame.
+//Division by 0 gives the left hand side and modulo by 0 gives 0 in wgsl, the reference does the same
+@compute @workgroup_size(k_spriteAnimWorkgroupSize)
+fn cs_main(@builtin(global_invocation_id) id: vec3u) {
+    let sprite = id.x;
+    if (sprite >= arrayLength(&states)) {
+        return;
+    }
+
+    let state = states[sprite];
+    animations[sprite].currFrame = (uTick.tick / state.ticksPerFrame + state.phase) % state.clipLength;
+}
@@ -0,0 +1,44 @@
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) texCoord: vec2f,
+    @location(1) color: vec4f,
+};
+
+struct Glyph {
+    //x,y top left corner, z,w width and height, in pixels from the top left of the screen
+    rect: vec4f,
+    //u0,v0 top left, u1,v1 bottom right in the atlas
+    uvRect: vec4f,
+    color: vec4f,
+}
+
+struct Screen {
+    size: vec2f,
+    _padding: vec2f,
+}
+
+@group(0) @binding(0) var<storage, read> glyphs: array<Glyph>;
+@group(0) @binding(1) var atlas: texture_2d<f32>;
+@group(0) @binding(2) var atlasSampler: sampler;
+@group(0) @binding(3) var<uniform> uScreen: Screen;
+
+#include "quadCorners.wgsl"
+
+@vertex
+fn vs_main(@builtin(vertex_index) vertex: u32, @builtin(instance_index) instance: u32) -> VertexOutput {
+    var out: VertexOutput;
+    let glyph = glyphs[instance];
+    let corner = vec2f(f32((k_cornerMaskX >> vertex) & 1u), f32((k_cornerMaskY >> vertex) & 1u));
+    let pixel = glyph.rect.xy + corner * glyph.rect.zw;
+    //Pixels to NDC, y points down on screen
+    out.position = vec4f(pixel.x / uScreen.size.x * 2.0f - 1.0f, 1.0f - pixel.y / uScreen.size.y * 2.0f, 0.0f, 1.0f);
+    out.texCoord = mix(glyph.uvRect.xy, glyph.uvRect.zw, corner);
+    out.color = glyph.color;
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+    let coverage = textureSample(atlas, atlasSampler, in.texCoord).a;
+    return vec4f(in.color.rgb, in.color.a * coverage);
+}
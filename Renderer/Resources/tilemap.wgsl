@@ -0,0 +1,75 @@
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) ndc: vec2f,
+};
+
+struct Camera {
+    //x,y are camera center, z,w are camera extents (width, height)
+    posExtent: vec4f,
+}
+
+struct TileType {
+    startCoord: vec2f,
+    frameDim: vec2f,
+    animId: u32,
+    clipLength: u32,
+    ticksPerFrame: u32,
+    _padding: u32,
+}
+
+struct Tilemap {
+    //World position of the bottom left corner of cell (0, 0)
+    origin: vec2f,
+    cellSize: vec2f,
+    gridSize: vec2u,
+    tick: u32,
+    _padding: u32,
+}
+
+//One texel per cell, tile type in the low 16 bits and animation phase in the high 16
+@group(0) @binding(0) var tileIndices: texture_2d<u32>;
+@group(0) @binding(1) var<storage, read> tileTypes: array<TileType>;
+@group(0) @binding(2) var textures: texture_2d_array<f32>;
+@group(0) @binding(3) var txSampler: sampler;
+@group(0) @binding(4) var<uniform> uCamera: Camera;
+@group(0) @binding(5) var<uniform> uTilemap: Tilemap;
+
+const k_tileTypeMask = 0xFFFFu;
+const k_phaseShift = 16u;
+
+//One triangle covering the screen
+@vertex
+fn vs_main(@builtin(vertex_index) vertex: u32) -> VertexOutput {
+    var out: VertexOutput;
+    let uv = vec2f(f32((vertex << 1u) & 2u), f32(vertex & 2u));
+    out.position = vec4f(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, 0.0f, 1.0f);
+    out.ndc = out.position.xy;
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+    //Inverse of the view and projection in quadShader.wgsl
+    let world = in.ndc * uCamera.posExtent.zw + uCamera.posExtent.xy;
+    let grid = (world - uTilemap.origin) / uTilemap.cellSize;
+    if (any(grid < vec2f(0.0f)) || any(grid >= vec2f(uTilemap.gridSize))) {
+        discard;
+    }
+
+    let texel = textureLoad(tileIndices, vec2u(grid), 0).r;
+    let tile = tileTypes[texel & k_tileTypeMask];
+    //Same frame as cs_main in spriteAnim.wgsl gives the quads
+    let frame = (uTilemap.tick / tile.ticksPerFrame + (texel >> k_phaseShift)) % tile.clipLength;
+
+    //Same texture coordinates as vs_main_pulled and fs_main in quadShader.wgsl
+    let cellCoord = fract(grid);
+    let texCoord = vec2f(cellCoord.x, 1.0f - cellCoord.y);
+    let dims: vec2f = vec2f(textureDimensions(textures));
+    let offset: vec2f = vec2f(f32(frame) * tile.frameDim.x + tile.startCoord.x, tile.startCoord.y);
+    let spriteTexCoords: vec2f = texCoord * (tile.frameDim / dims) + offset / dims;
+
+    //Explicit level, the discard above makes this non uniform control flow
+    let color = textureSampleLevel(textures, txSampler, spriteTexCoords, tile.animId, 0.0f);
+    //gamma-correction
+    return vec4f(pow(color.xyz, vec3f(2.2)).xyz, color.a);
+}
@@ -0,0 +1,30 @@
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) texCoord: vec2f,
+};
+
+struct Params {
+    //Rendered region / source texture size
+    uvScale: vec2f,
+    //Last texel center inside the rendered region, keeps bilinear taps from reading past it
+    uvClamp: vec2f,
+}
+
+@group(0) @binding(0) var source: texture_2d<f32>;
+@group(0) @binding(1) var sourceSampler: sampler;
+@group(0) @binding(2) var<uniform> uParams: Params;
+
+//One triangle covering the screen, uv (0,0) top left
+@vertex
+fn vs_main(@builtin(vertex_index) vertex: u32) -> VertexOutput {
+    var out: VertexOutput;
+    let uv = vec2f(f32((vertex << 1u) & 2u), f32(vertex & 2u));
+    out.position = vec4f(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, 0.0f, 1.0f);
+    out.texCoord = uv * uParams.uvScale;
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+    return textureSample(source, sourceSampler, min(in.texCoord, uParams.uvClamp));
+}
@@ -0,0 +1,284 @@
+#include "ShaderCache.h"
+#include <iostream>
+#include <fstream>
+#include <string_view>
+#include <unordered_set>
+
+namespace
+{
+	//Includes nested deeper than this are assumed to be a mistake
+	constexpr uint32_t k_maxIncludeDepth = 16;
+
+	bool IsIdentifierStart(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+	}
+
+	bool IsIdentifierChar(char c)
+	{
+		return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+	}
+
+	std::string_view Trim(std::string_view text)
+	{
+		size_t first = text.find_first_not_of(" \t\r");
+		if (first == std::string_view::npos) return {};
+		size_t last = text.find_last_not_of(" \t\r");
+		return text.substr(first, last - first + 1);
+	}
+
+	//Splits off the first word, text is left with whatever follows it
+	std::string_view NextWord(std::string_view& text)
+	{
+		text = Trim(text);
+		size_t end = text.find_first_of(" \t");
+		std::string_view word = text.substr(0, end);
+		text = end == std::string_view::npos ? std::string_view{} : Trim(text.substr(end));
+		return word;
+	}
+}
+
+namespace Gfx
+{
+	struct ShaderCache::PreprocessState
+	{
+		struct Conditional
+		{
+			bool active; //This branch is being emitted
+			bool parentActive;
+			bool seenElse;
+		};
+
+		std::unordered_map<std::string, std::string> defines;
+		std::unordered_set<std::string> included;
+		std::vector<Conditional> conditionals;
+		std::string output;
+
+		bool Active() const { return conditionals.empty() || conditionals.back().active; }
+
+		//Whole words only, and never inside a // comment
+		void AppendLine(std::string_view line)
+		{
+			size_t i = 0;
+			while (i < line.size())
+			{
+				if (line[i] == '/' && i + 1 < line.size() && line[i + 1] == '/')
+				{
+					output.append(line.substr(i));
+					break;
+				}
+				if (!IsIdentifierStart(line[i]))
+				{
+					//Skip the whole number so suffixes like the u in 10u aren't read as identifiers
+					size_t start = i;
+					bool const number = line[i] >= '0' && line[i] <= '9';
+					++i;
+					while (number && i < line.size() && IsIdentifierChar(line[i])) ++i;
+					output.append(line.substr(start, i - start));
+					continue;
+				}
+
+				size_t start = i;
+				while (i < line.size() && IsIdentifierChar(line[i])) ++i;
+				std::string word(line.substr(start, i - start));
+				auto it = defines.find(word);
+				output.append(it != defines.end() ? it->second : word);
+			}
+			output.push_back('\n');
+		}
+	};
+
+	ShaderConstants::ShaderConstants(std::initializer_list<ShaderConstant> constants)
+		: _constants(constants)
+	{
+		Rebuild();
+	}
+
+	void ShaderConstants::Set(std::string const& name, double value)
+	{
+		for (ShaderConstant& constant : _constants)
+		{
+			if (constant.name == name)
+			{
+				constant.value = value;
+				Rebuild();
+				return;
+			}
+		}
+		_constants.push_back({ name, value });
+		Rebuild();
+	}
+
+	void ShaderConstants::Rebuild()
+	{
+		//Names can move when _constants grows so the entries are pointed at them again
+		_entries.resize(_constants.size());
+		for (size_t i = 0; i < _constants.size(); ++i)
+		{
+			_entries[i] = wgpu::ConstantEntry{};
+			_entries[i].nextInChain = nullptr;
+			_entries[i].key = _constants[i].name.c_str();
+			_entries[i].value = _constants[i].value;
+		}
+	}
+
+	ShaderCache::ShaderCache(Gfx::Device& device)
+		: _pDevice(&device)
+	{
+	}
+
+	ShaderCache::~ShaderCache()
+	{
+		for (auto& [source, module] : _modules) _pDevice->Release(module);
+	}
+
+	std::optional<wgpu::ShaderModule> ShaderCache::Load(std::filesystem::path const& path, std::span<ShaderDefine const> defines)
+	{
+		std::optional<std::string> oSource = Preprocess(path, defines);
+		if (!oSource) return std::nullopt;
+
+		if (auto it = _modules.find(*oSource); it != _modules.end())
+		{
+			++_stats.hits;
+			return it->second;
+		}
+
+		std::cout << "Compiling shader module: " << path << "\n";
+		std::string const label = path.filename().string();
+
+		wgpu::ShaderModuleWGSLDescriptor wgslDesc{};
+		wgslDesc.chain.next = nullptr;
+		wgslDesc.chain.sType = wgpu::SType::ShaderModuleWGSLDescriptor;
+		wgslDesc.code = oSource->c_str();
+
+		wgpu::ShaderModuleDescriptor desc{};
+		desc.hintCount = 0;
+		desc.hints = nullptr;
+		desc.label = label.c_str();
+		desc.nextInChain = &wgslDesc.chain;
+
+		wgpu::ShaderModule module = _pDevice->CreateShaderModule(desc);
+		if (!module) return std::nullopt;
+
+		++_stats.compiled;
+		_modules.emplace(std::move(*oSource), module);
+		return module;
+	}
+
+	std::optional<std::string> ShaderCache::Preprocess(std::filesystem::path const& path, std::span<ShaderDefine const> defines)
+	{
+		PreprocessState state;
+		for (ShaderDefine const& define : defines) state.defines[define.name] = define.value;
+
+		if (!PreprocessFile(path, state, 0)) return std::nullopt;
+		if (!state.conditionals.empty())
+		{
+			std::cout << "Shader preprocess error: " << path << " missing #endif\n";
+			return std::nullopt;
+		}
+		return std::move(state.output);
+	}
+
+	std::string const* ShaderCache::ReadSource(std::filesystem::path const& path)
+	{
+		std::string key = path.lexically_normal().string();
+		if (auto it = _sources.find(key); it != _sources.end()) return &it->second;
+
+		std::ifstream file(path, std::ios::binary);
+		if (file.fail())
+		{
+			std::cout << "Error Loading Shader: " << path << "\n";
+			return nullptr;
+		}
+
+		file.seekg(0, std::ios::end);
+		size_t size = file.tellg();
+		std::string source(size, ' ');
+		file.seekg(0);
+		file.read(source.data(), size);
+
+		++_stats.filesRead;
+		return &_sources.emplace(std::move(key), std::move(source)).first->second;
+	}
+
+	bool ShaderCache::PreprocessFile(std::filesystem::path const& path, PreprocessState& state, uint32_t depth)
+	{
+		if (depth > k_maxIncludeDepth)
+		{
+			std::cout << "Shader preprocess error: " << path << " includes nested too deep\n";
+			return false;
+		}
+		//Pasted once, so shared files don't need guards and cycles stop here
+		if (!state.included.insert(path.lexically_normal().string()).second) return true;
+
+		std::string const* pSource = ReadSource(path);
+		if (!pSource) return false;
+
+		auto fail = [&](uint32_t lineNumber, char const* message) {
+			std::cout << "Shader preprocess error: " << path << ":" << lineNumber << " " << message << "\n";
+			return false;
+		};
+
+		std::string_view source = *pSource;
+		uint32_t lineNumber = 0;
+		while (!source.empty())
+		{
+			size_t end = source.find('\n');
+			std::string_view line = source.substr(0, end);
+			source = end == std::string_view::npos ? std::string_view{} : source.substr(end + 1);
+			++lineNumber;
+
+			std::string_view directive = Trim(line);
+			if (directive.empty() || directive[0] != '#')
+			{
+				if (state.Active()) state.AppendLine(line);
+				continue;
+			}
+
+			directive.remove_prefix(1);
+			std::string_view const command = NextWord(directive);
+			if (command == "ifdef" || command == "ifndef")
+			{
+				std::string_view const name = NextWord(directive);
+				if (name.empty()) return fail(lineNumber, "expected a name");
+				bool const defined = state.defines.contains(std::string(name));
+				bool const parentActive = state.Active();
+				state.conditionals.push_back({ parentActive && (defined == (command == "ifdef")), parentActive, false });
+			}
+			else if (command == "else")
+			{
+				if (state.conditionals.empty() || state.conditionals.back().seenElse) return fail(lineNumber, "unexpected #else");
+				PreprocessState::Conditional& conditional = state.conditionals.back();
+				conditional.active = conditional.parentActive && !conditional.active;
+				conditional.seenElse = true;
+			}
+			else if (command == "endif")
+			{
+				if (state.conditionals.empty()) return fail(lineNumber, "unexpected #endif");
+				state.conditionals.pop_back();
+			}
+			else if (!state.Active())
+			{
+				//Anything else only matters in an emitted branch
+				continue;
+			}
+			else if (command == "define")
+			{
+				std::string_view const name = NextWord(directive);
+				if (name.empty() || !IsIdentifierStart(name[0])) return fail(lineNumber, "expected a name");
+				state.defines[std::string(name)] = std::string(directive);
+			}
+			else if (command == "include")
+			{
+				if (directive.size() < 2 || directive.front() != '"' || directive.back() != '"') return fail(lineNumber, "expected #include \"file\"");
+				std::filesystem::path const includePath = path.parent_path() / directive.substr(1, directive.size() - 2);
+				if (!PreprocessFile(includePath, state, depth + 1)) return fail(lineNumber, "included from here");
+			}
+			else
+			{
+				return fail(lineNumber, "unknown directive");
+			}
+		}
+		return true;
+	}
+}
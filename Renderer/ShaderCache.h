@@ -0,0 +1,85 @@
+#pragma once
+#include <optional>
+#include <filesystem>
+#include <span>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "webgpu.h"
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	//Replaces every whole word NAME in the source with value, like a C object macro
+	struct ShaderDefine
+	{
+		std::string name;
+		std::string value;
+	};
+
+	//Value for an `override` declaration in the shader, applied when the pipeline is created
+	struct ShaderConstant
+	{
+		std::string name;
+		double value = 0.0;
+	};
+
+	//Keeps the constant names alive for the entries a pipeline stage points at
+	class ShaderConstants {
+	public:
+		ShaderConstants() = default;
+		ShaderConstants(std::initializer_list<ShaderConstant> constants);
+
+		void Set(std::string const& name, double value);
+
+		inline uint32_t Count() const noexcept { return (uint32_t)_entries.size(); }
+		inline wgpu::ConstantEntry const* Data() const noexcept { return _entries.empty() ? nullptr : _entries.data(); }
+
+	private:
+		void Rebuild();
+
+		std::vector<ShaderConstant> _constants;
+		std::vector<wgpu::ConstantEntry> _entries;
+	};
+
+	struct ShaderCacheStats
+	{
+		uint32_t compiled = 0;
+		uint32_t hits = 0; //Variants whose preprocessed source was already compiled
+		uint32_t filesRead = 0;
+	};
+
+	//WGSL front end. Sources can use
+	//	#include "file.wgsl"	relative to the including file, each file is pasted once per variant
+	//	#define NAME value
+	//	#ifdef NAME / #ifndef NAME / #else / #endif
+	//Files are read once and modules are cached by their preprocessed source, so identical variants compile once.
+	//The cache owns the modules, it has to outlive any pipeline creation that uses them
+	class ShaderCache {
+	public:
+		explicit ShaderCache(Gfx::Device& device);
+		~ShaderCache();
+
+		std::optional<wgpu::ShaderModule> Load(std::filesystem::path const& path, std::span<ShaderDefine const> defines = {});
+		std::optional<std::string> Preprocess(std::filesystem::path const& path, std::span<ShaderDefine const> defines = {});
+
+		inline ShaderCacheStats const& Stats() const noexcept { return _stats; }
+
+	private:
+		//No copy, move
+		ShaderCache(ShaderCache const& other) = delete;
+		ShaderCache(ShaderCache&& other) = delete;
+		ShaderCache& operator=(ShaderCache const& other) = delete;
+		ShaderCache& operator=(ShaderCache&& other) = delete;
+
+		struct PreprocessState;
+		std::string const* ReadSource(std::filesystem::path const& path);
+		bool PreprocessFile(std::filesystem::path const& path, PreprocessState& state, uint32_t depth);
+
+		Gfx::Device* _pDevice;
+		std::unordered_map<std::string, std::string> _sources;
+		std::unordered_map<std::string, wgpu::ShaderModule> _modules; //Keyed by the whole source so a hash collision can't alias two variants
+		ShaderCacheStats _stats;
+	};
+}
@@ -0,0 +1,102 @@
+#include "Simulation.h"
+#include "Profiler.h"
+
+SimulationThread::SimulationThread(SimulationStep step, SnapshotWriter writeSnapshot, InputQueue* pInput, Clock::Duration fixedStep)
+	: _step(std::move(step))
+	, _writeSnapshot(std::move(writeSnapshot))
+	, _clock(fixedStep)
+	, _fixedStep(fixedStep)
+	, _pInput(pInput)
+	, _stopping(false)
+	, _steps(0)
+	, _droppedSteps(0)
+	, _published(0)
+	, _inputEvents(0)
+	, _inputLatencyMs(0.f)
+{
+	if (_pInput) _input.reserve(k_inputQueueCapacity);
+	Publish(0, 0.f);
+	_thread = std::thread(&SimulationThread::Run, this);
+}
+
+SimulationThread::~SimulationThread()
+{
+	_stopping = true;
+	_thread.join();
+}
+
+FrameSnapshot const& SimulationThread::Latest()
+{
+	_snapshots.Acquire();
+	return _snapshots.Front();
+}
+
+SimulationStats SimulationThread::Stats() const
+{
+	SimulationStats stats;
+	stats.steps = _steps.load(std::memory_order_relaxed);
+	stats.droppedSteps = _droppedSteps.load(std::memory_order_relaxed);
+	stats.published = _published.load(std::memory_order_relaxed);
+	stats.inputEvents = _inputEvents.load(std::memory_order_relaxed);
+	stats.inputLatencyMs = _inputLatencyMs.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void SimulationThread::Publish(uint64_t step, float time)
+{
+	FrameSnapshot& snapshot = _snapshots.Back();
+	_writeSnapshot(snapshot);
+	snapshot.step = step;
+	snapshot.time = time;
+	_snapshots.Publish();
+	_published.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SimulationThread::Run()
+{
+	while (!_stopping.load(std::memory_order_relaxed))
+	{
+		Clock::TimePoint const now = Clock::Clock::now();
+		uint32_t const steps = _clock.Tick(now);
+		if (steps > 0)
+		{
+			PROFILE_SCOPE("Simulation Steps");
+			RunSteps(steps, now);
+			Publish(_clock.Steps(), (float)_clock.Steps() * _clock.FixedDelta());
+			_steps.store(_clock.Steps(), std::memory_order_relaxed);
+			_droppedSteps.store(_clock.DroppedSteps(), std::memory_order_relaxed);
+		}
+
+		//Sleep until the next step is due
+		float const untilNextStep = (1.f - _clock.Alpha()) * _clock.FixedDelta();
+		std::this_thread::sleep_for(std::chrono::duration<float>(untilNextStep));
+	}
+}
+
+void SimulationThread::RunSteps(uint32_t steps, Clock::TimePoint now)
+{
+	//Only the events queued so far, anything pushed while stepping waits for the next batch
+	_input.clear();
+	InputEvent event;
+	while (_input.size() < k_inputQueueCapacity && _pInput && _pInput->Pop(event)) _input.push_back(event);
+
+	//A batch catches up on time that has already passed, step i stands for roughly the fixed step ending (steps - 1 - i)
+	//steps before now. Each event goes to the step covering the moment it arrived, the last step takes whatever is left
+	std::span<InputEvent const> pending = _input;
+	for (uint32_t i = 0; i < steps; ++i)
+	{
+		Clock::TimePoint const stepEnd = now - (steps - 1 - i) * _fixedStep;
+		size_t count = 0;
+		while (count < pending.size() && (i + 1 == steps || pending[count].time <= stepEnd)) ++count;
+
+		_step(_clock.Steps() - steps + i, _clock.FixedDelta(), pending.first(count));
+		pending = pending.subspan(count);
+	}
+
+	if (!_input.empty())
+	{
+		std::chrono::duration<float, std::milli> const latency = Clock::Clock::now() - _input.back().time;
+		_inputEvents.fetch_add(_input.size(), std::memory_order_relaxed);
+		_inputLatencyMs.store(latency.count(), std::memory_order_relaxed);
+	}
+}
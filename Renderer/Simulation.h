@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <thread>
+#include <vector>
+#include "MathDefs.h"
+#include "Chrono.h"
+#include "TripleBuffer.h"
+#include "InputEvents.h"
+
+//Everything the render thread needs from one simulation state. Immutable once published
+struct FrameSnapshot
+{
+	uint64_t step = 0; //Fixed steps simulated when it was taken
+	float time = 0.f; //Simulated seconds, step * fixed delta
+	uint32_t animTick = 0; //Terrain::AnimTick
+	std::vector<Mat4f> meshModels;
+};
+
+struct SimulationStats
+{
+	uint64_t steps = 0;
+	uint64_t droppedSteps = 0; //Skipped by the catch up cap after a stall
+	uint64_t published = 0;
+	uint64_t inputEvents = 0;
+	float inputLatencyMs = 0.f; //From the window callback to the step that handled it, newest event
+};
+
+//Runs on the simulation thread once per fixed step, input is the events that arrived during the step in arrival order
+using SimulationStep = std::function<void(uint64_t step, float fixedDelta, std::span<InputEvent const> input)>;
+//Fills the snapshot published after a batch of steps. It holds an older snapshot, so every field has to be written
+using SnapshotWriter = std::function<void(FrameSnapshot& snapshot)>;
+
+//Fixed step simulation on its own thread. After each batch of steps it publishes a FrameSnapshot through a triple buffer,
+//the render thread takes the newest one without waiting, so a slow tick delays the content of a frame but never the frame.
+//All simulation state has to be touched only from the callbacks while this is alive
+class SimulationThread {
+public:
+	//Publishes the state at step 0 before the thread starts, so Latest always has something.
+	//Events from pInput are drained before every batch of steps, it has to outlive this
+	SimulationThread(SimulationStep step, SnapshotWriter writeSnapshot, InputQueue* pInput = nullptr, Clock::Duration fixedStep = Clock::k_fixedStep);
+	~SimulationThread();
+
+	//Render thread only. Stays valid until the next call
+	FrameSnapshot const& Latest();
+
+	SimulationStats Stats() const;
+
+private:
+	//No copy, move
+	SimulationThread(SimulationThread const& other) = delete;
+	SimulationThread(SimulationThread&& other) = delete;
+	SimulationThread& operator=(SimulationThread const& other) = delete;
+	SimulationThread& operator=(SimulationThread&& other) = delete;
+
+	void Run();
+	void Publish(uint64_t step, float time);
+	void RunSteps(uint32_t steps, Clock::TimePoint now);
+
+	SimulationStep _step;
+	SnapshotWriter _writeSnapshot;
+	//Its own accumulator rather than Clock::Get(), which the render thread ticks per frame. Both tick on the same
+	//steady clock, so step times and input event times compare with the render thread's
+	Clock::FrameClock _clock;
+	Clock::Duration _fixedStep;
+	InputQueue* _pInput;
+	std::vector<InputEvent> _input; //Reserved up front so draining never allocates
+	TripleBuffer<FrameSnapshot> _snapshots;
+
+	std::atomic<bool> _stopping;
+	std::atomic<uint64_t> _steps;
+	std::atomic<uint64_t> _droppedSteps;
+	std::atomic<uint64_t> _published;
+	std::atomic<uint64_t> _inputEvents;
+	std::atomic<float> _inputLatencyMs;
+	std::thread _thread;
+};
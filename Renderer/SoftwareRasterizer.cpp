@@ -0,0 +1,532 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr uint32_t k_quadsPerTileRow = Gfx::k_rasterTileSize / 2;
+	constexpr uint32_t k_tilePixels = Gfx::k_rasterTileSize * Gfx::k_rasterTileSize;
+	static_assert(Gfx::k_rasterTileSize % 2 == 0);
+
+	//Same corners and triangles as Gfx::Quad / vs_main_pulled, uv = (x, 1 - y)
+	constexpr std::array<std::array<float, 2>, 6> k_quadCorners = { {
+		{0.f, 0.f}, {1.f, 0.f}, {1.f, 1.f},
+		{1.f, 1.f}, {0.f, 1.f}, {0.f, 0.f},
+	} };
+
+	//4 lanes, one per pixel of a 2x2 quad: (0,0) (1,0) (0,1) (1,1)
+#ifdef RASTER_SSE2
+	struct F4 { __m128 v; };
+	struct M4 { __m128 v; };
+
+	inline F4 Set(float a) { return { _mm_set1_ps(a) }; }
+	inline F4 Set(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+	inline F4 Load(float const* p) { return { _mm_loadu_ps(p) }; }
+	inline void Store(float* p, F4 a) { _mm_storeu_ps(p, a.v); }
+	inline F4 operator+(F4 a, F4 b) { return { _mm_add_ps(a.v, b.v) }; }
+	inline F4 operator-(F4 a, F4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+	inline F4 operator*(F4 a, F4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+	inline M4 operator<(F4 a, F4 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+	inline M4 operator<=(F4 a, F4 b) { return { _mm_cmple_ps(a.v, b.v) }; }
+	inline M4 operator>(F4 a, F4 b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+	inline M4 operator>=(F4 a, F4 b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+	inline M4 operator&(M4 a, M4 b) { return { _mm_and_ps(a.v, b.v) }; }
+	inline F4 Select(M4 m, F4 a, F4 b) { return { _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)) }; }
+	inline uint32_t Bits(M4 m) { return (uint32_t)_mm_movemask_ps(m.v); }
+
+	inline void LoadColor(uint32_t const* p, F4& r, F4& g, F4& b, F4& a)
+	{
+		__m128i packed = _mm_loadu_si128((__m128i const*)p);
+		__m128i byteMask = _mm_set1_epi32(0xFF);
+		__m128 scale = _mm_set1_ps(1.f / 255.f);
+		r = { _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, byteMask)), scale) };
+		g = { _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 8), byteMask)), scale) };
+		b = { _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 16), byteMask)), scale) };
+		a = { _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(packed, 24)), scale) };
+	}
+
+	//Unorm conversion, rounds to nearest
+	inline void StoreColor(uint32_t* p, M4 mask, F4 r, F4 g, F4 b, F4 a)
+	{
+		auto toByte = [](F4 c) {
+			return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(c.v, _mm_setzero_ps()), _mm_set1_ps(1.f)), _mm_set1_ps(255.f)));
+		};
+		__m128i packed = _mm_or_si128(
+			_mm_or_si128(toByte(r), _mm_slli_epi32(toByte(g), 8)),
+			_mm_or_si128(_mm_slli_epi32(toByte(b), 16), _mm_slli_epi32(toByte(a), 24)));
+		__m128i old = _mm_loadu_si128((__m128i const*)p);
+		__m128i laneMask = _mm_castps_si128(mask.v);
+		_mm_storeu_si128((__m128i*)p, _mm_or_si128(_mm_and_si128(laneMask, packed), _mm_andnot_si128(laneMask, old)));
+	}
+#else
+	struct F4 { std::array<float, 4> v; };
+	struct M4 { std::array<bool, 4> v; };
+
+	template<typename Op>
+	inline F4 Map(F4 a, F4 b, Op op) { return { op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]) }; }
+	template<typename Op>
+	inline M4 Compare(F4 a, F4 b, Op op) { return { op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]) }; }
+
+	inline F4 Set(float a) { return { a, a, a, a }; }
+	inline F4 Set(float a, float b, float c, float d) { return { a, b, c, d }; }
+	inline F4 Load(float const* p) { return { p[0], p[1], p[2], p[3] }; }
+	inline void Store(float* p, F4 a) { std::copy(a.v.begin(), a.v.end(), p); }
+	inline F4 operator+(F4 a, F4 b) { return Map(a, b, [](float x, float y) { return x + y; }); }
+	inline F4 operator-(F4 a, F4 b) { return Map(a, b, [](float x, float y) { return x - y; }); }
+	inline F4 operator*(F4 a, F4 b) { return Map(a, b, [](float x, float y) { return x * y; }); }
+	inline M4 operator<(F4 a, F4 b) { return Compare(a, b, [](float x, float y) { return x < y; }); }
+	inline M4 operator<=(F4 a, F4 b) { return Compare(a, b, [](float x, float y) { return x <= y; }); }
+	inline M4 operator>(F4 a, F4 b) { return Compare(a, b, [](float x, float y) { return x > y; }); }
+	inline M4 operator>=(F4 a, F4 b) { return Compare(a, b, [](float x, float y) { return x >= y; }); }
+	inline M4 operator&(M4 a, M4 b) { return { a.v[0] && b.v[0], a.v[1] && b.v[1], a.v[2] && b.v[2], a.v[3] && b.v[3] }; }
+	inline F4 Select(M4 m, F4 a, F4 b) { return { m.v[0] ? a.v[0] : b.v[0], m.v[1] ? a.v[1] : b.v[1], m.v[2] ? a.v[2] : b.v[2], m.v[3] ? a.v[3] : b.v[3] }; }
+	inline uint32_t Bits(M4 m) { return (uint32_t)m.v[0] | (uint32_t)m.v[1] << 1 | (uint32_t)m.v[2] << 2 | (uint32_t)m.v[3] << 3; }
+
+	inline void LoadColor(uint32_t const* p, F4& r, F4& g, F4& b, F4& a)
+	{
+		for (uint32_t lane = 0; lane < 4; ++lane)
+		{
+			r.v[lane] = (float)(p[lane] & 0xFF) / 255.f;
+			g.v[lane] = (float)((p[lane] >> 8) & 0xFF) / 255.f;
+			b.v[lane] = (float)((p[lane] >> 16) & 0xFF) / 255.f;
+			a.v[lane] = (float)(p[lane] >> 24) / 255.f;
+		}
+	}
+
+	inline void StoreColor(uint32_t* p, M4 mask, F4 r, F4 g, F4 b, F4 a)
+	{
+		auto toByte = [](float c) { return (uint32_t)std::nearbyint(std::clamp(c, 0.f, 1.f) * 255.f); };
+		for (uint32_t lane = 0; lane < 4; ++lane)
+		{
+			if (!mask.v[lane]) continue;
+			p[lane] = toByte(r.v[lane]) | toByte(g.v[lane]) << 8 | toByte(b.v[lane]) << 16 | toByte(a.v[lane]) << 24;
+		}
+	}
+#endif
+
+	template<typename Fn>
+	inline F4 PerLane(F4 a, Fn fn)
+	{
+		alignas(16) float values[4];
+		Store(values, a);
+		for (float& value : values) value = fn(value);
+		return Load(values);
+	}
+
+	inline float SrgbToLinear(float c)
+	{
+		return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+	}
+
+	inline float LinearToSrgb(float c)
+	{
+		c = std::clamp(c, 0.f, 1.f);
+		return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+	}
+
+	inline float Orient(float ax, float ay, float bx, float by, float cx, float cy)
+	{
+		return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+	}
+
+	//Pixel centers are inside when strictly inside an edge, or exactly on a top or left edge
+	inline M4 Covered(F4 w, bool topLeft)
+	{
+		return topLeft ? w >= Set(0.f) : w > Set(0.f);
+	}
+
+	inline F4 Plane(float const (&plane)[3], F4 px, F4 py)
+	{
+		return Set(plane[0]) * px + Set(plane[1]) * py + Set(plane[2]);
+	}
+
+	inline Vec4f FetchTexel(TextureResource const& texture, int32_t x, int32_t y)
+	{
+		x = std::clamp(x, 0, (int32_t)texture.width - 1);
+		y = std::clamp(y, 0, (int32_t)texture.height - 1);
+		std::byte const* pTexel = texture.data.data() + ((size_t)y * texture.width + x) * texture.numChannels;
+
+		Vec4f texel{ 0.f, 0.f, 0.f, 1.f };
+		for (uint32_t c = 0; c < std::min<uint32_t>(texture.numChannels, 4); ++c) texel[c] = (float)std::to_integer<uint8_t>(pTexel[c]) / 255.f;
+		return texel;
+	}
+
+	//Linear min/mag filter, clamp to edge, single mip
+	Vec4f SampleBilinear(TextureResource const& texture, float s, float t)
+	{
+		float x = s * (float)texture.width - 0.5f;
+		float y = t * (float)texture.height - 0.5f;
+		float x0 = std::floor(x);
+		float y0 = std::floor(y);
+		float fx = x - x0;
+		float fy = y - y0;
+		int32_t ix = (int32_t)std::clamp(x0, -1.f, (float)texture.width);
+		int32_t iy = (int32_t)std::clamp(y0, -1.f, (float)texture.height);
+
+		Vec4f top = FetchTexel(texture, ix, iy) * (1.f - fx) + FetchTexel(texture, ix + 1, iy) * fx;
+		Vec4f bottom = FetchTexel(texture, ix, iy + 1) * (1.f - fx) + FetchTexel(texture, ix + 1, iy + 1) * fx;
+		return top * (1.f - fy) + bottom * fy;
+	}
+
+	//Tile pixels are stored a 2x2 quad at a time so every lane load is contiguous
+	inline size_t SwizzledIndex(uint32_t x, uint32_t y)
+	{
+		return ((size_t)(y / 2) * k_quadsPerTileRow + x / 2) * 4 + (y & 1) * 2 + (x & 1);
+	}
+
+	//One per worker, carved out of the draw's scratch memory before the workers start
+	struct TileScratch
+	{
+		uint32_t* color;
+		float* depth;
+	};
+}
+
+namespace Gfx
+{
+	void RasterTarget::Resize(uint32_t newWidth, uint32_t newHeight)
+	{
+		width = newWidth;
+		height = newHeight;
+		color.resize((size_t)width * height);
+		depth.resize((size_t)width * height);
+	}
+
+	void RasterTarget::Clear(Vec4f clearColor, float clearDepth)
+	{
+		auto toByte = [this](float c, bool isAlpha) {
+			if (srgb && !isAlpha) c = LinearToSrgb(c);
+			return (uint32_t)std::nearbyint(std::clamp(c, 0.f, 1.f) * 255.f);
+		};
+		uint32_t packed = toByte(clearColor.x, false) | toByte(clearColor.y, false) << 8 | toByte(clearColor.z, false) << 16 | toByte(clearColor.w, true) << 24;
+		std::fill(color.begin(), color.end(), packed);
+		std::fill(depth.begin(), depth.end(), clearDepth);
+	}
+
+	TextureResource RasterTarget::ToTextureResource(std::string const& label) const
+	{
+		TextureResource result{ width, height, 1, 4, {}, label };
+		result.data.resize(result.SizeBytes());
+		for (size_t i = 0; i < color.size(); ++i)
+		{
+			for (uint32_t c = 0; c < 4; ++c) result.data[i * 4 + c] = (std::byte)(color[i] >> (c * 8));
+		}
+		return result;
+	}
+
+	SoftwareRasterizer::SoftwareRasterizer(Jobs::JobSystem* pJobs)
+		: _pJobs(pJobs)
+	{
+	}
+
+	void SoftwareRasterizer::DrawQuads(QuadRasterInput const& input, RasterTarget& target, std::pmr::memory_resource* pScratch)
+	{
+		assert(!input.layers.empty() && "Quads sample a texture array, at least one layer is needed");
+		assert(target.color.size() == (size_t)target.width * target.height);
+		if (input.layers.empty() || target.width == 0 || target.height == 0) return;
+
+		SetupTriangles(input, target);
+		RasterizeTiles(input, target, pScratch ? pScratch : std::pmr::get_default_resource());
+	}
+
+	void SoftwareRasterizer::SetupTriangles(QuadRasterInput const& input, RasterTarget const& target)
+	{
+		uint32_t tilesX = (target.width + k_rasterTileSize - 1) / k_rasterTileSize;
+		uint32_t tilesY = (target.height + k_rasterTileSize - 1) / k_rasterTileSize;
+		_tileBins.resize((size_t)tilesX * tilesY);
+		for (auto& bin : _tileBins) bin.clear();
+		_triangles.clear();
+
+		float const width = (float)target.width;
+		float const height = (float)target.height;
+		//textureDimensions(textures) is the size of the array, i.e. of every layer
+		Vec2f const dims{ (float)input.layers[0].width, (float)input.layers[0].height };
+		CamUniforms const& camera = input.camera;
+
+		for (uint32_t instance : input.instances)
+		{
+			QuadTransform const& transform = input.transforms[instance];
+			AnimUniform const& anim = input.animations[instance];
+
+			//fs_main sprite lookup, constant per instance so it's folded into the uv planes
+			Vec2f offset{ (float)anim.currentFrameIndex * anim.frameDimensions.x + anim.startCoord.x, anim.startCoord.y };
+			Vec2f normOffset = offset / dims;
+			Vec2f spriteDim = anim.frameDimensions / dims;
+			//Out of range array layers are clamped
+			uint32_t layer = std::min<uint32_t>(anim.animId, (uint32_t)input.layers.size() - 1);
+
+			for (uint32_t first = 0; first < k_quadCorners.size(); first += 3)
+			{
+				float x[3], y[3], z[3], s[3], t[3];
+				for (uint32_t v = 0; v < 3; ++v)
+				{
+					auto const& corner = k_quadCorners[first + v];
+					//vs_main: model, view, ndc
+					float ndcX = (transform.position.x + transform.scale.x * corner[0] - camera.position.x) / camera.extents.x;
+					float ndcY = (transform.position.y + transform.scale.y * corner[1] - camera.position.y) / camera.extents.y;
+					//Viewport, y points down in framebuffer space
+					x[v] = (ndcX * 0.5f + 0.5f) * width;
+					y[v] = (0.5f - ndcY * 0.5f) * height;
+					z[v] = transform.position.z;
+					s[v] = corner[0] * spriteDim.x + normOffset.x;
+					t[v] = (1.f - corner[1]) * spriteDim.y + normOffset.y;
+				}
+
+				float area = Orient(x[0], y[0], x[1], y[1], x[2], y[2]);
+				if (area == 0.f || !std::isfinite(area)) continue;
+				//No culling, flip clockwise triangles so every edge function is positive inside
+				if (area < 0.f)
+				{
+					std::swap(x[1], x[2]); std::swap(y[1], y[2]); std::swap(z[1], z[2]);
+					std::swap(s[1], s[2]); std::swap(t[1], t[2]);
+					area = -area;
+				}
+
+				Triangle tri;
+				tri.layer = layer;
+				for (uint32_t edge = 0; edge < 3; ++edge)
+				{
+					//Edge opposite vertex edge, from a to b
+					uint32_t a = (edge + 1) % 3;
+					uint32_t b = (edge + 2) % 3;
+					float (&plane)[3] = tri.edges[edge];
+					plane[0] = y[a] - y[b];
+					plane[1] = x[b] - x[a];
+					plane[2] = -(plane[0] * x[a] + plane[1] * y[a]);
+					tri.topLeft[edge] = plane[0] > 0.f || (plane[0] == 0.f && plane[1] > 0.f);
+				}
+
+				auto setupPlane = [&](float const (&values)[3], float (&plane)[3]) {
+					float d1 = values[1] - values[0];
+					float d2 = values[2] - values[0];
+					for (uint32_t i = 0; i < 3; ++i) plane[i] = (d1 * tri.edges[1][i] + d2 * tri.edges[2][i]) / area;
+					plane[2] += values[0];
+				};
+				setupPlane(z, tri.z);
+				setupPlane(s, tri.s);
+				setupPlane(t, tri.t);
+
+				float minX = std::clamp(std::min({ x[0], x[1], x[2] }), 0.f, width);
+				float maxX = std::clamp(std::max({ x[0], x[1], x[2] }), 0.f, width);
+				float minY = std::clamp(std::min({ y[0], y[1], y[2] }), 0.f, height);
+				float maxY = std::clamp(std::max({ y[0], y[1], y[2] }), 0.f, height);
+				tri.xBegin = (uint32_t)std::floor(minX);
+				tri.xEnd = (uint32_t)std::ceil(maxX);
+				tri.yBegin = (uint32_t)std::floor(minY);
+				tri.yEnd = (uint32_t)std::ceil(maxY);
+				if (tri.xBegin >= tri.xEnd || tri.yBegin >= tri.yEnd) continue;
+
+				uint32_t triangleId = (uint32_t)_triangles.size();
+				_triangles.push_back(tri);
+				for (uint32_t tileY = tri.yBegin / k_rasterTileSize; tileY <= (tri.yEnd - 1) / k_rasterTileSize; ++tileY)
+				{
+					for (uint32_t tileX = tri.xBegin / k_rasterTileSize; tileX <= (tri.xEnd - 1) / k_rasterTileSize; ++tileX)
+					{
+						_tileBins[(size_t)tileY * tilesX + tileX].push_back(triangleId);
+					}
+				}
+			}
+		}
+	}
+
+	void SoftwareRasterizer::RasterizeTiles(QuadRasterInput const& input, RasterTarget& target, std::pmr::memory_resource* pScratch)
+	{
+		uint32_t tilesX = (target.width + k_rasterTileSize - 1) / k_rasterTileSize;
+		uint32_t tileCount = (uint32_t)_tileBins.size();
+		//One slice per worker, each with its own tile buffers, pulling tiles until none are left
+		uint32_t sliceCount = std::min(_pJobs ? _pJobs->WorkerCount() : 1u, tileCount);
+		std::atomic<uint32_t> nextTile = 0;
+
+		//Scratch memory resources aren't expected to be thread safe so everything is allocated here
+		std::pmr::vector<uint32_t> scratchColor((size_t)sliceCount * k_tilePixels, pScratch);
+		std::pmr::vector<float> scratchDepth((size_t)sliceCount * k_tilePixels, pScratch);
+
+		F4 const laneX = Set(0.5f, 1.5f, 0.5f, 1.5f);
+		F4 const laneY = Set(0.5f, 0.5f, 1.5f, 1.5f);
+		F4 const targetWidth = Set((float)target.width);
+		F4 const targetHeight = Set((float)target.height);
+
+		auto rasterizeSlice = [&](uint32_t slice) {
+			TileScratch scratch{ scratchColor.data() + (size_t)slice * k_tilePixels, scratchDepth.data() + (size_t)slice * k_tilePixels };
+			for (uint32_t tile = nextTile++; tile < tileCount; tile = nextTile++)
+			{
+				auto const& bin = _tileBins[tile];
+				if (bin.empty()) continue;
+
+				uint32_t tileX0 = (tile % tilesX) * k_rasterTileSize;
+				uint32_t tileY0 = (tile / tilesX) * k_rasterTileSize;
+				uint32_t tileX1 = std::min(tileX0 + k_rasterTileSize, target.width);
+				uint32_t tileY1 = std::min(tileY0 + k_rasterTileSize, target.height);
+
+				for (uint32_t y = tileY0; y < tileY1; ++y)
+				{
+					for (uint32_t x = tileX0; x < tileX1; ++x)
+					{
+						size_t local = SwizzledIndex(x - tileX0, y - tileY0);
+						scratch.color[local] = target.color[(size_t)y * target.width + x];
+						scratch.depth[local] = target.depth[(size_t)y * target.width + x];
+					}
+				}
+
+				for (uint32_t triangleId : bin)
+				{
+					Triangle const& tri = _triangles[triangleId];
+					TextureResource const& texture = input.layers[tri.layer];
+
+					//Tiles start on even pixels so quads never straddle two tiles
+					uint32_t xBegin = std::max(tri.xBegin, tileX0) & ~1u;
+					uint32_t yBegin = std::max(tri.yBegin, tileY0) & ~1u;
+					uint32_t xEnd = std::min(tri.xEnd, tileX1);
+					uint32_t yEnd = std::min(tri.yEnd, tileY1);
+
+					for (uint32_t y = yBegin; y < yEnd; y += 2)
+					{
+						F4 py = Set((float)y) + laneY;
+						for (uint32_t x = xBegin; x < xEnd; x += 2)
+						{
+							F4 px = Set((float)x) + laneX;
+
+							M4 mask = Covered(Plane(tri.edges[0], px, py), tri.topLeft[0])
+								& Covered(Plane(tri.edges[1], px, py), tri.topLeft[1])
+								& Covered(Plane(tri.edges[2], px, py), tri.topLeft[2])
+								& (px < targetWidth) & (py < targetHeight);
+							if (!Bits(mask)) continue;
+
+							//Depth clip, then depth compare Less with writes enabled
+							size_t local = SwizzledIndex(x - tileX0, y - tileY0);
+							F4 z = Plane(tri.z, px, py);
+							F4 depth = Load(&scratch.depth[local]);
+							mask = mask & (z >= Set(0.f)) & (z <= Set(1.f)) & (z < depth);
+							uint32_t bits = Bits(mask);
+							if (!bits) continue;
+							Store(&scratch.depth[local], Select(mask, z, depth));
+
+							//fs_main, sampling and the gamma pow run per covered lane
+							alignas(16) float s[4], t[4];
+							alignas(16) float srcR[4] = {}, srcG[4] = {}, srcB[4] = {}, srcA[4] = {};
+							Store(s, Plane(tri.s, px, py));
+							Store(t, Plane(tri.t, px, py));
+							for (uint32_t lane = 0; lane < 4; ++lane)
+							{
+								if (!(bits & (1u << lane))) continue;
+								Vec4f color = SampleBilinear(texture, s[lane], t[lane]);
+								srcR[lane] = std::pow(color.x, 2.2f);
+								srcG[lane] = std::pow(color.y, 2.2f);
+								srcB[lane] = std::pow(color.z, 2.2f);
+								srcA[lane] = color.w;
+							}
+
+							//Blend: color = src * srcAlpha + dst * (1 - dstAlpha), alpha = dst
+							F4 dstR, dstG, dstB, dstA;
+							LoadColor(&scratch.color[local], dstR, dstG, dstB, dstA);
+							if (target.srgb)
+							{
+								dstR = PerLane(dstR, SrgbToLinear);
+								dstG = PerLane(dstG, SrgbToLinear);
+								dstB = PerLane(dstB, SrgbToLinear);
+							}
+							F4 alpha = Load(srcA);
+							F4 dstFactor = Set(1.f) - dstA;
+							F4 outR = Load(srcR) * alpha + dstR * dstFactor;
+							F4 outG = Load(srcG) * alpha + dstG * dstFactor;
+							F4 outB = Load(srcB) * alpha + dstB * dstFactor;
+							if (target.srgb)
+							{
+								outR = PerLane(outR, LinearToSrgb);
+								outG = PerLane(outG, LinearToSrgb);
+								outB = PerLane(outB, LinearToSrgb);
+							}
+							StoreColor(&scratch.color[local], mask, outR, outG, outB, dstA);
+						}
+					}
+				}
+
+				for (uint32_t y = tileY0; y < tileY1; ++y)
+				{
+					for (uint32_t x = tileX0; x < tileX1; ++x)
+					{
+						size_t local = SwizzledIndex(x - tileX0, y - tileY0);
+						target.color[(size_t)y * target.width + x] = scratch.color[local];
+						target.depth[(size_t)y * target.width + x] = scratch.depth[local];
+					}
+				}
+			}
+		};
+
+		if (sliceCount <= 1)
+		{
+			rasterizeSlice(0);
+			return;
+		}
+		_pJobs->ParallelFor(sliceCount, 1, [&rasterizeSlice](uint32_t begin, uint32_t end) {
+			for (uint32_t slice = begin; slice < end; ++slice) rasterizeSlice(slice);
+		});
+	}
+
+	TextureResource MakeThumbnail(RasterTarget const& target, uint32_t maxSide)
+	{
+		uint32_t longest = std::max(target.width, target.height);
+		if (longest == 0 || maxSide == 0) return TextureResource{ 0, 0, 1, 4, {}, "thumbnail" };
+
+		float scale = std::min(1.f, (float)maxSide / (float)longest);
+		uint32_t width = std::max(1u, (uint32_t)((float)target.width * scale));
+		uint32_t height = std::max(1u, (uint32_t)((float)target.height * scale));
+
+		TextureResource result{ width, height, 1, 4, {}, "thumbnail" };
+		result.data.resize(result.SizeBytes());
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			uint32_t srcY0 = y * target.height / height;
+			uint32_t srcY1 = std::max(srcY0 + 1, (y + 1) * target.height / height);
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				uint32_t srcX0 = x * target.width / width;
+				uint32_t srcX1 = std::max(srcX0 + 1, (x + 1) * target.width / width);
+
+				std::array<uint32_t, 4> sum{};
+				for (uint32_t sy = srcY0; sy < srcY1; ++sy)
+				{
+					for (uint32_t sx = srcX0; sx < srcX1; ++sx)
+					{
+						uint32_t texel = target.color[(size_t)sy * target.width + sx];
+						for (uint32_t c = 0; c < 4; ++c) sum[c] += (texel >> (c * 8)) & 0xFF;
+					}
+				}
+
+				uint32_t count = (srcX1 - srcX0) * (srcY1 - srcY0);
+				for (uint32_t c = 0; c < 4; ++c) result.data[((size_t)y * width + x) * 4 + c] = (std::byte)((sum[c] + count / 2) / count);
+			}
+		}
+		return result;
+	}
+
+	uint32_t MaxChannelDifference(RasterTarget const& target, TextureResource const& golden)
+	{
+		if (golden.width != target.width || golden.height != target.height || golden.numChannels != 4 || golden.channelDepthBytes != 1)
+		{
+			return std::numeric_limits<uint32_t>::max();
+		}
+
+		uint32_t maxDifference = 0;
+		for (size_t i = 0; i < target.color.size(); ++i)
+		{
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				int32_t value = (int32_t)((target.color[i] >> (c * 8)) & 0xFF);
+				int32_t expected = std::to_integer<int32_t>(golden.data[i * 4 + c]);
+				maxDifference = std::max(maxDifference, (uint32_t)std::abs(value - expected));
+			}
+		}
+		return maxDifference;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+#include "MathDefs.h"
+#include "QuadDefs.h"
+#include "ResourceDefs.h"
+#include "JobSystem.h"
+
+//CPU reference of the quad pipeline: vs_main/fs_main in quadShader.wgsl with the sprite sampler (bilinear, clamp to edge),
+//depth state and blend state main sets up. Used to validate gpu output against golden images and to render thumbnails offline
+namespace Gfx
+{
+	constexpr uint32_t k_rasterTileSize = 64; //Pixels per tile side, must be even
+
+	//Color + depth target, color is RGBA8 with red in the lowest byte
+	struct RasterTarget
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		bool srgb = false; //Blend in linear space and encode on write, like a *Srgb surface format
+		std::vector<uint32_t> color;
+		std::vector<float> depth;
+
+		void Resize(uint32_t newWidth, uint32_t newHeight);
+
+		//Same as the main pass load ops
+		void Clear(Vec4f clearColor, float clearDepth);
+
+		TextureResource ToTextureResource(std::string const& label) const;
+	};
+
+	struct QuadRasterInput
+	{
+		std::span<QuadTransform const> transforms;
+		std::span<AnimUniform const> animations;
+		CamUniforms camera;
+		std::span<uint32_t const> instances; //Quads to draw in draw order, e.g. the output of CullQuads
+		std::span<TextureResource const> layers; //Texture array layers, all the same size and RGBA8
+	};
+
+	//Bins triangles into k_rasterTileSize tiles and shades tiles in parallel. Within a tile 2x2 pixel quads are
+	//tested, depth tested and blended 4 lanes at a time (SSE2 when available), texture sampling runs per lane
+	class SoftwareRasterizer {
+	public:
+		//Edge functions and attribute planes in pixel space, set up once per triangle
+		struct Triangle
+		{
+			float edges[3][3]; //A, B, C of each edge function, edge i is opposite vertex i
+			bool topLeft[3];
+			float z[3]; //Plane: dx, dy, c
+			float s[3];
+			float t[3];
+			uint32_t xBegin, xEnd, yBegin, yEnd; //Pixel bounds, clamped to the target
+			uint32_t layer;
+		};
+
+		//Tiles are shaded over pJobs' workers, or on the calling thread without one
+		explicit SoftwareRasterizer(Jobs::JobSystem* pJobs = nullptr);
+
+		//Per draw scratch (tile buffers) comes from pScratch, e.g. a Memory::FrameArena, or the default resource
+		void DrawQuads(QuadRasterInput const& input, RasterTarget& target, std::pmr::memory_resource* pScratch = nullptr);
+
+	private:
+		void SetupTriangles(QuadRasterInput const& input, RasterTarget const& target);
+		void RasterizeTiles(QuadRasterInput const& input, RasterTarget& target, std::pmr::memory_resource* pScratch);
+
+		std::vector<Triangle> _triangles;
+		std::vector<std::vector<uint32_t>> _tileBins; //Triangle ids per tile in draw order
+		Jobs::JobSystem* _pJobs;
+	};
+
+	//Box filtered copy for thumbnails, keeps the aspect ratio with the longest side at maxSide
+	TextureResource MakeThumbnail(RasterTarget const& target, uint32_t maxSide);
+
+	//Largest per channel difference against a RGBA8 golden image, max uint32 if the sizes don't match
+	uint32_t MaxChannelDifference(RasterTarget const& target, TextureResource const& golden);
+}
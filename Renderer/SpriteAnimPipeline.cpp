@@ -0,0 +1,113 @@
+#include "SpriteAnimPipeline.h"
+#include <algorithm>
+
+namespace Gfx
+{
+	void AnimateSprites(std::span<SpriteAnimState const> states, uint32_t tick, std::span<AnimUniform> animations)
+	{
+		size_t count = std::min(states.size(), animations.size());
+		for (size_t i = 0; i < count; ++i)
+		{
+			animations[i].currentFrameIndex = SpriteFrame(states[i], tick);
+		}
+	}
+
+	SpriteAnimPipeline::SpriteAnimPipeline(Gfx::Device& device, wgpu::ShaderModule shader)
+		: _pDevice(&device)
+		, _pipeline(nullptr)
+		, _pipelineLayout(nullptr)
+		, _bindLayout(nullptr)
+		, _bindGroup(nullptr)
+	{
+		wgpu::BindGroupLayoutEntry& stateBinding = _bindLayouts[0];
+		stateBinding.binding = 0;
+		stateBinding.visibility = wgpu::ShaderStage::Compute;
+		stateBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+		stateBinding.buffer.minBindingSize = sizeof(SpriteAnimState);
+		stateBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& tickBinding = _bindLayouts[1];
+		tickBinding.binding = 1;
+		tickBinding.visibility = wgpu::ShaderStage::Compute;
+		tickBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		tickBinding.buffer.minBindingSize = sizeof(SpriteAnimTick);
+		tickBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& animationBinding = _bindLayouts[2];
+		animationBinding.binding = 2;
+		animationBinding.visibility = wgpu::ShaderStage::Compute;
+		animationBinding.buffer.type = wgpu::BufferBindingType::Storage;
+		animationBinding.buffer.minBindingSize = sizeof(AnimUniform);
+		animationBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutDescriptor bindLayoutDesc;
+		bindLayoutDesc.entryCount = k_SpriteAnimBindingCount;
+		bindLayoutDesc.entries = _bindLayouts.data();
+		_bindLayout = device.CreateBindGroupLayout(bindLayoutDesc);
+
+		wgpu::PipelineLayoutDescriptor animLayoutDescriptor;
+		animLayoutDescriptor.bindGroupLayoutCount = 1;
+		animLayoutDescriptor.bindGroupLayouts = (WGPUBindGroupLayout*)&_bindLayout;
+		animLayoutDescriptor.label = "Sprite anim layout";
+		_pipelineLayout = device.CreatePipelineLayout(animLayoutDescriptor);
+
+		wgpu::ComputePipelineDescriptor animPipelineDesc;
+		animPipelineDesc.layout = _pipelineLayout;
+		animPipelineDesc.compute.module = shader;
+		animPipelineDesc.compute.entryPoint = "cs_main";
+		animPipelineDesc.compute.constantCount = 0;
+		animPipelineDesc.compute.constants = nullptr;
+		animPipelineDesc.label = "Sprite Anim Pipeline";
+		_pipeline = device.CreateComputePipeline(animPipelineDesc);
+	}
+
+	SpriteAnimPipeline::~SpriteAnimPipeline()
+	{
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_pDevice->Release(_bindLayout);
+		_pDevice->Release(_pipeline);
+		_pDevice->Release(_pipelineLayout);
+	}
+
+	void SpriteAnimPipeline::BindData(Gfx::Buffer const& states, Gfx::Buffer const& tick, Gfx::Buffer const& animations)
+	{
+		wgpu::BindGroupEntry& stateBind = _bindEntries[0];
+		stateBind.binding = 0;
+		stateBind.buffer = states.Get();
+		stateBind.offset = 0;
+		stateBind.size = states.Size();
+
+		wgpu::BindGroupEntry& tickBind = _bindEntries[1];
+		tickBind.binding = 1;
+		tickBind.buffer = tick.Get();
+		tickBind.offset = 0;
+		tickBind.size = tick.Size();
+
+		wgpu::BindGroupEntry& animationBind = _bindEntries[2];
+		animationBind.binding = 2;
+		animationBind.buffer = animations.Get();
+		animationBind.offset = 0;
+		animationBind.size = animations.Size();
+
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+
+		wgpu::BindGroupDescriptor bindingDesc{};
+		bindingDesc.layout = _bindLayout;
+		bindingDesc.entryCount = k_SpriteAnimBindingCount;
+		bindingDesc.entries = _bindEntries.data();
+		_bindGroup = _pDevice->CreateBindGroup(bindingDesc);
+	}
+
+	void SpriteAnimPipeline::Dispatch(wgpu::CommandEncoder commands, uint32_t spriteCount, wgpu::ComputePassTimestampWrites const* pTimestamps)
+	{
+		wgpu::ComputePassDescriptor animPassDesc{};
+		animPassDesc.label = "Sprite Anim Pass";
+		animPassDesc.timestampWrites = pTimestamps;
+
+		Gfx::ComputeEncoder& animPass = _pDevice->BeginComputePass(commands, animPassDesc);
+		animPass.SetPipeline(_pipeline);
+		animPass.SetBindGroup(0, _bindGroup);
+		animPass.DispatchWorkgroups((spriteCount + k_spriteAnimWorkgroupSize - 1) / k_spriteAnimWorkgroupSize, 1, 1);
+		_pDevice->EndComputePass(animPass);
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <span>
+#include "webgpu.h"
+#include "Buffer.h"
+#include "GfxDevice.h"
+#include "QuadDefs.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_SpriteAnimBindingCount = 3;
+	constexpr uint32_t k_spriteAnimWorkgroupSize = 64; //Defined into spriteAnim.wgsl when it is loaded
+
+	struct SpriteAnimTick
+	{
+		uint32_t tick = 0;
+		uint32_t _pad[3] = { 0, 0, 0 };
+	};
+	static_assert(sizeof(SpriteAnimTick) % 16 == 0);
+
+	//Wgsl integer division and modulo, which are defined for a 0 divisor: a / 0 is a and a % 0 is 0
+	constexpr uint32_t WgslDivide(uint32_t a, uint32_t b) { return b == 0 ? a : a / b; }
+	constexpr uint32_t WgslModulo(uint32_t a, uint32_t b) { return b == 0 ? 0 : a % b; }
+
+	//Cpu reference of cs_main in spriteAnim.wgsl, gives the exact frame the gpu writes for the same tick
+	constexpr uint32_t SpriteFrame(SpriteAnimState const& state, uint32_t tick)
+	{
+		return WgslModulo(WgslDivide(tick, state.ticksPerFrame) + state.phase, state.clipLength);
+	}
+
+	//Cpu reference of a whole dispatch, for anything that needs the frames without a gpu
+	void AnimateSprites(std::span<SpriteAnimState const> states, uint32_t tick, std::span<AnimUniform> animations);
+
+	//Compute pass that sets the frame index of every sprite from its SpriteAnimState and the current tick,
+	//so animation state lives on the gpu and only the tick is written each frame
+	class SpriteAnimPipeline {
+	public:
+		SpriteAnimPipeline(Gfx::Device& device, wgpu::ShaderModule shader);
+		~SpriteAnimPipeline();
+
+		//animations is the AnimUniform buffer the quads read, it needs Storage usage
+		void BindData(Gfx::Buffer const& states, Gfx::Buffer const& tick, Gfx::Buffer const& animations);
+
+		void Dispatch(wgpu::CommandEncoder commands, uint32_t spriteCount, wgpu::ComputePassTimestampWrites const* pTimestamps = nullptr);
+
+		inline wgpu::ComputePipeline Get() const noexcept {
+			return _pipeline;
+		};
+
+	private:
+		//No copy, move
+		SpriteAnimPipeline(SpriteAnimPipeline const& other) = delete;
+		SpriteAnimPipeline(SpriteAnimPipeline&& other) = delete;
+		SpriteAnimPipeline& operator=(SpriteAnimPipeline const& other) = delete;
+		SpriteAnimPipeline& operator=(SpriteAnimPipeline&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::ComputePipeline _pipeline;
+		wgpu::PipelineLayout _pipelineLayout;
+		std::array<wgpu::BindGroupEntry, k_SpriteAnimBindingCount> _bindEntries;
+		std::array<wgpu::BindGroupLayoutEntry, k_SpriteAnimBindingCount> _bindLayouts;
+		wgpu::BindGroupLayout _bindLayout;
+		wgpu::BindGroup _bindGroup;
+	};
+}
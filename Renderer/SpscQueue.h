@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+//Bounded lock free queue from one producer thread to one consumer thread. Neither side ever waits or allocates,
+//pushing into a full queue fails instead. Capacity has to be a power of two
+template<typename T, uint32_t Capacity>
+class SpscQueue {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+public:
+	SpscQueue() = default;
+
+	//Producer only
+	bool TryPush(T const& value) noexcept
+	{
+		uint32_t const tail = _tail.load(std::memory_order_relaxed);
+		if (tail - _cachedHead == Capacity)
+		{
+			_cachedHead = _head.load(std::memory_order_acquire);
+			if (tail - _cachedHead == Capacity) return false;
+		}
+		_slots[tail & k_indexMask] = value;
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Consumer only
+	bool TryPop(T& value) noexcept
+	{
+		uint32_t const head = _head.load(std::memory_order_relaxed);
+		if (head == _cachedTail)
+		{
+			_cachedTail = _tail.load(std::memory_order_acquire);
+			if (head == _cachedTail) return false;
+		}
+		value = _slots[head & k_indexMask];
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	//No copy, move
+	SpscQueue(SpscQueue const& other) = delete;
+	SpscQueue(SpscQueue&& other) = delete;
+	SpscQueue& operator=(SpscQueue const& other) = delete;
+	SpscQueue& operator=(SpscQueue&& other) = delete;
+
+	static constexpr uint32_t k_indexMask = Capacity - 1;
+
+	std::array<T, Capacity> _slots{};
+	//Indices only grow and wrap at 2^32, which a power of two capacity divides. Each side keeps a copy of the other's
+	//index next to its own so it only touches the other side's cache line when the queue looks full or empty
+	alignas(64) std::atomic<uint32_t> _head = 0;
+	uint32_t _cachedTail = 0;
+	alignas(64) std::atomic<uint32_t> _tail = 0;
+	uint32_t _cachedHead = 0;
+};
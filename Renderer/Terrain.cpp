@@ -1,42 +1,66 @@
 #include "Terrain.h"
+#include "Chrono.h"
+#include "SpriteAnimPipeline.h"
 
-Terrain::Terrain(uint32_t width, uint32_t height, uint32_t cellSize)
+namespace
 {
-	uint32_t totalCells = width * height;
-	_cells.reserve(totalCells);
-
-	for (uint32_t cellId = 0; cellId < totalCells; cellId++) {
-		uint32_t colPos = cellId % width;
-		uint32_t rowPos = cellId / width;
-		float x = (float)(cellSize * colPos);
-		float y = (float)(cellSize * rowPos);
-		QuadTransform cell{
-			{x,y,0.0f}, 0.f /*pad*/,
-			{cellSize, cellSize}
-		};
-		_cells.emplace_back(cell);
-
-		AnimUniform anim;
-		anim.currentFrameIndex = cellId % 8;
-		anim.animId = cellId % 2;
-		anim.startCoord = { 0,0 };
-		anim.frameDimensions = { 50,38 };
-		_cellAnim.emplace_back(anim);
-	}
+	constexpr uint32_t k_cellClipLength = 8;
+	//A frame a second
+	constexpr uint32_t k_cellTicksPerFrame = (uint32_t)(std::chrono::nanoseconds(std::chrono::seconds(1)) / Clock::k_fixedStep);
+	constexpr uint32_t k_terrainLayer = 0;
+}
+
+Terrain::Terrain(uint32_t width, uint32_t height, uint32_t cellSize, Jobs::JobSystem* pJobs)
+{
+	Generate(width, height, cellSize, pJobs);
 }
 
-void Terrain::Animate(float dT)
+void Terrain::Generate(uint32_t width, uint32_t height, uint32_t cellSize, Jobs::JobSystem* pJobs)
 {
-	constexpr float k_fps = 1;
+	uint32_t totalCells = width * height;
+	_animTick = 0;
+	_width = width;
+	_height = height;
+	_cellSize = cellSize;
+
+	//Created up front so the chunks can be filled from any thread, a cleared world numbers them from 0
+	_sprites.Clear();
+	_sprites.CreateMany<QuadTransform, AnimUniform, SpriteAnimState, SpriteLayer>(totalCells);
 
-	if (_secs > k_fps)
-	{
-		for (auto& anim : _cellAnim)
-		{
-			anim.currentFrameIndex = (anim.currentFrameIndex + 1) % 8;
+	auto generateCells = [this](std::span<Ecs::Entity const> entities, std::span<QuadTransform> transforms, std::span<AnimUniform> anims,
+		std::span<SpriteAnimState> animStates, std::span<SpriteLayer> layers) {
+		for (size_t i = 0; i < entities.size(); i++) {
+			uint32_t cellId = entities[i].index;
+			uint32_t colPos = cellId % _width;
+			uint32_t rowPos = cellId / _width;
+			float x = (float)(_cellSize * colPos);
+			float y = (float)(_cellSize * rowPos);
+			transforms[i] = QuadTransform{
+				{x,y,0.0f}, 0.f /*pad*/,
+				{(float)_cellSize, (float)_cellSize}
+			};
+
+			SpriteAnimState& animState = animStates[i];
+			animState.clipLength = k_cellClipLength;
+			animState.ticksPerFrame = k_cellTicksPerFrame;
+			animState.phase = cellId % k_cellClipLength;
+
+			AnimUniform& anim = anims[i];
+			anim.currentFrameIndex = Gfx::SpriteFrame(animState, _animTick);
+			anim.animId = cellId % 2;
+			anim.startCoord = { 0,0 };
+			anim.frameDimensions = { 50,38 };
+
+			layers[i].layer = k_terrainLayer;
 		}
-		_secs = 0.f;
-	}
+	};
+	if (pJobs) _sprites.ParallelForEachChunk<QuadTransform, AnimUniform, SpriteAnimState, SpriteLayer>(*pJobs, generateCells);
+	else _sprites.ForEachChunk<QuadTransform, AnimUniform, SpriteAnimState, SpriteLayer>(generateCells);
 
-	_secs += dT;
+	++_layoutVersion;
+}
+
+void Terrain::Animate()
+{
+	++_animTick;
 }
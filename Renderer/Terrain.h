@@ -2,6 +2,8 @@
 #include <cstdint>
 #include <vector>
 #include "QuadDefs.h"
+#include "JobSystem.h"
+#include "Ecs.h"
 
 //Handles generating a grid of tiles of stores their locations
 // eventually will handle also generating the associated initial height map
@@ -9,20 +11,47 @@
 class Terrain {
 public:
 
-	Terrain(uint32_t width, uint32_t height, uint32_t cellSize);
-	inline std::vector<QuadTransform> const& Cells() {
-		return _cells;
+	Terrain(uint32_t width, uint32_t height, uint32_t cellSize, Jobs::JobSystem* pJobs = nullptr);
+
+	//One entity per cell with a QuadTransform, AnimUniform, SpriteAnimState and SpriteLayer. They're created row by row,
+	//so chunk order is cell order and entity index is the cell id. AnimUniform holds the animations at tick 0, afterwards
+	//the frame indices are only kept on the gpu (Gfx::AnimateSprites gives them on the cpu)
+	inline Ecs::World const& Sprites() const noexcept {
+		return _sprites;
+	}
+	inline uint32_t CellCount() const noexcept {
+		return _sprites.Count();
+	}
+	//Simulation steps since the animations started, wraps like the u32 the gpu gets.
+	//Owned by the simulation thread, renderers get it through the frame snapshot
+	inline uint32_t AnimTick() const noexcept {
+		return _animTick;
 	}
-	inline std::vector<AnimUniform> const& CellAnimations() {
-		return _cellAnim;
+
+	//Grid size in cells, cell (col, row) is cell id col + row * Width()
+	inline uint32_t Width() const noexcept { return _width; }
+	inline uint32_t Height() const noexcept { return _height; }
+	inline uint32_t CellSize() const noexcept { return _cellSize; }
+
+	//Bumped every time the cell layout is regenerated, anything built from Sprites() (e.g. render bundles)
+	//only needs rebuilding when this changes
+	inline uint64_t LayoutVersion() const noexcept {
+		return _layoutVersion;
 	}
 
-	void Animate(float dT);
+	//Regenerates the grid, invalidating the current layout. Chunks are filled in parallel when pJobs is given
+	void Generate(uint32_t width, uint32_t height, uint32_t cellSize, Jobs::JobSystem* pJobs = nullptr);
+
+	//Advances the animations by one simulation step of the frame clock
+	void Animate();
 
 private:
-	std::vector<QuadTransform> _cells;
-	std::vector<AnimUniform> _cellAnim;
+	Ecs::World _sprites;
+	uint64_t _layoutVersion = 0;
+	uint32_t _width = 0;
+	uint32_t _height = 0;
+	uint32_t _cellSize = 0;
 
-	float _secs = 0.f;
+	uint32_t _animTick = 0;
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,136 @@
+#include "TerrainRenderer.h"
+#include "Quad.h"
+#include "Profiler.h"
+
+namespace
+{
+	constexpr uint32_t k_quadPipelineId = 0;
+	constexpr uint32_t k_animTextureId = 0;
+}
+
+TerrainRenderer::TerrainRenderer(Gfx::Device& device, Terrain& terrain, Gfx::Texture const& animations, Gfx::Buffer const& camera,
+	wgpu::ShaderModule quadShader, wgpu::ShaderModule cullShader, wgpu::ShaderModule animShader, wgpu::ColorTargetState colorTarget,
+	wgpu::DepthStencilState depthStencil, Gfx::QuadGeometry geometry)
+	: _pDevice(&device)
+	, _pTerrain(&terrain)
+	, _pAnimations(&animations)
+	, _pCamera(&camera)
+	, _quadPipeline(device, quadShader, colorTarget, depthStencil, geometry)
+	, _cullPipeline(device, cullShader)
+	, _animPipeline(device, animShader)
+	, _drawArgs(sizeof(DrawIndirectArgs), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage
+		| wgpu::BufferUsage::Indirect, "Quad Draw Args", device)
+	, _initialDrawArgs(sizeof(DrawIndirectArgs), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc, "Quad Draw Args Reset", device)
+	, _animTick(sizeof(Gfx::SpriteAnimTick), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, "Sprite Anim Tick", device)
+	, _bufferLayoutVersion(0)
+	, _bundle({ colorTarget.format }, depthStencil.format, "Terrain Bundle", device)
+{
+	DrawIndirectArgs initialDrawArgs;
+	initialDrawArgs.vertexOrIndexCount = 6;
+	_initialDrawArgs.EnqueueCopy(&initialDrawArgs, 0);
+
+	//Only the geometry the pipeline reads from is created
+	if (geometry == Gfx::QuadGeometry::VertexBuffer)
+	{
+		Gfx::Quad quad;
+		_quadVertices.emplace(sizeof(quad.vertices), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex, "Quad Vertices", device);
+		_quadVertices->EnqueueCopy(quad.vertices.data(), 0);
+	}
+	else if (geometry == Gfx::QuadGeometry::Indexed)
+	{
+		Gfx::IndexedQuad quad;
+		_quadVertices.emplace(sizeof(quad.vertices), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex, "Quad Vertices", device);
+		_quadVertices->EnqueueCopy(quad.vertices.data(), 0);
+		_quadIndices.emplace(sizeof(quad.indices), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Index, "Quad Indices", device);
+		_quadIndices->EnqueueCopy(quad.indices.data(), 0);
+	}
+
+	CreateInstanceBuffers();
+}
+
+void TerrainRenderer::CreateInstanceBuffers()
+{
+	//Release the old buffers before allocating their replacements
+	_transforms.reset();
+	_cellAnimations.reset();
+	_cellAnimStates.reset();
+	_visibleInstances.reset();
+
+	uint32_t cellCount = _pTerrain->CellCount();
+	_transforms.emplace(cellCount * (uint32_t)sizeof(QuadTransform), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+		"Transform Buffer", *_pDevice);
+	//Uploaded once, the animation pass keeps the frame indices current from here on
+	_cellAnimations.emplace(cellCount * (uint32_t)sizeof(AnimUniform), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+		"Animations", *_pDevice);
+	_cellAnimStates.emplace(cellCount * (uint32_t)sizeof(SpriteAnimState), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+		"Animation States", *_pDevice);
+
+	//Component arrays go straight from the chunks into the buffers, chunk order is cell order
+	uint32_t firstCell = 0;
+	_pTerrain->Sprites().ForEachChunk<QuadTransform const, AnimUniform const, SpriteAnimState const>(
+		[&](std::span<Ecs::Entity const> cells, std::span<QuadTransform const> transforms, std::span<AnimUniform const> animations,
+			std::span<SpriteAnimState const> animStates) {
+			_transforms->EnqueueCopy(transforms.data(), (uint32_t)transforms.size_bytes(), firstCell * (uint32_t)sizeof(QuadTransform));
+			_cellAnimations->EnqueueCopy(animations.data(), (uint32_t)animations.size_bytes(), firstCell * (uint32_t)sizeof(AnimUniform));
+			_cellAnimStates->EnqueueCopy(animStates.data(), (uint32_t)animStates.size_bytes(), firstCell * (uint32_t)sizeof(SpriteAnimState));
+			firstCell += (uint32_t)cells.size();
+		});
+
+	_visibleInstances.emplace(cellCount * (uint32_t)sizeof(uint32_t), wgpu::BufferUsage::Storage, "Visible Instances", *_pDevice);
+
+	_cullPipeline.BindData(*_transforms, *_pCamera, *_visibleInstances, _drawArgs);
+	_animPipeline.BindData(*_cellAnimStates, _animTick, *_cellAnimations);
+	_quadPipeline.BindData(*_transforms, *_pAnimations, *_pCamera, *_cellAnimations, *_visibleInstances);
+
+	//Draw args come from the cull pass, so the recorded draw stays valid while the camera moves
+	Gfx::DrawCommand quadDraw;
+	quadDraw.pipeline = _quadPipeline.Get();
+	quadDraw.bindGroup = _quadPipeline.BindGroup();
+	quadDraw.indirectBuffer = _drawArgs.Get();
+	if (_quadVertices)
+	{
+		quadDraw.vertexBuffer = _quadVertices->Get();
+		quadDraw.vertexBufferSize = _quadVertices->Size();
+	}
+	if (_quadIndices)
+	{
+		quadDraw.indexBuffer = _quadIndices->Get();
+		quadDraw.indexBufferSize = _quadIndices->Size();
+		quadDraw.indexFormat = wgpu::IndexFormat::Uint16;
+	}
+
+	_draws.Reset();
+	_draws.Add(Gfx::DrawKey::Make(Gfx::k_mainPass, k_quadPipelineId, k_animTextureId, 0.f, 0), quadDraw);
+	_draws.Sort();
+
+	_bufferLayoutVersion = _pTerrain->LayoutVersion();
+}
+
+void TerrainRenderer::Update(uint32_t animTick)
+{
+	PROFILE_FUNCTION();
+	if (_pTerrain->LayoutVersion() != _bufferLayoutVersion) CreateInstanceBuffers();
+
+	Gfx::SpriteAnimTick tick;
+	tick.tick = animTick;
+	_animTick.EnqueueCopy(&tick, 0);
+
+	_bundle.Update(_bufferLayoutVersion, _draws, Gfx::k_mainPass);
+}
+
+void TerrainRenderer::Animate(wgpu::CommandEncoder commands, wgpu::ComputePassTimestampWrites const* pTimestamps)
+{
+	_animPipeline.Dispatch(commands, _pTerrain->CellCount(), pTimestamps);
+}
+
+void TerrainRenderer::Cull(wgpu::CommandEncoder commands, wgpu::ComputePassTimestampWrites const* pTimestamps)
+{
+	//Reset the visible count on the gpu, so the frame doesn't need a queue write for it
+	_pDevice->CopyBufferToBuffer(commands, _initialDrawArgs.Get(), 0, _drawArgs.Get(), 0, sizeof(DrawIndirectArgs));
+	_cullPipeline.Dispatch(commands, _pTerrain->CellCount(), pTimestamps);
+}
+
+void TerrainRenderer::Draw(Gfx::RenderEncoder& pass)
+{
+	_bundle.Execute(pass);
+}
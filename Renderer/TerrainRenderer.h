@@ -0,0 +1,70 @@
+#pragma once
+#include <optional>
+#include "webgpu.h"
+#include "GfxDevice.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "QuadDefs.h"
+#include "QuadRenderPipeline.h"
+#include "QuadCullPipeline.h"
+#include "SpriteAnimPipeline.h"
+#include "DrawList.h"
+#include "DrawBundle.h"
+#include "Terrain.h"
+
+//Gpu side of a Terrain: instance buffers, the animation and cull pre-passes and the quad draw, which is recorded once
+//into a render bundle. Instance buffers, bindings and the bundle are only rebuilt when the terrain layout changes
+class TerrainRenderer {
+public:
+	TerrainRenderer(Gfx::Device& device, Terrain& terrain, Gfx::Texture const& animations, Gfx::Buffer const& camera,
+		wgpu::ShaderModule quadShader, wgpu::ShaderModule cullShader, wgpu::ShaderModule animShader, wgpu::ColorTargetState colorTarget,
+		wgpu::DepthStencilState depthStencil, Gfx::QuadGeometry geometry);
+
+	//Uploads this frame's animation tick (Terrain::AnimTick as of the snapshot being drawn), the only per frame buffer write
+	void Update(uint32_t animTick);
+
+	//Records the pass that advances the sprite frames, has to be before the pass Draw is called in
+	void Animate(wgpu::CommandEncoder commands, wgpu::ComputePassTimestampWrites const* pTimestamps = nullptr);
+
+	//Resets the indirect draw args with a buffer copy and records the cull pre-pass, has to be in the same submission and
+	//before the pass Draw is called in
+	void Cull(wgpu::CommandEncoder commands, wgpu::ComputePassTimestampWrites const* pTimestamps = nullptr);
+
+	void Draw(Gfx::RenderEncoder& pass);
+
+	inline Gfx::QuadRenderPipeline const& Pipeline() const noexcept { return _quadPipeline; }
+	//Written by the cull pass, instanceCount is the number of visible quads
+	inline Gfx::Buffer const& DrawArgs() const noexcept { return _drawArgs; }
+
+private:
+	//No copy, move
+	TerrainRenderer(TerrainRenderer const& other) = delete;
+	TerrainRenderer(TerrainRenderer&& other) = delete;
+	TerrainRenderer& operator=(TerrainRenderer const& other) = delete;
+	TerrainRenderer& operator=(TerrainRenderer&& other) = delete;
+
+	void CreateInstanceBuffers();
+
+	Gfx::Device* _pDevice;
+	Terrain* _pTerrain;
+	Gfx::Texture const* _pAnimations;
+	Gfx::Buffer const* _pCamera;
+
+	Gfx::QuadRenderPipeline _quadPipeline;
+	Gfx::QuadCullPipeline _cullPipeline;
+	Gfx::SpriteAnimPipeline _animPipeline;
+	std::optional<Gfx::Buffer> _quadVertices;
+	std::optional<Gfx::Buffer> _quadIndices;
+	Gfx::Buffer _drawArgs;
+	Gfx::Buffer _initialDrawArgs; //Copied over _drawArgs before every cull pass
+	Gfx::Buffer _animTick;
+
+	std::optional<Gfx::Buffer> _transforms;
+	std::optional<Gfx::Buffer> _cellAnimations;
+	std::optional<Gfx::Buffer> _cellAnimStates;
+	std::optional<Gfx::Buffer> _visibleInstances;
+	uint64_t _bufferLayoutVersion;
+
+	Gfx::DrawList _draws;
+	Gfx::DrawBundle _bundle;
+};
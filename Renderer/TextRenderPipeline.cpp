@@ -0,0 +1,162 @@
+#include "TextRenderPipeline.h"
+
+namespace Gfx
+{
+	TextRenderPipeline::TextRenderPipeline(
+		Gfx::Device& device,
+		wgpu::ShaderModule shaders,
+		wgpu::TextureFormat colorFormat,
+		wgpu::TextureFormat depthFormat)
+		: _pDevice(&device)
+		, _pipeline(nullptr)
+		, _pipelineLayout(nullptr)
+		, _bindLayout(nullptr)
+		, _bindGroup(nullptr)
+		, _sampler(nullptr)
+	{
+		//Corners come from vertex_index, glyphs from the storage buffer
+		wgpu::VertexState vertexState{};
+		vertexState.bufferCount = 0;
+		vertexState.buffers = nullptr;
+		vertexState.entryPoint = "vs_main";
+		vertexState.module = shaders;
+		vertexState.constantCount = 0;
+		vertexState.constants = nullptr;
+
+		wgpu::BlendState blendState{};
+		blendState.color.srcFactor = wgpu::BlendFactor::SrcAlpha;
+		blendState.color.dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha;
+		blendState.color.operation = wgpu::BlendOperation::Add;
+		blendState.alpha.srcFactor = wgpu::BlendFactor::Zero;
+		blendState.alpha.dstFactor = wgpu::BlendFactor::One;
+		blendState.alpha.operation = wgpu::BlendOperation::Add;
+
+		wgpu::ColorTargetState colorTarget{};
+		colorTarget.format = colorFormat;
+		colorTarget.blend = &blendState;
+		colorTarget.writeMask = wgpu::ColorWriteMask::All;
+
+		wgpu::FragmentState fragmentState{};
+		fragmentState.module = shaders;
+		fragmentState.constantCount = 0;
+		fragmentState.constants = nullptr;
+		fragmentState.entryPoint = "fs_main";
+		fragmentState.targetCount = 1;
+		fragmentState.targets = &colorTarget;
+
+		//Has to match the depth attachment of the pass it's drawn in (if any), text is always on top
+		wgpu::DepthStencilState depthStencil = wgpu::Default;
+		depthStencil.format = depthFormat;
+		depthStencil.depthCompare = wgpu::CompareFunction::Always;
+		depthStencil.depthWriteEnabled = false;
+		depthStencil.stencilReadMask = 0;
+		depthStencil.stencilWriteMask = 0;
+
+		wgpu::BindGroupLayoutEntry& glyphBinding = _bindLayouts[0];
+		glyphBinding.binding = 0;
+		glyphBinding.visibility = wgpu::ShaderStage::Vertex;
+		glyphBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+		glyphBinding.buffer.minBindingSize = sizeof(GlyphInstance);
+		glyphBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& atlasBinding = _bindLayouts[1];
+		atlasBinding.binding = 1;
+		atlasBinding.visibility = wgpu::ShaderStage::Fragment;
+		atlasBinding.texture.sampleType = wgpu::TextureSampleType::Float;
+		atlasBinding.texture.viewDimension = wgpu::TextureViewDimension::_2D;
+
+		wgpu::BindGroupLayoutEntry& samplerBinding = _bindLayouts[2];
+		samplerBinding.binding = 2;
+		samplerBinding.visibility = wgpu::ShaderStage::Fragment;
+		samplerBinding.sampler.type = wgpu::SamplerBindingType::Filtering;
+
+		wgpu::BindGroupLayoutEntry& screenBinding = _bindLayouts[3];
+		screenBinding.binding = 3;
+		screenBinding.visibility = wgpu::ShaderStage::Vertex;
+		screenBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		screenBinding.buffer.minBindingSize = sizeof(TextUniforms);
+		screenBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutDescriptor bindLayoutDesc;
+		bindLayoutDesc.entryCount = k_TextPipelineBindingCount;
+		bindLayoutDesc.entries = _bindLayouts.data();
+		_bindLayout = device.CreateBindGroupLayout(bindLayoutDesc);
+
+		//Pixel font, glyphs are drawn at their baked size so nearest keeps them sharp
+		wgpu::SamplerDescriptor atlasSamplerDesc;
+		atlasSamplerDesc.addressModeU = wgpu::AddressMode::ClampToEdge;
+		atlasSamplerDesc.addressModeV = wgpu::AddressMode::ClampToEdge;
+		atlasSamplerDesc.addressModeW = wgpu::AddressMode::ClampToEdge;
+		atlasSamplerDesc.magFilter = wgpu::FilterMode::Nearest;
+		atlasSamplerDesc.minFilter = wgpu::FilterMode::Nearest;
+		atlasSamplerDesc.mipmapFilter = wgpu::MipmapFilterMode::Nearest;
+		atlasSamplerDesc.lodMinClamp = 0.0f;
+		atlasSamplerDesc.lodMaxClamp = 1.0f;
+		atlasSamplerDesc.compare = wgpu::CompareFunction::Undefined;
+		atlasSamplerDesc.maxAnisotropy = 1;
+		_sampler = device.CreateSampler(atlasSamplerDesc);
+
+		wgpu::PipelineLayoutDescriptor textLayoutDescriptor;
+		textLayoutDescriptor.bindGroupLayoutCount = 1;
+		textLayoutDescriptor.bindGroupLayouts = (WGPUBindGroupLayout*)&_bindLayout;
+		textLayoutDescriptor.label = "Text layout";
+		_pipelineLayout = device.CreatePipelineLayout(textLayoutDescriptor);
+
+		wgpu::RenderPipelineDescriptor textPipelineDesc;
+		textPipelineDesc.layout = _pipelineLayout;
+		textPipelineDesc.depthStencil = depthFormat == wgpu::TextureFormat::Undefined ? nullptr : &depthStencil;
+		textPipelineDesc.vertex = vertexState;
+		textPipelineDesc.fragment = &fragmentState;
+
+		textPipelineDesc.primitive.topology = wgpu::PrimitiveTopology::TriangleList;
+		textPipelineDesc.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
+		textPipelineDesc.primitive.frontFace = wgpu::FrontFace::CCW;
+		textPipelineDesc.primitive.cullMode = wgpu::CullMode::None;
+
+		textPipelineDesc.multisample.count = 1;
+		textPipelineDesc.multisample.mask = ~0u; //all bits on
+		textPipelineDesc.multisample.alphaToCoverageEnabled = false;
+
+		textPipelineDesc.label = "Text Pipeline";
+		_pipeline = device.CreateRenderPipeline(textPipelineDesc);
+	}
+
+	TextRenderPipeline::~TextRenderPipeline()
+	{
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_pDevice->Release(_bindLayout);
+		_pDevice->Release(_sampler);
+		_pDevice->Release(_pipeline);
+		_pDevice->Release(_pipelineLayout);
+	}
+
+	void TextRenderPipeline::BindData(Gfx::Buffer const& glyphData, Gfx::Texture const& atlas, Gfx::Buffer const& screenData)
+	{
+		wgpu::BindGroupEntry& glyphBind = _bindEntries[0];
+		glyphBind.binding = 0;
+		glyphBind.buffer = glyphData.Get();
+		glyphBind.offset = 0;
+		glyphBind.size = glyphData.Size();
+
+		wgpu::BindGroupEntry& atlasBind = _bindEntries[1];
+		atlasBind.binding = 1;
+		atlasBind.textureView = atlas.View();
+
+		wgpu::BindGroupEntry& samplerBind = _bindEntries[2];
+		samplerBind.binding = 2;
+		samplerBind.sampler = _sampler;
+
+		wgpu::BindGroupEntry& screenBind = _bindEntries[3];
+		screenBind.binding = 3;
+		screenBind.buffer = screenData.Get();
+		screenBind.offset = 0;
+		screenBind.size = screenData.Size();
+
+		wgpu::BindGroupDescriptor bindingDesc{};
+		bindingDesc.layout = _bindLayout;
+		bindingDesc.entryCount = k_TextPipelineBindingCount;
+		bindingDesc.entries = _bindEntries.data();
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_bindGroup = _pDevice->CreateBindGroup(bindingDesc);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include "webgpu.h"
+#include "MathDefs.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_TextPipelineBindingCount = 4;
+
+	//One instance per glyph, laid out like Glyph in textShader.wgsl
+	struct GlyphInstance
+	{
+		Vec4f rect; //x, y top left, z, w size, in pixels
+		Vec4f uvRect; //u0, v0, u1, v1
+		Vec4f color;
+	};
+	static_assert(sizeof(GlyphInstance) % 16 == 0);
+
+	struct TextUniforms
+	{
+		Vec2f screenSize;
+		float _pad[2] = { 0.f, 0.f };
+	};
+	static_assert(sizeof(TextUniforms) % 16 == 0);
+
+	//Screen space glyph quads pulled from a storage buffer, alpha blended on top of the scene without depth testing.
+	//depthFormat is Undefined for passes without a depth attachment
+	class TextRenderPipeline {
+	public:
+		TextRenderPipeline(Gfx::Device& device, wgpu::ShaderModule shaders, wgpu::TextureFormat colorFormat, wgpu::TextureFormat depthFormat);
+		~TextRenderPipeline();
+
+		void BindData(Gfx::Buffer const& glyphData, Gfx::Texture const& atlas, Gfx::Buffer const& screenData);
+
+		inline wgpu::RenderPipeline Get() const noexcept {
+			return _pipeline;
+		};
+
+		inline wgpu::BindGroup BindGroup() const noexcept {
+			return _bindGroup;
+		};
+
+	private:
+		//No copy, move
+		TextRenderPipeline(TextRenderPipeline const& other) = delete;
+		TextRenderPipeline(TextRenderPipeline&& other) = delete;
+		TextRenderPipeline& operator=(TextRenderPipeline const& other) = delete;
+		TextRenderPipeline& operator=(TextRenderPipeline&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::RenderPipeline _pipeline;
+		wgpu::PipelineLayout _pipelineLayout;
+		std::array<wgpu::BindGroupEntry, k_TextPipelineBindingCount> _bindEntries;
+		std::array<wgpu::BindGroupLayoutEntry, k_TextPipelineBindingCount> _bindLayouts;
+		wgpu::BindGroupLayout _bindLayout;
+		wgpu::BindGroup _bindGroup;
+		wgpu::Sampler _sampler;
+	};
+}
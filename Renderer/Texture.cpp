@@ -27,8 +27,9 @@ namespace
 namespace Gfx
 {
 	Texture::Texture(wgpu::TextureDimension dimension, wgpu::Extent3D extents, int usageFlags,
-		uint8_t numChannels, uint8_t bytesPerChannel, wgpu::TextureFormat format, wgpu::Device device, std::string const& label)
-		: _handle(nullptr)
+		uint8_t numChannels, uint8_t bytesPerChannel, wgpu::TextureFormat format, Gfx::Device& device, std::string const& label)
+		: _pDevice(&device)
+		, _handle(nullptr)
 		, _viewHandle(nullptr)
 		, _extents(extents)
 		, _format(format)
@@ -45,7 +46,7 @@ namespace Gfx
 		desc.viewFormatCount = 1;
 		desc.viewFormats = (WGPUTextureFormat*)&_format;
 		desc.label = label.c_str();
-		_handle = device.createTexture(desc);
+		_handle = device.CreateTexture(desc);
 
 		wgpu::TextureViewDescriptor vDesc;
 		vDesc.aspect = wgpu::TextureAspect::All;
@@ -56,16 +57,18 @@ namespace Gfx
 		vDesc.mipLevelCount = 1;
 		vDesc.dimension = Convert(dimension, extents);
 		vDesc.format = format;
-		_viewHandle = _handle.createView(vDesc);
+		_viewHandle = device.CreateTextureView(_handle, vDesc);
 	}
 
 	Texture::~Texture() {
+		if (_viewHandle) {
+			_pDevice->Release(_viewHandle);
+		}
 		if (_handle) {
-			_handle.destroy();
-			_handle.release();
+			_pDevice->Release(_handle);
 		}
 	}
-	void Texture::EnqueueCopy(void const* pData, wgpu::Extent3D writeSize, wgpu::Queue& queue, wgpu::Origin3D targetOffset)
+	void Texture::EnqueueCopy(void const* pData, wgpu::Extent3D writeSize, wgpu::Origin3D targetOffset)
 	{
 		wgpu::ImageCopyTexture destination;
 		destination.texture = _handle;
@@ -75,11 +78,11 @@ namespace Gfx
 
 		wgpu::TextureDataLayout source;
 		source.offset = 0;
-		source.bytesPerRow = 4 /*4 byte channels, rgba*/ * _extents.width;
-		source.rowsPerImage = _extents.height;
-		
-		uint32_t sizeBytes = writeSize.width * writeSize.height * writeSize.depthOrArrayLayers * _bytesPerChannel * _numChannels;
-		queue.writeTexture(destination, pData, sizeBytes , source, writeSize);
+		source.bytesPerRow = BytesPerTexel() * writeSize.width;
+		source.rowsPerImage = writeSize.height;
+
+		uint32_t sizeBytes = source.bytesPerRow * writeSize.height * writeSize.depthOrArrayLayers;
+		_pDevice->WriteTexture(destination, pData, sizeBytes , source, writeSize);
 	}
 
 }
\ No newline at end of file
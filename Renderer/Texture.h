@@ -1,22 +1,33 @@
 #pragma once
+#include <string>
 #include "webgpu.h"
+#include "GfxDevice.h"
 
 namespace Gfx
 {
 	class Texture {
 	public:
 		Texture(wgpu::TextureDimension dimension, wgpu::Extent3D extents,
-			int usageFlags, uint8_t numChannels, uint8_t bytesPerChannel, wgpu::TextureFormat format, wgpu::Device device, std::string const& label);
+			int usageFlags, uint8_t numChannels, uint8_t bytesPerChannel, wgpu::TextureFormat format, Gfx::Device& device, std::string const& label);
 		~Texture();
 
-		void EnqueueCopy(void const* pData, wgpu::Extent3D writeSize, wgpu::Queue& queue, wgpu::Origin3D targetOffset = { 0, 0, 0 });
+		//pData holds writeSize texels packed tightly, row after row and layer after layer
+		void EnqueueCopy(void const* pData, wgpu::Extent3D writeSize, wgpu::Origin3D targetOffset = { 0, 0, 0 });
 
 		inline wgpu::Texture Get() const { return _handle; }
 		inline wgpu::Extent3D Extents() const { return _extents; }
 		inline wgpu::TextureFormat Format() const { return _format; }
 		inline wgpu::TextureView View() const { return _viewHandle; }
+		inline uint32_t BytesPerTexel() const { return (uint32_t)_bytesPerChannel * _numChannels; }
 
 	private:
+		//No copy, move
+		Texture(Texture const& other) = delete;
+		Texture(Texture&& other) = delete;
+		Texture& operator=(Texture const& other) = delete;
+		Texture& operator=(Texture&& other) = delete;
+
+		Gfx::Device* _pDevice;
 		wgpu::Texture _handle;
 		wgpu::TextureView _viewHandle;
 		wgpu::Extent3D _extents;
@@ -0,0 +1,117 @@
+#include "TextureUploader.h"
+#include <algorithm>
+#include <string.h> //memcpy
+#include "Profiler.h"
+
+namespace
+{
+	//Staging grows in steps of this so a few extra bytes don't recreate it every frame
+	constexpr uint32_t k_stagingGrowBytes = 64 * 1024;
+
+	constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	void Accumulate(Gfx::UploadStats& total, Gfx::UploadStats const& add)
+	{
+		total.bytes += add.bytes;
+		total.stagedBytes += add.stagedBytes;
+		total.copies += add.copies;
+		total.directWrites += add.directWrites;
+	}
+}
+
+namespace Gfx
+{
+	TextureUploader::TextureUploader(Gfx::Device& device, uint32_t maxStagingBytes)
+		: _pDevice(&device)
+		, _maxStagingBytes(maxStagingBytes)
+	{
+	}
+
+	void TextureUploader::Enqueue(Gfx::Texture const& texture, void const* pData, wgpu::Extent3D size, wgpu::Origin3D origin,
+		uint32_t sourceBytesPerRow)
+	{
+		uint32_t const rowBytes = texture.BytesPerTexel() * size.width;
+		uint32_t const sourcePitch = sourceBytesPerRow != 0 ? sourceBytesPerRow : rowBytes;
+		uint32_t const rows = size.height * size.depthOrArrayLayers;
+		if (rowBytes == 0 || rows == 0) return;
+
+		uint32_t const alignedRowBytes = (uint32_t)AlignUp(rowBytes, k_copyBytesPerRowAlignment);
+		uint64_t const stagedBytes = (uint64_t)alignedRowBytes * rows;
+		_current.bytes += (uint64_t)rowBytes * rows;
+
+		wgpu::ImageCopyTexture destination;
+		destination.texture = texture.Get();
+		destination.mipLevel = 0;
+		destination.origin = origin;
+		destination.aspect = wgpu::TextureAspect::All;
+
+		//Every region is a whole number of aligned rows, so offsets stay aligned without padding between them
+		uint64_t const offset = _staging.size();
+		if (offset + stagedBytes > _maxStagingBytes)
+		{
+			//Lands before the staged uploads, which only matters if they overlap
+			wgpu::TextureDataLayout layout;
+			layout.offset = 0;
+			layout.bytesPerRow = sourcePitch;
+			layout.rowsPerImage = size.height;
+			_pDevice->WriteTexture(destination, pData, (size_t)sourcePitch * (rows - 1) + rowBytes, layout, size);
+			++_current.directWrites;
+			return;
+		}
+
+		_staging.resize(offset + stagedBytes);
+		uint8_t const* pSource = static_cast<uint8_t const*>(pData);
+		uint8_t* pStaging = _staging.data() + offset;
+		for (uint32_t row = 0; row < rows; ++row)
+		{
+			memcpy(pStaging + (size_t)row * alignedRowBytes, pSource + (size_t)row * sourcePitch, rowBytes);
+		}
+
+		_pending.push_back({ destination.texture, origin, size, offset, alignedRowBytes });
+		_current.stagedBytes += stagedBytes;
+	}
+
+	void TextureUploader::Flush(wgpu::CommandEncoder commands)
+	{
+		PROFILE_FUNCTION();
+		if (!_pending.empty())
+		{
+			uint32_t const stagingSize = (uint32_t)_staging.size();
+			if (!_stagingBuffer || _stagingBuffer->Size() < stagingSize)
+			{
+				_stagingBuffer.reset();
+				uint32_t const capacity = std::min((uint32_t)AlignUp(stagingSize, k_stagingGrowBytes), _maxStagingBytes);
+				_stagingBuffer.emplace(std::max(capacity, stagingSize), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc,
+					"Texture Staging", *_pDevice);
+			}
+			_stagingBuffer->EnqueueCopy(_staging.data(), stagingSize, 0);
+
+			for (PendingCopy const& pending : _pending)
+			{
+				wgpu::ImageCopyBuffer source;
+				source.buffer = _stagingBuffer->Get();
+				source.layout.offset = pending.offset;
+				source.layout.bytesPerRow = pending.bytesPerRow;
+				source.layout.rowsPerImage = pending.size.height;
+
+				wgpu::ImageCopyTexture destination;
+				destination.texture = pending.texture;
+				destination.mipLevel = 0;
+				destination.origin = pending.origin;
+				destination.aspect = wgpu::TextureAspect::All;
+
+				_pDevice->CopyBufferToTexture(commands, source, destination, pending.size);
+				++_current.copies;
+			}
+			_pending.clear();
+			_staging.clear();
+		}
+
+		Accumulate(_total, _current);
+		_lastFlush = _current;
+		_current = {};
+	}
+}
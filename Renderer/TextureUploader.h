@@ -0,0 +1,69 @@
+#pragma once
+#include <optional>
+#include <vector>
+#include "webgpu.h"
+#include "GfxDevice.h"
+#include "Buffer.h"
+#include "Texture.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_copyBytesPerRowAlignment = 256;
+	//Half of the max buffer size main asks the device for
+	constexpr uint32_t k_defaultStagingBytes = 512 * 1024;
+
+	struct UploadStats
+	{
+		uint64_t bytes = 0; //Texel bytes uploaded
+		uint64_t stagedBytes = 0; //Staging bytes copied from, row padding included
+		uint32_t copies = 0; //copyBufferToTexture commands
+		uint32_t directWrites = 0; //Uploads that didn't fit in staging and went through writeTexture
+	};
+
+	//Packs texture uploads of any format, sub rect and layer range into one staging buffer with 256 byte aligned rows.
+	//Flush writes the staging buffer once and records a copyBufferToTexture per upload, instead of a queue write each.
+	//The staging buffer is reused, so there can only be one Flush per submission
+	class TextureUploader {
+	public:
+		explicit TextureUploader(Gfx::Device& device, uint32_t maxStagingBytes = k_defaultStagingBytes);
+
+		//pData holds size texels with rows sourceBytesPerRow apart (0 for tightly packed) and layers right after each other.
+		//It's copied before this returns
+		void Enqueue(Gfx::Texture const& texture, void const* pData, wgpu::Extent3D size, wgpu::Origin3D origin = { 0, 0, 0 },
+			uint32_t sourceBytesPerRow = 0);
+
+		//Records every pending upload into commands, they land when commands is submitted
+		void Flush(wgpu::CommandEncoder commands);
+
+		inline uint32_t PendingCount() const noexcept { return (uint32_t)_pending.size(); }
+		//What the last Flush uploaded, including direct writes since the one before it
+		inline UploadStats const& LastFlush() const noexcept { return _lastFlush; }
+		inline UploadStats const& Total() const noexcept { return _total; }
+
+	private:
+		//No copy, move
+		TextureUploader(TextureUploader const& other) = delete;
+		TextureUploader(TextureUploader&& other) = delete;
+		TextureUploader& operator=(TextureUploader const& other) = delete;
+		TextureUploader& operator=(TextureUploader&& other) = delete;
+
+		struct PendingCopy
+		{
+			wgpu::Texture texture;
+			wgpu::Origin3D origin;
+			wgpu::Extent3D size;
+			uint64_t offset;
+			uint32_t bytesPerRow;
+		};
+
+		Gfx::Device* _pDevice;
+		uint32_t _maxStagingBytes;
+		std::vector<uint8_t> _staging;
+		std::vector<PendingCopy> _pending;
+		std::optional<Gfx::Buffer> _stagingBuffer;
+
+		UploadStats _current;
+		UploadStats _lastFlush;
+		UploadStats _total;
+	};
+}
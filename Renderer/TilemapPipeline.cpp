@@ -0,0 +1,170 @@
+#include "TilemapPipeline.h"
+#include "QuadDefs.h"
+
+namespace Gfx
+{
+	TilemapPipeline::TilemapPipeline(Gfx::Device& device, wgpu::ShaderModule shader, wgpu::ColorTargetState outputTarget, wgpu::DepthStencilState depthStencil)
+		: _pDevice(&device)
+		, _pipeline(nullptr)
+		, _pipelineLayout(nullptr)
+		, _bindLayout(nullptr)
+		, _bindGroup(nullptr)
+		, _sampler(nullptr)
+	{
+		//Fullscreen triangle comes from vertex_index
+		wgpu::VertexState vertexState{};
+		vertexState.bufferCount = 0;
+		vertexState.buffers = nullptr;
+		vertexState.entryPoint = "vs_main";
+		vertexState.module = shader;
+		vertexState.constantCount = 0;
+		vertexState.constants = nullptr;
+
+		wgpu::FragmentState fragmentState{};
+		fragmentState.module = shader;
+		fragmentState.constantCount = 0;
+		fragmentState.constants = nullptr;
+		fragmentState.entryPoint = "fs_main";
+		fragmentState.targetCount = 1;
+		fragmentState.targets = &outputTarget;
+
+		wgpu::BindGroupLayoutEntry& tileIndexBinding = _bindLayouts[0];
+		tileIndexBinding.binding = 0;
+		tileIndexBinding.visibility = wgpu::ShaderStage::Fragment;
+		tileIndexBinding.texture.sampleType = wgpu::TextureSampleType::Uint;
+		tileIndexBinding.texture.viewDimension = wgpu::TextureViewDimension::_2D;
+
+		wgpu::BindGroupLayoutEntry& tileTypeBinding = _bindLayouts[1];
+		tileTypeBinding.binding = 1;
+		tileTypeBinding.visibility = wgpu::ShaderStage::Fragment;
+		tileTypeBinding.buffer.type = wgpu::BufferBindingType::ReadOnlyStorage;
+		tileTypeBinding.buffer.minBindingSize = sizeof(TileType);
+		tileTypeBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& textureBinding = _bindLayouts[2];
+		textureBinding.binding = 2;
+		textureBinding.visibility = wgpu::ShaderStage::Fragment;
+		textureBinding.texture.sampleType = wgpu::TextureSampleType::Float;
+		textureBinding.texture.viewDimension = wgpu::TextureViewDimension::_2DArray;
+
+		wgpu::BindGroupLayoutEntry& samplerBinding = _bindLayouts[3];
+		samplerBinding.binding = 3;
+		samplerBinding.visibility = wgpu::ShaderStage::Fragment;
+		samplerBinding.sampler.type = wgpu::SamplerBindingType::Filtering;
+
+		wgpu::BindGroupLayoutEntry& cameraUniformBinding = _bindLayouts[4];
+		cameraUniformBinding.binding = 4;
+		cameraUniformBinding.visibility = wgpu::ShaderStage::Fragment;
+		cameraUniformBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		cameraUniformBinding.buffer.minBindingSize = sizeof(CamUniforms);
+		cameraUniformBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutEntry& tilemapUniformBinding = _bindLayouts[5];
+		tilemapUniformBinding.binding = 5;
+		tilemapUniformBinding.visibility = wgpu::ShaderStage::Fragment;
+		tilemapUniformBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		tilemapUniformBinding.buffer.minBindingSize = sizeof(TilemapUniforms);
+		tilemapUniformBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutDescriptor bindLayoutDesc;
+		bindLayoutDesc.entryCount = k_TilemapPipelineBindingCount;
+		bindLayoutDesc.entries = _bindLayouts.data();
+		_bindLayout = device.CreateBindGroupLayout(bindLayoutDesc);
+
+		//Same filtering as the quads so both modes look alike
+		wgpu::SamplerDescriptor spriteSamplerDesc;
+		spriteSamplerDesc.addressModeU = wgpu::AddressMode::ClampToEdge;
+		spriteSamplerDesc.addressModeV = wgpu::AddressMode::ClampToEdge;
+		spriteSamplerDesc.addressModeW = wgpu::AddressMode::ClampToEdge;
+		spriteSamplerDesc.magFilter = wgpu::FilterMode::Linear;
+		spriteSamplerDesc.minFilter = wgpu::FilterMode::Linear;
+		spriteSamplerDesc.mipmapFilter = wgpu::MipmapFilterMode::Linear;
+		spriteSamplerDesc.lodMinClamp = 0.0f;
+		spriteSamplerDesc.lodMaxClamp = 1.0f;
+		spriteSamplerDesc.compare = wgpu::CompareFunction::Undefined;
+		spriteSamplerDesc.maxAnisotropy = 1;
+		_sampler = device.CreateSampler(spriteSamplerDesc);
+
+		wgpu::PipelineLayoutDescriptor tilemapLayoutDescriptor;
+		tilemapLayoutDescriptor.bindGroupLayoutCount = 1;
+		tilemapLayoutDescriptor.bindGroupLayouts = (WGPUBindGroupLayout*)&_bindLayout;
+		tilemapLayoutDescriptor.label = "Tilemap layout";
+		_pipelineLayout = device.CreatePipelineLayout(tilemapLayoutDescriptor);
+
+		wgpu::RenderPipelineDescriptor tilemapPipelineDesc;
+		tilemapPipelineDesc.layout = _pipelineLayout;
+		tilemapPipelineDesc.depthStencil = &depthStencil;
+		tilemapPipelineDesc.vertex = vertexState;
+		tilemapPipelineDesc.fragment = &fragmentState;
+
+		tilemapPipelineDesc.primitive.topology = wgpu::PrimitiveTopology::TriangleList;
+		tilemapPipelineDesc.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
+		tilemapPipelineDesc.primitive.frontFace = wgpu::FrontFace::CCW;
+		tilemapPipelineDesc.primitive.cullMode = wgpu::CullMode::None;
+
+		tilemapPipelineDesc.multisample.count = 1;
+		tilemapPipelineDesc.multisample.mask = ~0u; //all bits on
+		tilemapPipelineDesc.multisample.alphaToCoverageEnabled = false;
+
+		tilemapPipelineDesc.label = "Tilemap Pipeline";
+		_pipeline = device.CreateRenderPipeline(tilemapPipelineDesc);
+	}
+
+	TilemapPipeline::~TilemapPipeline()
+	{
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_pDevice->Release(_bindLayout);
+		_pDevice->Release(_sampler);
+		_pDevice->Release(_pipeline);
+		_pDevice->Release(_pipelineLayout);
+	}
+
+	void TilemapPipeline::BindData(Gfx::Texture const& tileIndices, Gfx::Buffer const& tileTypes, Gfx::Texture const& animations,
+		Gfx::Buffer const& cameraData, Gfx::Buffer const& tilemapData)
+	{
+		wgpu::BindGroupEntry& tileIndexBind = _bindEntries[0];
+		tileIndexBind.binding = 0;
+		tileIndexBind.textureView = tileIndices.View();
+
+		wgpu::BindGroupEntry& tileTypeBind = _bindEntries[1];
+		tileTypeBind.binding = 1;
+		tileTypeBind.buffer = tileTypes.Get();
+		tileTypeBind.offset = 0;
+		tileTypeBind.size = tileTypes.Size();
+
+		wgpu::BindGroupEntry& textureBind = _bindEntries[2];
+		textureBind.binding = 2;
+		textureBind.textureView = animations.View();
+
+		wgpu::BindGroupEntry& samplerBind = _bindEntries[3];
+		samplerBind.binding = 3;
+		samplerBind.sampler = _sampler;
+
+		wgpu::BindGroupEntry& camBind = _bindEntries[4];
+		camBind.binding = 4;
+		camBind.buffer = cameraData.Get();
+		camBind.offset = 0;
+		camBind.size = cameraData.Size();
+
+		wgpu::BindGroupEntry& tilemapBind = _bindEntries[5];
+		tilemapBind.binding = 5;
+		tilemapBind.buffer = tilemapData.Get();
+		tilemapBind.offset = 0;
+		tilemapBind.size = tilemapData.Size();
+
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+
+		wgpu::BindGroupDescriptor bindingDesc{};
+		bindingDesc.layout = _bindLayout;
+		bindingDesc.entryCount = k_TilemapPipelineBindingCount;
+		bindingDesc.entries = _bindEntries.data();
+		_bindGroup = _pDevice->CreateBindGroup(bindingDesc);
+	}
+
+	void TilemapPipeline::Draw(Gfx::RenderEncoder& pass)
+	{
+		pass.SetPipeline(_pipeline);
+		pass.SetBindGroup(0, _bindGroup);
+		pass.Draw(3, 1, 0, 0);
+	}
+}
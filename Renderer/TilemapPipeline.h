@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include "webgpu.h"
+#include "MathDefs.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_TilemapPipelineBindingCount = 6;
+	//Tile index texels hold the tile type in the low bits and the animation phase in the high ones
+	constexpr uint32_t k_tileTypeBits = 16;
+	constexpr uint32_t k_maxTileTypes = 1u << k_tileTypeBits;
+	constexpr wgpu::TextureFormat k_tileIndexFormat = wgpu::TextureFormat::R32Uint;
+
+	constexpr uint32_t PackTileIndex(uint32_t tileType, uint32_t phase) { return tileType | (phase << k_tileTypeBits); }
+
+	//Everything cells of one kind share, laid out like TileType in tilemap.wgsl
+	struct TileType
+	{
+		Vec2f startCoord = { 0.f, 0.f };
+		Vec2f frameDimensions = { 0.f, 0.f };
+		uint32_t animId = 0;
+		uint32_t clipLength = 1;
+		uint32_t ticksPerFrame = 1;
+		uint32_t _pad = 0;
+	};
+	static_assert(sizeof(TileType) % 16 == 0);
+
+	//Laid out like Tilemap in tilemap.wgsl
+	struct TilemapUniforms
+	{
+		Vec2f origin = { 0.f, 0.f };
+		Vec2f cellSize = { 1.f, 1.f };
+		uint32_t gridWidth = 0;
+		uint32_t gridHeight = 0;
+		uint32_t tick = 0;
+		uint32_t _pad = 0;
+	};
+	static_assert(sizeof(TilemapUniforms) % 16 == 0);
+
+	//Draws a whole grid of animated sprites as one fullscreen triangle, each pixel looks up its cell in a tile index texture.
+	//Costs the same for any number of cells, there's nothing per cell on the cpu or in the vertex stage
+	class TilemapPipeline {
+	public:
+		TilemapPipeline(Gfx::Device& device, wgpu::ShaderModule shader, wgpu::ColorTargetState outputTarget, wgpu::DepthStencilState depthStencil);
+		~TilemapPipeline();
+
+		void BindData(Gfx::Texture const& tileIndices, Gfx::Buffer const& tileTypes, Gfx::Texture const& animations,
+			Gfx::Buffer const& cameraData, Gfx::Buffer const& tilemapData);
+
+		void Draw(Gfx::RenderEncoder& pass);
+
+		inline wgpu::RenderPipeline Get() const noexcept {
+			return _pipeline;
+		};
+
+	private:
+		//No copy, move
+		TilemapPipeline(TilemapPipeline const& other) = delete;
+		TilemapPipeline(TilemapPipeline&& other) = delete;
+		TilemapPipeline& operator=(TilemapPipeline const& other) = delete;
+		TilemapPipeline& operator=(TilemapPipeline&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::RenderPipeline _pipeline;
+		wgpu::PipelineLayout _pipelineLayout;
+		std::array<wgpu::BindGroupEntry, k_TilemapPipelineBindingCount> _bindEntries;
+		std::array<wgpu::BindGroupLayoutEntry, k_TilemapPipelineBindingCount> _bindLayouts;
+		wgpu::BindGroupLayout _bindLayout;
+		wgpu::BindGroup _bindGroup;
+		wgpu::Sampler _sampler;
+	};
+}
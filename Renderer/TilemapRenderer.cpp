@@ -0,0 +1,108 @@
+#include "TilemapRenderer.h"
+#include <iostream>
+#include <algorithm>
+#include "SpriteAnimPipeline.h"
+#include "Profiler.h"
+
+namespace
+{
+	bool SameTile(Gfx::TileType const& a, Gfx::TileType const& b)
+	{
+		return a.startCoord == b.startCoord && a.frameDimensions == b.frameDimensions && a.animId == b.animId
+			&& a.clipLength == b.clipLength && a.ticksPerFrame == b.ticksPerFrame;
+	}
+}
+
+TilemapRenderer::TilemapRenderer(Gfx::Device& device, Terrain& terrain, Gfx::Texture const& animations, Gfx::Buffer const& camera,
+	wgpu::ShaderModule shader, wgpu::ColorTargetState colorTarget, wgpu::DepthStencilState depthStencil)
+	: _pDevice(&device)
+	, _pTerrain(&terrain)
+	, _pAnimations(&animations)
+	, _pCamera(&camera)
+	, _pipeline(device, shader, colorTarget, depthStencil)
+	, _tilemap(sizeof(Gfx::TilemapUniforms), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, "Tilemap Uniforms", device)
+	, _layoutVersion(0)
+{
+	CreateTileData();
+}
+
+void TilemapRenderer::CreateTileData()
+{
+	PROFILE_FUNCTION();
+	//Release the old resources before allocating their replacements
+	_tileIndices.reset();
+	_tileTypes.reset();
+
+	uint32_t const width = std::max(_pTerrain->Width(), 1u);
+	uint32_t const height = std::max(_pTerrain->Height(), 1u);
+
+	//Grids have a handful of tile types, a linear search beats hashing here
+	_tileTypeData.clear();
+	_tileIndexData.assign(width * height, 0);
+	bool overflowed = false;
+	_pTerrain->Sprites().ForEachChunk<AnimUniform const, SpriteAnimState const>(
+		[&](std::span<Ecs::Entity const> cells, std::span<AnimUniform const> animations, std::span<SpriteAnimState const> states) {
+			for (size_t i = 0; i < cells.size(); ++i)
+			{
+				//Terrain entity indices are cell ids
+				uint32_t const cell = cells[i].index;
+				if (cell >= _tileIndexData.size()) continue;
+
+				Gfx::TileType tile;
+				tile.startCoord = animations[i].startCoord;
+				tile.frameDimensions = animations[i].frameDimensions;
+				tile.animId = animations[i].animId;
+				tile.clipLength = states[i].clipLength;
+				tile.ticksPerFrame = states[i].ticksPerFrame;
+
+				auto it = std::find_if(_tileTypeData.begin(), _tileTypeData.end(), [&](Gfx::TileType const& other) { return SameTile(tile, other); });
+				uint32_t tileType = (uint32_t)(it - _tileTypeData.begin());
+				if (it == _tileTypeData.end())
+				{
+					if (_tileTypeData.size() < Gfx::k_maxTileTypes) _tileTypeData.push_back(tile);
+					else
+					{
+						overflowed = true;
+						tileType = 0;
+					}
+				}
+
+				//Reduced by the clip length so it fits in the bits left over, the frame it gives is the same
+				uint32_t const phase = Gfx::WgslModulo(states[i].phase, states[i].clipLength) & ((1u << (32 - Gfx::k_tileTypeBits)) - 1);
+				_tileIndexData[cell] = Gfx::PackTileIndex(tileType, phase);
+			}
+		});
+	if (overflowed) std::cout << "Tilemap has more than " << Gfx::k_maxTileTypes << " tile types, the rest are drawn as the first\n";
+	if (_tileTypeData.empty()) _tileTypeData.emplace_back();
+
+	_tileIndices.emplace(wgpu::TextureDimension::_2D, wgpu::Extent3D{ width, height, 1 }, wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::CopyDst,
+		1, 4, Gfx::k_tileIndexFormat, *_pDevice, "Tile Indices");
+	_tileIndices->EnqueueCopy(_tileIndexData.data(), _tileIndices->Extents());
+
+	_tileTypes.emplace((uint32_t)(_tileTypeData.size() * sizeof(Gfx::TileType)), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+		"Tile Types", *_pDevice);
+	_tileTypes->EnqueueCopy(_tileTypeData.data(), 0);
+
+	//Cells start at the world origin, same as the quads TerrainRenderer draws
+	_uniforms.origin = Vec2f{ 0.f, 0.f };
+	_uniforms.cellSize = Vec2f{ (float)_pTerrain->CellSize(), (float)_pTerrain->CellSize() };
+	_uniforms.gridWidth = _pTerrain->Width();
+	_uniforms.gridHeight = _pTerrain->Height();
+
+	_pipeline.BindData(*_tileIndices, *_tileTypes, *_pAnimations, *_pCamera, _tilemap);
+	_layoutVersion = _pTerrain->LayoutVersion();
+}
+
+void TilemapRenderer::Update(uint32_t animTick)
+{
+	PROFILE_FUNCTION();
+	if (_pTerrain->LayoutVersion() != _layoutVersion) CreateTileData();
+
+	_uniforms.tick = animTick;
+	_tilemap.EnqueueCopy(&_uniforms, 0);
+}
+
+void TilemapRenderer::Draw(Gfx::RenderEncoder& pass)
+{
+	_pipeline.Draw(pass);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <optional>
+#include <vector>
+#include "webgpu.h"
+#include "GfxDevice.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "TilemapPipeline.h"
+#include "Terrain.h"
+
+enum class TerrainDrawMode
+{
+	Quads, //TerrainRenderer, a culled quad instance per cell
+	Tilemap, //TilemapRenderer, one fullscreen pass
+};
+
+//Tilemap mode for a Terrain, an alternative to TerrainRenderer: the grid is a tile index texture drawn in one fullscreen pass.
+//Cells sharing clip, rate and texture share a tile type, only the phase is stored per cell.
+//Per frame it only writes the animation tick, the tile data is rebuilt when the terrain layout changes
+class TilemapRenderer {
+public:
+	TilemapRenderer(Gfx::Device& device, Terrain& terrain, Gfx::Texture const& animations, Gfx::Buffer const& camera,
+		wgpu::ShaderModule shader, wgpu::ColorTargetState colorTarget, wgpu::DepthStencilState depthStencil);
+
+	//animTick is Terrain::AnimTick as of the snapshot being drawn
+	void Update(uint32_t animTick);
+
+	void Draw(Gfx::RenderEncoder& pass);
+
+	inline uint32_t TileTypeCount() const noexcept { return (uint32_t)_tileTypeData.size(); }
+
+private:
+	//No copy, move
+	TilemapRenderer(TilemapRenderer const& other) = delete;
+	TilemapRenderer(TilemapRenderer&& other) = delete;
+	TilemapRenderer& operator=(TilemapRenderer const& other) = delete;
+	TilemapRenderer& operator=(TilemapRenderer&& other) = delete;
+
+	void CreateTileData();
+
+	Gfx::Device* _pDevice;
+	Terrain* _pTerrain;
+	Gfx::Texture const* _pAnimations;
+	Gfx::Buffer const* _pCamera;
+
+	Gfx::TilemapPipeline _pipeline;
+	Gfx::Buffer _tilemap;
+	Gfx::TilemapUniforms _uniforms;
+
+	std::optional<Gfx::Texture> _tileIndices;
+	std::optional<Gfx::Buffer> _tileTypes;
+	std::vector<Gfx::TileType> _tileTypeData;
+	std::vector<uint32_t> _tileIndexData;
+	uint64_t _layoutVersion;
+};
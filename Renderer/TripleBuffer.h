@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+//Lock free hand off of the newest value from one producer thread to one consumer thread. The producer fills Back() and
+//publishes it, the consumer picks up whatever was published last. Neither side ever waits, values published in between
+//are skipped. Slots are reused, so the producer overwrites the old contents of Back() (vectors keep their capacity)
+template<typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() = default;
+
+	//Producer only
+	inline T& Back() noexcept { return _slots[_back]; }
+	void Publish() noexcept
+	{
+		_back = _middle.exchange(_back | k_freshBit, std::memory_order_acq_rel) & k_indexMask;
+	}
+
+	//Consumer only, moves the newest published value to Front(). False if nothing was published since the last call
+	bool Acquire() noexcept
+	{
+		if ((_middle.load(std::memory_order_relaxed) & k_freshBit) == 0) return false;
+		_front = _middle.exchange(_front, std::memory_order_acq_rel) & k_indexMask;
+		return true;
+	}
+	inline T const& Front() const noexcept { return _slots[_front]; }
+
+private:
+	//No copy, move
+	TripleBuffer(TripleBuffer const& other) = delete;
+	TripleBuffer(TripleBuffer&& other) = delete;
+	TripleBuffer& operator=(TripleBuffer const& other) = delete;
+	TripleBuffer& operator=(TripleBuffer&& other) = delete;
+
+	static constexpr uint8_t k_indexMask = 0x3;
+	static constexpr uint8_t k_freshBit = 0x4; //Set on the middle index when it holds a value the consumer hasn't taken
+
+	std::array<T, 3> _slots{};
+	//Each side owns one slot, the third is swapped between them through _middle
+	alignas(64) std::atomic<uint8_t> _middle = 1;
+	alignas(64) uint8_t _back = 0;
+	alignas(64) uint8_t _front = 2;
+};
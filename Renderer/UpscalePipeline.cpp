@@ -0,0 +1,150 @@
+#include "UpscalePipeline.h"
+
+namespace Gfx
+{
+	UpscalePipeline::UpscalePipeline(Gfx::Device& device, wgpu::ShaderModule shader, wgpu::TextureFormat targetFormat)
+		: _pDevice(&device)
+		, _pipeline(nullptr)
+		, _pipelineLayout(nullptr)
+		, _bindLayout(nullptr)
+		, _bindGroup(nullptr)
+		, _sampler(nullptr)
+		, _params(sizeof(UpscaleUniforms), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, "Upscale Params", device)
+	{
+		_uniforms.uvScale = Vec2f{ 0.f, 0.f };
+		_uniforms.uvClamp = Vec2f{ 0.f, 0.f };
+
+		//Fullscreen triangle comes from vertex_index
+		wgpu::VertexState vertexState{};
+		vertexState.bufferCount = 0;
+		vertexState.buffers = nullptr;
+		vertexState.entryPoint = "vs_main";
+		vertexState.module = shader;
+		vertexState.constantCount = 0;
+		vertexState.constants = nullptr;
+
+		wgpu::ColorTargetState colorTarget{};
+		colorTarget.format = targetFormat;
+		colorTarget.blend = nullptr;
+		colorTarget.writeMask = wgpu::ColorWriteMask::All;
+
+		wgpu::FragmentState fragmentState{};
+		fragmentState.module = shader;
+		fragmentState.constantCount = 0;
+		fragmentState.constants = nullptr;
+		fragmentState.entryPoint = "fs_main";
+		fragmentState.targetCount = 1;
+		fragmentState.targets = &colorTarget;
+
+		wgpu::BindGroupLayoutEntry& sourceBinding = _bindLayouts[0];
+		sourceBinding.binding = 0;
+		sourceBinding.visibility = wgpu::ShaderStage::Fragment;
+		sourceBinding.texture.sampleType = wgpu::TextureSampleType::Float;
+		sourceBinding.texture.viewDimension = wgpu::TextureViewDimension::_2D;
+
+		wgpu::BindGroupLayoutEntry& samplerBinding = _bindLayouts[1];
+		samplerBinding.binding = 1;
+		samplerBinding.visibility = wgpu::ShaderStage::Fragment;
+		samplerBinding.sampler.type = wgpu::SamplerBindingType::Filtering;
+
+		wgpu::BindGroupLayoutEntry& paramsBinding = _bindLayouts[2];
+		paramsBinding.binding = 2;
+		paramsBinding.visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment;
+		paramsBinding.buffer.type = wgpu::BufferBindingType::Uniform;
+		paramsBinding.buffer.minBindingSize = sizeof(UpscaleUniforms);
+		paramsBinding.buffer.hasDynamicOffset = false;
+
+		wgpu::BindGroupLayoutDescriptor bindLayoutDesc;
+		bindLayoutDesc.entryCount = k_UpscalePipelineBindingCount;
+		bindLayoutDesc.entries = _bindLayouts.data();
+		_bindLayout = device.CreateBindGroupLayout(bindLayoutDesc);
+
+		wgpu::SamplerDescriptor samplerDesc;
+		samplerDesc.addressModeU = wgpu::AddressMode::ClampToEdge;
+		samplerDesc.addressModeV = wgpu::AddressMode::ClampToEdge;
+		samplerDesc.addressModeW = wgpu::AddressMode::ClampToEdge;
+		samplerDesc.magFilter = wgpu::FilterMode::Linear;
+		samplerDesc.minFilter = wgpu::FilterMode::Linear;
+		samplerDesc.mipmapFilter = wgpu::MipmapFilterMode::Nearest;
+		samplerDesc.lodMinClamp = 0.0f;
+		samplerDesc.lodMaxClamp = 1.0f;
+		samplerDesc.compare = wgpu::CompareFunction::Undefined;
+		samplerDesc.maxAnisotropy = 1;
+		_sampler = device.CreateSampler(samplerDesc);
+
+		wgpu::PipelineLayoutDescriptor layoutDescriptor;
+		layoutDescriptor.bindGroupLayoutCount = 1;
+		layoutDescriptor.bindGroupLayouts = (WGPUBindGroupLayout*)&_bindLayout;
+		layoutDescriptor.label = "Upscale layout";
+		_pipelineLayout = device.CreatePipelineLayout(layoutDescriptor);
+
+		wgpu::RenderPipelineDescriptor pipelineDesc;
+		pipelineDesc.layout = _pipelineLayout;
+		pipelineDesc.depthStencil = nullptr;
+		pipelineDesc.vertex = vertexState;
+		pipelineDesc.fragment = &fragmentState;
+
+		pipelineDesc.primitive.topology = wgpu::PrimitiveTopology::TriangleList;
+		pipelineDesc.primitive.stripIndexFormat = wgpu::IndexFormat::Undefined;
+		pipelineDesc.primitive.frontFace = wgpu::FrontFace::CCW;
+		pipelineDesc.primitive.cullMode = wgpu::CullMode::None;
+
+		pipelineDesc.multisample.count = 1;
+		pipelineDesc.multisample.mask = ~0u; //all bits on
+		pipelineDesc.multisample.alphaToCoverageEnabled = false;
+
+		pipelineDesc.label = "Upscale Pipeline";
+		_pipeline = device.CreateRenderPipeline(pipelineDesc);
+	}
+
+	UpscalePipeline::~UpscalePipeline()
+	{
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_pDevice->Release(_bindLayout);
+		_pDevice->Release(_sampler);
+		_pDevice->Release(_pipeline);
+		_pDevice->Release(_pipelineLayout);
+	}
+
+	void UpscalePipeline::BindData(wgpu::TextureView source)
+	{
+		wgpu::BindGroupEntry& sourceBind = _bindEntries[0];
+		sourceBind.binding = 0;
+		sourceBind.textureView = source;
+
+		wgpu::BindGroupEntry& samplerBind = _bindEntries[1];
+		samplerBind.binding = 1;
+		samplerBind.sampler = _sampler;
+
+		wgpu::BindGroupEntry& paramsBind = _bindEntries[2];
+		paramsBind.binding = 2;
+		paramsBind.buffer = _params.Get();
+		paramsBind.offset = 0;
+		paramsBind.size = _params.Size();
+
+		wgpu::BindGroupDescriptor bindingDesc{};
+		bindingDesc.layout = _bindLayout;
+		bindingDesc.entryCount = k_UpscalePipelineBindingCount;
+		bindingDesc.entries = _bindEntries.data();
+		if (_bindGroup) _pDevice->Release(_bindGroup);
+		_bindGroup = _pDevice->CreateBindGroup(bindingDesc);
+	}
+
+	void UpscalePipeline::SetSourceRegion(wgpu::Extent3D region, wgpu::Extent3D sourceSize)
+	{
+		UpscaleUniforms uniforms;
+		uniforms.uvScale = Vec2f{ (float)region.width / (float)sourceSize.width, (float)region.height / (float)sourceSize.height };
+		uniforms.uvClamp = Vec2f{ ((float)region.width - 0.5f) / (float)sourceSize.width, ((float)region.height - 0.5f) / (float)sourceSize.height };
+		if (uniforms.uvScale == _uniforms.uvScale && uniforms.uvClamp == _uniforms.uvClamp) return;
+
+		_uniforms = uniforms;
+		_params.EnqueueCopy(&_uniforms, 0);
+	}
+
+	void UpscalePipeline::Draw(Gfx::RenderEncoder& pass)
+	{
+		pass.SetPipeline(_pipeline);
+		pass.SetBindGroup(0, _bindGroup);
+		pass.Draw(3, 1, 0, 0);
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include "webgpu.h"
+#include "MathDefs.h"
+#include "Buffer.h"
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	constexpr uint32_t k_UpscalePipelineBindingCount = 3;
+
+	//Laid out like Params in upscale.wgsl
+	struct UpscaleUniforms
+	{
+		Vec2f uvScale;
+		Vec2f uvClamp;
+	};
+	static_assert(sizeof(UpscaleUniforms) % 16 == 0);
+
+	//Bilinear stretch of the top left region of a texture over the whole target, one fullscreen triangle
+	class UpscalePipeline {
+	public:
+		UpscalePipeline(Gfx::Device& device, wgpu::ShaderModule shader, wgpu::TextureFormat targetFormat);
+		~UpscalePipeline();
+
+		//Has to be called again whenever the source view is recreated
+		void BindData(wgpu::TextureView source);
+
+		//Region of the source in texels that gets stretched, uploads only when it changed
+		void SetSourceRegion(wgpu::Extent3D region, wgpu::Extent3D sourceSize);
+
+		void Draw(Gfx::RenderEncoder& pass);
+
+	private:
+		//No copy, move
+		UpscalePipeline(UpscalePipeline const& other) = delete;
+		UpscalePipeline(UpscalePipeline&& other) = delete;
+		UpscalePipeline& operator=(UpscalePipeline const& other) = delete;
+		UpscalePipeline& operator=(UpscalePipeline&& other) = delete;
+
+		Gfx::Device* _pDevice;
+		wgpu::RenderPipeline _pipeline;
+		wgpu::PipelineLayout _pipelineLayout;
+		std::array<wgpu::BindGroupEntry, k_UpscalePipelineBindingCount> _bindEntries;
+		std::array<wgpu::BindGroupLayoutEntry, k_UpscalePipelineBindingCount> _bindLayouts;
+		wgpu::BindGroupLayout _bindLayout;
+		wgpu::BindGroup _bindGroup;
+		wgpu::Sampler _sampler;
+		Gfx::Buffer _params;
+		UpscaleUniforms _uniforms;
+	};
+}
@@ -2,11 +2,54 @@
 #include <filesystem>
 #include "ObjLoader.h"
 #include "ImageLoader.h"
-#include "fstream"
+#include "FontLoader.h"
 #include <string.h> //memcpy
+#include <algorithm>
+#include <cmath>
 
 namespace
 {
+	//Ritter's approximate sphere, at most ~20% bigger than the minimal one which is plenty for culling
+	BoundingSphere ComputeBoundingSphere(std::vector<InterleavedVertex const*> const& points)
+	{
+		BoundingSphere sphere;
+		if (points.empty()) return sphere;
+
+		auto distanceSquared = [](InterleavedVertex const& a, InterleavedVertex const& b) {
+			float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+			return dx * dx + dy * dy + dz * dz;
+		};
+		auto farthestFrom = [&](InterleavedVertex const& from) {
+			return *std::max_element(points.begin(), points.end(), [&](InterleavedVertex const* a, InterleavedVertex const* b) {
+				return distanceSquared(from, *a) < distanceSquared(from, *b);
+			});
+		};
+
+		//Start from the two points that are roughly farthest apart
+		InterleavedVertex const* pA = farthestFrom(*points[0]);
+		InterleavedVertex const* pB = farthestFrom(*pA);
+		sphere.x = (pA->x + pB->x) * 0.5f;
+		sphere.y = (pA->y + pB->y) * 0.5f;
+		sphere.z = (pA->z + pB->z) * 0.5f;
+		sphere.radius = std::sqrt(distanceSquared(*pA, *pB)) * 0.5f;
+
+		//Grow it just enough to take in every point outside
+		for (InterleavedVertex const* pPoint : points)
+		{
+			float dx = pPoint->x - sphere.x, dy = pPoint->y - sphere.y, dz = pPoint->z - sphere.z;
+			float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+			if (distance <= sphere.radius) continue;
+
+			float newRadius = (sphere.radius + distance) * 0.5f;
+			float shift = (newRadius - sphere.radius) / distance;
+			sphere.x += dx * shift;
+			sphere.y += dy * shift;
+			sphere.z += dz * shift;
+			sphere.radius = newRadius;
+		}
+		return sphere;
+	}
+
 
 	std::optional<Object> LoadGeometryObj_(std::filesystem::path const& path)
 	{
@@ -61,9 +104,22 @@ namespace
 				indexOffset += numVerticesInFace;
 			}
 
+			std::vector<InterleavedVertex const*> shapePoints;
+			shapePoints.reserve(shape.points.size());
+			for (InterleavedVertex const& point : shape.points) shapePoints.push_back(&point);
+			shape.bounds = ComputeBoundingSphere(shapePoints);
+
 			result.shapes.push_back(shape);
 		}
 
+		std::vector<InterleavedVertex const*> allPoints;
+		allPoints.reserve(numIndices);
+		for (Shape const& shape : result.shapes)
+		{
+			for (InterleavedVertex const& point : shape.points) allPoints.push_back(&point);
+		}
+		result.bounds = ComputeBoundingSphere(allPoints);
+
 		return result;
 	}
 
@@ -201,40 +257,47 @@ namespace Utils
 		return animationStrip;
 	}
 
-	std::optional<wgpu::ShaderModule> LoadShaderModule(std::filesystem::path const& path, wgpu::Device device)
+	std::optional<FontResource> BakeDefaultFont(float pixelHeight)
 	{
-		std::cout << "Attempting to load shader module: " << path << "\n";
-		std::ifstream file(path);
-		if (file.fail()) {
-			std::cerr << "Error Loading Shader: " << strerror(errno) << "\n";
+		nk_font_atlas atlas;
+		nk_font_atlas_init_default(&atlas);
+		nk_font_atlas_begin(&atlas);
+		nk_font* pFont = nk_font_atlas_add_default(&atlas, pixelHeight, nullptr);
+
+		int width = 0, height = 0;
+		void const* pPixels = nk_font_atlas_bake(&atlas, &width, &height, NK_FONT_ATLAS_RGBA32);
+		if (!pFont || !pPixels)
+		{
+			std::cout << "Failed to bake default font\n";
+			nk_font_atlas_clear(&atlas);
 			return std::nullopt;
 		}
 
-		file.seekg(0, std::ios::end);
-		size_t size = file.tellg();
-		std::string shaderSource(size, ' ');
-		file.seekg(0);
-
-		file.read(shaderSource.data(), size);
-
-		wgpu::ShaderModuleWGSLDescriptor wgslDesc{};
-		wgslDesc.chain.next = nullptr;
-		wgslDesc.chain.sType = wgpu::SType::ShaderModuleWGSLDescriptor;
-		wgslDesc.code = shaderSource.c_str();
+		FontResource font;
+		font.atlas = TextureResource{ (uint32_t)width, (uint32_t)height, 1, 4, {}, "DebugFont" };
+		font.atlas.data.resize(font.atlas.SizeBytes());
+		memcpy(font.atlas.data.data(), pPixels, font.atlas.SizeBytes());
+		font.lineHeight = pFont->info.height;
 
-		wgpu::ShaderModuleDescriptor desc{};
-		desc.hintCount = 0;
-		desc.hints = nullptr;
-		desc.nextInChain = &wgslDesc.chain;
+		//Frees the pixels, glyphs stay valid until the atlas is cleared
+		nk_font_atlas_end(&atlas, nk_handle_id(0), nullptr);
 
-		wgpu::ShaderModule module = device.createShaderModule(desc);
-		if (module)
+		for (uint32_t i = 0; i < k_fontGlyphCount; ++i)
 		{
-			return module;
-		}
-		else
-		{
-			return std::nullopt;
+			nk_font_glyph const* pGlyph = nk_font_find_glyph(pFont, (nk_rune)(k_firstFontGlyph + i));
+			GlyphResource& glyph = font.glyphs[i];
+			glyph.advance = pGlyph->xadvance;
+			glyph.x0 = pGlyph->x0;
+			glyph.y0 = pGlyph->y0;
+			glyph.x1 = pGlyph->x1;
+			glyph.y1 = pGlyph->y1;
+			glyph.u0 = pGlyph->u0;
+			glyph.v0 = pGlyph->v0;
+			glyph.u1 = pGlyph->u1;
+			glyph.v1 = pGlyph->v1;
 		}
+
+		nk_font_atlas_clear(&atlas);
+		return font;
 	}
 }
\ No newline at end of file
@@ -10,5 +10,10 @@ namespace Utils
 	std::optional<Object> LoadGeometry(std::filesystem::path const& path);
 	std::optional<TextureResource> LoadTexture(std::filesystem::path const& path);
 	std::optional<TextureResource> LoadAnimationTexture(std::filesystem::path const& folderPath);
-	std::optional<wgpu::ShaderModule> LoadShaderModule(std::filesystem::path const& path, wgpu::Device device);
+	//Copies rows of sourceBytesPerRow from pSource into pDestination starting columnOffsetBytes into each destination row,
+	//how LoadAnimationTexture packs frames side by side into a strip
+	void CopyIntoSquare(std::byte* pDestination, uint32_t destinationBytesPerRow, uint32_t columnOffsetBytes,
+		std::byte const* pSource, uint32_t sourceBytesPerRow, uint32_t bytesToCopy);
+	//Bakes the printable ascii range of the built in ProggyClean font into an atlas
+	std::optional<FontResource> BakeDefaultFont(float pixelHeight);
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "WgpuDevice.h"
+#include <cassert>
+
+namespace Gfx
+{
+	template<>
+	void WgpuRenderEncoder<wgpu::RenderPassEncoder>::ExecuteBundle(wgpu::RenderBundle bundle)
+	{
+		wgpuRenderPassEncoderExecuteBundles(handle, 1, (WGPURenderBundle const*)&bundle);
+	}
+
+	template<>
+	void WgpuRenderEncoder<wgpu::RenderBundleEncoder>::ExecuteBundle(wgpu::RenderBundle)
+	{
+		assert(false && "Render bundles can't execute other bundles");
+	}
+
+	template<>
+	void WgpuRenderEncoder<wgpu::RenderPassEncoder>::SetViewport(float x, float y, float width, float height)
+	{
+		handle.setViewport(x, y, width, height, 0.f, 1.f);
+	}
+
+	template<>
+	void WgpuRenderEncoder<wgpu::RenderBundleEncoder>::SetViewport(float, float, float, float)
+	{
+		assert(false && "Render bundles can't set the viewport");
+	}
+
+	WgpuDevice::WgpuDevice(wgpu::Device device, wgpu::Queue queue)
+		: _device(device)
+		, _queue(queue)
+	{
+	}
+
+	wgpu::Buffer WgpuDevice::CreateBuffer(wgpu::BufferDescriptor const& desc) { return _device.createBuffer(desc); }
+	wgpu::Texture WgpuDevice::CreateTexture(wgpu::TextureDescriptor const& desc) { return _device.createTexture(desc); }
+	wgpu::TextureView WgpuDevice::CreateTextureView(wgpu::Texture texture, wgpu::TextureViewDescriptor const& desc) { return texture.createView(desc); }
+	wgpu::Sampler WgpuDevice::CreateSampler(wgpu::SamplerDescriptor const& desc) { return _device.createSampler(desc); }
+	wgpu::ShaderModule WgpuDevice::CreateShaderModule(wgpu::ShaderModuleDescriptor const& desc) { return _device.createShaderModule(desc); }
+	wgpu::BindGroupLayout WgpuDevice::CreateBindGroupLayout(wgpu::BindGroupLayoutDescriptor const& desc) { return _device.createBindGroupLayout(desc); }
+	wgpu::BindGroup WgpuDevice::CreateBindGroup(wgpu::BindGroupDescriptor const& desc) { return _device.createBindGroup(desc); }
+	wgpu::PipelineLayout WgpuDevice::CreatePipelineLayout(wgpu::PipelineLayoutDescriptor const& desc) { return _device.createPipelineLayout(desc); }
+	wgpu::RenderPipeline WgpuDevice::CreateRenderPipeline(wgpu::RenderPipelineDescriptor const& desc) { return _device.createRenderPipeline(desc); }
+	wgpu::ComputePipeline WgpuDevice::CreateComputePipeline(wgpu::ComputePipelineDescriptor const& desc) { return _device.createComputePipeline(desc); }
+	wgpu::QuerySet WgpuDevice::CreateQuerySet(wgpu::QuerySetDescriptor const& desc) { return _device.createQuerySet(desc); }
+
+	void WgpuDevice::Release(wgpu::Buffer buffer)
+	{
+		buffer.destroy();
+		buffer.release();
+	}
+
+	void WgpuDevice::Release(wgpu::Texture texture)
+	{
+		texture.destroy();
+		texture.release();
+	}
+
+	void WgpuDevice::Release(wgpu::TextureView view) { view.release(); }
+	void WgpuDevice::Release(wgpu::Sampler sampler) { sampler.release(); }
+	void WgpuDevice::Release(wgpu::ShaderModule module) { module.release(); }
+	void WgpuDevice::Release(wgpu::BindGroupLayout layout) { layout.release(); }
+	void WgpuDevice::Release(wgpu::BindGroup bindGroup) { bindGroup.release(); }
+	void WgpuDevice::Release(wgpu::PipelineLayout layout) { layout.release(); }
+	void WgpuDevice::Release(wgpu::RenderPipeline pipeline) { pipeline.release(); }
+	void WgpuDevice::Release(wgpu::ComputePipeline pipeline) { pipeline.release(); }
+	void WgpuDevice::Release(wgpu::RenderBundle bundle) { bundle.release(); }
+
+	void WgpuDevice::Release(wgpu::QuerySet querySet)
+	{
+		querySet.destroy();
+		querySet.release();
+	}
+
+	void WgpuDevice::WriteBuffer(wgpu::Buffer buffer, uint64_t offset, void const* pData, size_t size)
+	{
+		_queue.writeBuffer(buffer, offset, pData, size);
+	}
+
+	void WgpuDevice::WriteTexture(wgpu::ImageCopyTexture const& destination, void const* pData, size_t size,
+		wgpu::TextureDataLayout const& layout, wgpu::Extent3D const& writeSize)
+	{
+		_queue.writeTexture(destination, pData, size, layout, writeSize);
+	}
+
+	wgpu::CommandEncoder WgpuDevice::BeginCommands(char const* label)
+	{
+		wgpu::CommandEncoderDescriptor encoderDesc{};
+		encoderDesc.label = label;
+		return _device.createCommandEncoder(encoderDesc);
+	}
+
+	RenderEncoder& WgpuDevice::BeginRenderPass(wgpu::CommandEncoder commands, wgpu::RenderPassDescriptor const& desc)
+	{
+		assert(!_renderPass.handle && "Previous render pass was not ended");
+		_renderPass.handle = commands.beginRenderPass(desc);
+		return _renderPass;
+	}
+
+	void WgpuDevice::EndRenderPass(RenderEncoder& pass)
+	{
+		assert(&pass == &_renderPass);
+		_renderPass.handle.end();
+		_renderPass.handle.release();
+		_renderPass.handle = nullptr;
+	}
+
+	ComputeEncoder& WgpuDevice::BeginComputePass(wgpu::CommandEncoder commands, wgpu::ComputePassDescriptor const& desc)
+	{
+		assert(!_computePass.handle && "Previous compute pass was not ended");
+		_computePass.handle = commands.beginComputePass(desc);
+		return _computePass;
+	}
+
+	void WgpuDevice::EndComputePass(ComputeEncoder& pass)
+	{
+		assert(&pass == &_computePass);
+		_computePass.handle.end();
+		_computePass.handle.release();
+		_computePass.handle = nullptr;
+	}
+
+	RenderEncoder& WgpuDevice::BeginRenderBundle(wgpu::RenderBundleEncoderDescriptor const& desc)
+	{
+		assert(!_renderBundle.handle && "Previous render bundle was not finished");
+		_renderBundle.handle = _device.createRenderBundleEncoder(desc);
+		return _renderBundle;
+	}
+
+	wgpu::RenderBundle WgpuDevice::FinishRenderBundle(RenderEncoder& bundle, wgpu::RenderBundleDescriptor const& desc)
+	{
+		assert(&bundle == &_renderBundle);
+		wgpu::RenderBundle result = _renderBundle.handle.finish(desc);
+		_renderBundle.handle.release();
+		_renderBundle.handle = nullptr;
+		return result;
+	}
+
+	void WgpuDevice::CopyBufferToBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t sourceOffset,
+		wgpu::Buffer destination, uint64_t destinationOffset, uint64_t size)
+	{
+		commands.copyBufferToBuffer(source, sourceOffset, destination, destinationOffset, size);
+	}
+
+	void WgpuDevice::CopyBufferToTexture(wgpu::CommandEncoder commands, wgpu::ImageCopyBuffer const& source,
+		wgpu::ImageCopyTexture const& destination, wgpu::Extent3D const& copySize)
+	{
+		commands.copyBufferToTexture(source, destination, copySize);
+	}
+
+	void WgpuDevice::CopyTextureToBuffer(wgpu::CommandEncoder commands, wgpu::ImageCopyTexture const& source,
+		wgpu::ImageCopyBuffer const& destination, wgpu::Extent3D const& copySize)
+	{
+		commands.copyTextureToBuffer(source, destination, copySize);
+	}
+
+	void WgpuDevice::ResolveQuerySet(wgpu::CommandEncoder commands, wgpu::QuerySet querySet, uint32_t firstQuery, uint32_t queryCount,
+		wgpu::Buffer destination, uint64_t destinationOffset)
+	{
+		commands.resolveQuerySet(querySet, firstQuery, queryCount, destination, destinationOffset);
+	}
+
+	void WgpuDevice::Submit(wgpu::CommandEncoder commands)
+	{
+		wgpu::CommandBufferDescriptor commandBufferDescriptor{};
+		commandBufferDescriptor.label = "Default Command Buffer";
+		wgpu::CommandBuffer commandBuffer = commands.finish(commandBufferDescriptor);
+		_queue.submit(commandBuffer);
+
+		commandBuffer.release();
+		commands.release();
+	}
+
+	void WgpuDevice::MapRead(wgpu::Buffer buffer, uint64_t offset, uint64_t size, MapReadCallback onMapped)
+	{
+		struct MapContext
+		{
+			wgpu::Buffer buffer;
+			uint64_t offset;
+			uint64_t size;
+			MapReadCallback onMapped;
+		};
+
+		auto onBufferMapped = [](WGPUBufferMapAsyncStatus status, void* pUserData)
+		{
+			MapContext* pContext = reinterpret_cast<MapContext*>(pUserData);
+			if (status == WGPUBufferMapAsyncStatus_Success)
+			{
+				pContext->onMapped(wgpuBufferGetConstMappedRange(pContext->buffer, pContext->offset, pContext->size), pContext->size);
+				wgpuBufferUnmap(pContext->buffer);
+			}
+			else
+			{
+				pContext->onMapped(nullptr, 0);
+			}
+			delete pContext;
+		};
+
+		MapContext* pContext = new MapContext{ buffer, offset, size, std::move(onMapped) };
+		wgpuBufferMapAsync(buffer, WGPUMapMode_Read, offset, size, onBufferMapped, pContext);
+	}
+
+	void WgpuDevice::Poll()
+	{
+#ifdef WEBGPU_BACKEND_WGPU
+		wgpuDevicePoll(_device, false, nullptr);
+#else
+		wgpuDeviceTick(_device);
+#endif
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "GfxDevice.h"
+
+namespace Gfx
+{
+	//Render commands straight into a webgpu render pass or render bundle encoder
+	template<typename Encoder>
+	class WgpuRenderEncoder final : public RenderEncoder {
+	public:
+		void SetPipeline(wgpu::RenderPipeline pipeline) override { handle.setPipeline(pipeline); }
+		void SetBindGroup(uint32_t groupIndex, wgpu::BindGroup bindGroup) override { handle.setBindGroup(groupIndex, bindGroup, 0, nullptr); }
+		void SetVertexBuffer(uint32_t slot, wgpu::Buffer buffer, uint64_t offset, uint64_t size) override { handle.setVertexBuffer(slot, buffer, offset, size); }
+		void SetIndexBuffer(wgpu::Buffer buffer, wgpu::IndexFormat format, uint64_t offset, uint64_t size) override { handle.setIndexBuffer(buffer, format, offset, size); }
+		void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override {
+			handle.draw(vertexCount, instanceCount, firstVertex, firstInstance);
+		}
+		void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) override {
+			handle.drawIndexed(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+		}
+		void DrawIndirect(wgpu::Buffer indirectBuffer, uint64_t offset) override { handle.drawIndirect(indirectBuffer, offset); }
+		void DrawIndexedIndirect(wgpu::Buffer indirectBuffer, uint64_t offset) override { handle.drawIndexedIndirect(indirectBuffer, offset); }
+		void ExecuteBundle(wgpu::RenderBundle bundle) override;
+		void SetViewport(float x, float y, float width, float height) override;
+
+		Encoder handle = nullptr;
+	};
+
+	class WgpuComputeEncoder final : public ComputeEncoder {
+	public:
+		void SetPipeline(wgpu::ComputePipeline pipeline) override { handle.setPipeline(pipeline); }
+		void SetBindGroup(uint32_t groupIndex, wgpu::BindGroup bindGroup) override { handle.setBindGroup(groupIndex, bindGroup, 0, nullptr); }
+		void DispatchWorkgroups(uint32_t x, uint32_t y, uint32_t z) override { handle.dispatchWorkgroups(x, y, z); }
+
+		wgpu::ComputePassEncoder handle = nullptr;
+	};
+
+	//Forwards everything to a real webgpu device and its default queue
+	class WgpuDevice final : public Device {
+	public:
+		WgpuDevice(wgpu::Device device, wgpu::Queue queue);
+
+		wgpu::Buffer CreateBuffer(wgpu::BufferDescriptor const& desc) override;
+		wgpu::Texture CreateTexture(wgpu::TextureDescriptor const& desc) override;
+		wgpu::TextureView CreateTextureView(wgpu::Texture texture, wgpu::TextureViewDescriptor const& desc) override;
+		wgpu::Sampler CreateSampler(wgpu::SamplerDescriptor const& desc) override;
+		wgpu::ShaderModule CreateShaderModule(wgpu::ShaderModuleDescriptor const& desc) override;
+		wgpu::BindGroupLayout CreateBindGroupLayout(wgpu::BindGroupLayoutDescriptor const& desc) override;
+		wgpu::BindGroup CreateBindGroup(wgpu::BindGroupDescriptor const& desc) override;
+		wgpu::PipelineLayout CreatePipelineLayout(wgpu::PipelineLayoutDescriptor const& desc) override;
+		wgpu::RenderPipeline CreateRenderPipeline(wgpu::RenderPipelineDescriptor const& desc) override;
+		wgpu::ComputePipeline CreateComputePipeline(wgpu::ComputePipelineDescriptor const& desc) override;
+		wgpu::QuerySet CreateQuerySet(wgpu::QuerySetDescriptor const& desc) override;
+
+		void Release(wgpu::Buffer buffer) override;
+		void Release(wgpu::Texture texture) override;
+		void Release(wgpu::TextureView view) override;
+		void Release(wgpu::Sampler sampler) override;
+		void Release(wgpu::ShaderModule module) override;
+		void Release(wgpu::BindGroupLayout layout) override;
+		void Release(wgpu::BindGroup bindGroup) override;
+		void Release(wgpu::PipelineLayout layout) override;
+		void Release(wgpu::RenderPipeline pipeline) override;
+		void Release(wgpu::ComputePipeline pipeline) override;
+		void Release(wgpu::RenderBundle bundle) override;
+		void Release(wgpu::QuerySet querySet) override;
+
+		void WriteBuffer(wgpu::Buffer buffer, uint64_t offset, void const* pData, size_t size) override;
+		void WriteTexture(wgpu::ImageCopyTexture const& destination, void const* pData, size_t size,
+			wgpu::TextureDataLayout const& layout, wgpu::Extent3D const& writeSize) override;
+
+		wgpu::CommandEncoder BeginCommands(char const* label) override;
+		RenderEncoder& BeginRenderPass(wgpu::CommandEncoder commands, wgpu::RenderPassDescriptor const& desc) override;
+		void EndRenderPass(RenderEncoder& pass) override;
+		ComputeEncoder& BeginComputePass(wgpu::CommandEncoder commands, wgpu::ComputePassDescriptor const& desc) override;
+		void EndComputePass(ComputeEncoder& pass) override;
+		RenderEncoder& BeginRenderBundle(wgpu::RenderBundleEncoderDescriptor const& desc) override;
+		wgpu::RenderBundle FinishRenderBundle(RenderEncoder& bundle, wgpu::RenderBundleDescriptor const& desc) override;
+		void CopyBufferToBuffer(wgpu::CommandEncoder commands, wgpu::Buffer source, uint64_t sourceOffset,
+			wgpu::Buffer destination, uint64_t destinationOffset, uint64_t size) override;
+		void CopyBufferToTexture(wgpu::CommandEncoder commands, wgpu::ImageCopyBuffer const& source,
+			wgpu::ImageCopyTexture const& destination, wgpu::Extent3D const& copySize) override;
+		void CopyTextureToBuffer(wgpu::CommandEncoder commands, wgpu::ImageCopyTexture const& source,
+			wgpu::ImageCopyBuffer const& destination, wgpu::Extent3D const& copySize) override;
+		void ResolveQuerySet(wgpu::CommandEncoder commands, wgpu::QuerySet querySet, uint32_t firstQuery, uint32_t queryCount,
+			wgpu::Buffer destination, uint64_t destinationOffset) override;
+		void Submit(wgpu::CommandEncoder commands) override;
+
+		void MapRead(wgpu::Buffer buffer, uint64_t offset, uint64_t size, MapReadCallback onMapped) override;
+		void Poll() override;
+
+		inline wgpu::Device Get() const noexcept { return _device; }
+		inline wgpu::Queue Queue() const noexcept { return _queue; }
+
+	private:
+		wgpu::Device _device;
+		wgpu::Queue _queue;
+		WgpuRenderEncoder<wgpu::RenderPassEncoder> _renderPass;
+		WgpuRenderEncoder<wgpu::RenderBundleEncoder> _renderBundle;
+		WgpuComputeEncoder _computePass;
+	};
+}
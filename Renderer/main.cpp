@@ -1,43 +1,64 @@
 ﻿// Defines the entry point for the application.
 #include <iostream>
+#include <cstdio>
+#include <cstring>
 
 #include "webgpu.h"
 #include "Utils.h"
 #include <glfw3webgpu.h>
 #include <array>
+#include <algorithm>
+#include <vector>
 #include "MathDefs.h"
 #include "MeshDefs.h"
 #include "Buffer.h"
 #include "Texture.h"
 #include "Quad.h"
 #include "QuadRenderPipeline.h"
+#include "DrawList.h"
+#include "WgpuDevice.h"
+#include "TerrainRenderer.h"
+#include "TilemapRenderer.h"
+#include "DebugText.h"
+#include "DynamicResolution.h"
+#include "UpscalePipeline.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+#include "FrameArena.h"
+#include "GpuProfiler.h"
+#include "ReadbackRing.h"
+#include "FrameCapture.h"
+#include "JobSystem.h"
+#include "Simulation.h"
 #include "QuadDefs.h"
 #include "Terrain.h"
 #include "Chrono.h"
+#include "FrameStats.h"
 #include "ResourceManager.h"
 #include "Renderer.h"
-
-struct Uniforms
-{
-	Mat4f projection;
-	Mat4f view;
-	Mat4f model;
-	Vec4f color;
-	float time;
-	float _pad[3] = {0.f,0.f,0.f}; //struct must be 16byte aligned
-};
-static_assert(sizeof(Uniforms) % 16 == 0);
+#include "MeshRenderer.h"
+#include "ShaderCache.h"
+#include "TextureUploader.h"
 
 constexpr uint32_t k_mbBytes = 1024 * 1024;
-
-uint32_t CeilToNextMultiple(uint32_t value, uint32_t multiple)
-{
-	uint32_t divideAndCeil = value / multiple + (value % multiple == 0 ? 0 : 1);
-	return multiple * divideAndCeil;
-}
+constexpr Gfx::QuadGeometry k_quadGeometry = Gfx::QuadGeometry::VertexPulling;
+//Mode at startup, F3 switches between quads and the tilemap
+constexpr TerrainDrawMode k_terrainDrawMode = TerrainDrawMode::Quads;
+//Written on exit and when F2 is pressed, .json for json
+constexpr char const* k_frameStatsPath = "FrameStats.csv";
+//F12 saves a screenshot, F11 records a sequence of frames. Both capture the scene before the overlay
+constexpr char const* k_capturePath = "Captures";
+constexpr uint32_t k_captureSequenceFrames = 120;
+//Full frame captures are read back in one buffer, 4k with padded rows fits
+constexpr uint32_t k_maxReadbackBytes = 64 * k_mbBytes;
+//Pyramids laid out on a square grid, wider than the view so culling has something to do
+constexpr uint32_t k_meshGridSize = 16;
+constexpr float k_meshGridSpacing = 1.2f;
 
 int main()
 {
+	PROFILE_THREAD("Main");
+
 	if (!glfwInit())
 	{
 		std::cerr << "Could not initialize GLFW \n";
@@ -46,7 +67,10 @@ int main()
 
 	//We want to destruct everything in here before calling glfwTerminate
 	{
+		//Filled by the window's callbacks during glfwPollEvents, drained by the simulation thread
+		InputQueue input;
 		Window window;
+		window.RouteInput(input);
 
 		wgpu::InstanceDescriptor desc{};
 		wgpu::Instance instance = wgpu::createInstance(desc);
@@ -75,6 +99,11 @@ int main()
 			std::cout << " - " << feature << "\n";
 		}
 
+		//Pass timings are optional, without the feature only cpu scopes get recorded
+		bool const gpuTimestamps = adapter.hasFeature(wgpu::FeatureName::TimestampQuery);
+		std::vector<wgpu::FeatureName> requiredFeatures;
+		if (gpuTimestamps) requiredFeatures.push_back(wgpu::FeatureName::TimestampQuery);
+
 		wgpu::SupportedLimits adapterLimits;
 		adapter.getLimits(&adapterLimits);
 		std::cout << "adapter.maxVertexAttributes: " << adapterLimits.limits.maxVertexAttributes << "\n";
@@ -83,18 +112,18 @@ int main()
 		wgpu::RequiredLimits requiredDeviceLimits = wgpu::Default;
 		requiredDeviceLimits.limits.maxVertexAttributes = 3;
 		requiredDeviceLimits.limits.maxVertexBuffers = 1;
-		requiredDeviceLimits.limits.maxBufferSize = k_mbBytes;
-		requiredDeviceLimits.limits.maxVertexBufferArrayStride = sizeof(Gfx::QuadVertex);
+		requiredDeviceLimits.limits.maxBufferSize = k_maxReadbackBytes;
+		requiredDeviceLimits.limits.maxVertexBufferArrayStride = (uint32_t)std::max(sizeof(Gfx::QuadVertex), sizeof(InterleavedVertex));
 		requiredDeviceLimits.limits.maxInterStageShaderComponents = 6; // everything other than default position needs to be under this max
 		requiredDeviceLimits.limits.maxBindGroups = 1;
 		requiredDeviceLimits.limits.maxBindingsPerBindGroup = 10;
 		requiredDeviceLimits.limits.maxUniformBuffersPerShaderStage = 3;
-		requiredDeviceLimits.limits.maxUniformBufferBindingSize = 100 * sizeof(AnimUniform);
 		requiredDeviceLimits.limits.maxDynamicUniformBuffersPerPipelineLayout = 1;
 		requiredDeviceLimits.limits.maxTextureDimension1D = k_screenHeight;
-		requiredDeviceLimits.limits.maxTextureDimension2D = k_screenWidth;
+		//Window is resizable, render targets follow it
+		requiredDeviceLimits.limits.maxTextureDimension2D = adapterLimits.limits.maxTextureDimension2D;
 		requiredDeviceLimits.limits.maxTextureArrayLayers = 2;
-		requiredDeviceLimits.limits.maxSampledTexturesPerShaderStage = 1;
+		requiredDeviceLimits.limits.maxSampledTexturesPerShaderStage = 2; //Tilemap reads tile indices and animations
 		requiredDeviceLimits.limits.maxSamplersPerShaderStage = 1;
 
 		//Must be set even if we don't use em yet
@@ -105,14 +134,14 @@ int main()
 		deviceDescriptor.label = "Default Device";
 		deviceDescriptor.defaultQueue.label = "Default Queue";
 		deviceDescriptor.requiredLimits = &requiredDeviceLimits;
+		deviceDescriptor.requiredFeatureCount = requiredFeatures.size();
+		deviceDescriptor.requiredFeatures = (WGPUFeatureName const*)requiredFeatures.data();
 		wgpu::Device device = adapter.requestDevice(deviceDescriptor);
 
 		wgpu::SupportedLimits deviceLimits;
 		device.getLimits(&deviceLimits);
 		std::cout << "device.maxVertexAttributes: " << deviceLimits.limits.maxVertexAttributes << "\n";
 
-		uint32_t uniformStride = CeilToNextMultiple((uint32_t)sizeof(Uniforms), (uint32_t)deviceLimits.limits.minUniformBufferOffsetAlignment);
-
 		auto onDeviceError = [](wgpu::ErrorType type, char const* message) {
 			std::cout << "Uncaptured Device error: type-" << type;
 			if (message) std::cout << " (" << message << ")";
@@ -123,6 +152,9 @@ int main()
 		auto pErrorCallback = device.setUncapturedErrorCallback(onDeviceError);
 
 		wgpu::Queue queue = device.getQueue();
+		Gfx::WgpuDevice gfxDevice(device, queue);
+		std::optional<Gfx::GpuProfiler> gpuProfiler;
+		if (gpuTimestamps) gpuProfiler.emplace(gfxDevice);
 
 		//disabled for now due to causing crashes on surface.configure
 		//auto onQueueWorkDone = [](wgpu::QueueWorkDoneStatus status) {
@@ -130,37 +162,21 @@ int main()
 		//};
 		//queue.onSubmittedWorkDone(onQueueWorkDone);
 
-		float angle1 = 2.0f; //arbitrary
 		float angle2 = 3.0f * PI / 4.0f;
 		Vec3f focalPoint = { 0.0f, 0.0f, -2.0f };
 
 		Mat4f scale = glm::scale(Mat4f(1.0f), Vec3f(0.3f));
 		Mat4f translation1 = glm::translate(Mat4f(1.0f), Vec3f(0.5f, 0.f, 0.f));
-		Mat4f rotation1 = glm::rotate(Mat4f(1.0f), angle1, Vec3f(0.0f, 0.0f, 1.0f));
 
 		Mat4f translation2 = glm::translate(Mat4f(1.0f), -focalPoint);
 		Mat4f rotation2 = glm::rotate(Mat4f(1.0f), angle2, Vec3f(1.0f, 0.0f, 0.0f));
 
 		float focalLength = 2.0f;
 		float fov = 2.0f * glm::atan(1.0f, focalLength);
-		float ratio = (float)k_screenWidth / (float)k_screenHeight;
 		float nearPlane = 0.01f;
 		float farPlane = 100.0f;
-
-		Uniforms uniform
-		{
-			.projection = glm::perspective(fov, ratio, nearPlane, farPlane),
-			.view = translation2 * rotation2,
-			.model = rotation1 * translation1 * scale, //rotation after translation to orbit
-			.color{0.0f, 1.0f, 0.4f, 1.0f},
-			.time{1.0f}
-		};
-
-		Gfx::Buffer uniformBuffer(
-			uniformStride + sizeof(Uniforms),
-			wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-			"Uniform Buffer",
-			device);
+		Mat4f const meshView = translation2 * rotation2;
+		Vec4f const meshColor{ 0.0f, 1.0f, 0.4f, 1.0f };
 
 		wgpu::TextureFormat swapChainFormat = surface.getPreferredFormat(adapter);
 		if (swapChainFormat == wgpu::TextureFormat::Undefined) swapChainFormat = wgpu::TextureFormat::BGRA8Unorm;
@@ -184,8 +200,8 @@ int main()
 		quadCam.position = Vec2f{ 0.5f, 0.5f };
 		quadCam.extents = Vec2f{ (float)k_screenWidth, (float)k_screenHeight };
 
-		Gfx::Buffer camBuffer{ sizeof(CamUniforms), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform, "Camera Uniforms", device};
-		camBuffer.EnqueueCopy(&quadCam, 0, queue);
+		Gfx::Buffer camBuffer{ sizeof(CamUniforms), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform | wgpu::BufferUsage::Storage, "Camera Uniforms", gfxDevice};
+		camBuffer.EnqueueCopy(&quadCam, 0);
 
 		std::cout << "Configured Surface\n";
 
@@ -203,7 +219,9 @@ int main()
 		colorTarget.writeMask = wgpu::ColorWriteMask::All;
 
 		std::filesystem::path const assetsBasePath(ASSETS_DIR);
-		auto oQuadShaderModule = Utils::LoadShaderModule(assetsBasePath / "quadShader.wgsl", device);
+		//Holds every module, pipelines only need them while they're created
+		Gfx::ShaderCache shaderCache(gfxDevice);
+		auto oQuadShaderModule = shaderCache.Load(assetsBasePath / "quadShader.wgsl");
 		if (!oQuadShaderModule)
 		{
 			std::cout << "Failed to create Quad Shader Module" << std::endl;
@@ -220,9 +238,16 @@ int main()
 		depthStencilState.stencilReadMask = 0;
 		depthStencilState.stencilWriteMask = 0;
 
+		//Texture uploads are batched into one staging buffer and copied at the start of the next frame's commands
+		Gfx::TextureUploader textureUploads(gfxDevice);
+
+		//This thread is worker 0, the rest are spawned here
+		Jobs::JobSystem jobs;
+		std::cout << "Job workers: " << jobs.WorkerCount() << "\n";
+
 		//Temp animation load
 		ResourceManager resources;
-		resources.LoadAllAnimations(assetsBasePath);
+		resources.LoadAllAnimations(assetsBasePath, &jobs);
 		auto anim = resources.GetAnimation("cell1");
 		//Upload anim strip
 		Gfx::Texture animTex{
@@ -232,14 +257,14 @@ int main()
 			anim.numChannels,
 			anim.channelDepthBytes,
 			wgpu::TextureFormat::RGBA8Unorm,
-			device,
+			gfxDevice,
 			"animation"
 		};
-		animTex.EnqueueCopy(anim.data.data(), anim.Extents(), queue);
+		textureUploads.Enqueue(animTex, anim.data.data(), anim.Extents());
 
 		//Load other animations and offset copy
 		TextureResource const& texture2 = resources.GetAnimation("cell2");
-		animTex.EnqueueCopy(texture2.data.data(), texture2.Extents(), queue, {0,0,1});
+		textureUploads.Enqueue(animTex, texture2.data.data(), texture2.Extents(), {0,0,1});
 
 		//wgpu::SamplerDescriptor spriteSamplerDesc;
 		//spriteSamplerDesc.addressModeU = wgpu::AddressMode::ClampToEdge;
@@ -254,96 +279,206 @@ int main()
 		//spriteSamplerDesc.maxAnisotropy = 1;
 		//wgpu::Sampler spriteSampler = device.createSampler(spriteSamplerDesc);
 
-		Gfx::QuadRenderPipeline quadPipeline(device, quadShaderModule, colorTarget, depthStencilState);
-
-		Terrain terrain(10, 10, 50);
-
-		Gfx::Buffer transformBuffer{(uint32_t)(terrain.Cells().size() * sizeof(QuadTransform)), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-			"Transform Buffer", device};
-		transformBuffer.EnqueueCopy(terrain.Cells().data(), 0, queue);
-
-		Gfx::Buffer animationBuffer{(uint32_t)(terrain.CellAnimations().size() * sizeof(AnimUniform)), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-			"Animations", device };
-		animationBuffer.EnqueueCopy(terrain.CellAnimations().data(), 0, queue);
-
-		quadPipeline.BindData(transformBuffer, animTex, camBuffer, animationBuffer, device);
-
-		//Create depth texture and depth texture view
-		Gfx::Texture depthTexture(wgpu::TextureDimension::_2D, { surfaceConfig.width, surfaceConfig.height, 1 },
-			wgpu::TextureUsage::RenderAttachment, 1, 3/*24 bit depth*/, depthTextureFormat, device, "depth");
-
-		wgpu::TextureViewDescriptor depthTextureViewDesc;
-		depthTextureViewDesc.aspect = wgpu::TextureAspect::DepthOnly;
-		depthTextureViewDesc.baseArrayLayer = 0;
-		depthTextureViewDesc.arrayLayerCount = 1;
-		depthTextureViewDesc.baseMipLevel = 0;
-		depthTextureViewDesc.mipLevelCount = 1;
-		depthTextureViewDesc.dimension = wgpu::TextureViewDimension::_2D;
-		depthTextureViewDesc.format = depthTextureFormat;
-		wgpu::TextureView depthTextureView = depthTexture.Get().createView(depthTextureViewDesc);
-
-		//Temp buffer data
-		uint32_t k_bufferSize = 16;
-		std::vector<uint8_t> numbers(k_bufferSize);
-		for (uint8_t i = 0; i < k_bufferSize; ++i) numbers[i] = i;
+		//Gpu culling, compacts visible cells and writes the instance count of the indirect draw
+		Gfx::ShaderDefine const cullDefines[] = { { "k_cullWorkgroupSize", std::to_string(Gfx::k_cullWorkgroupSize) } };
+		auto oQuadCullShaderModule = shaderCache.Load(assetsBasePath / "quadCull.wgsl", cullDefines);
+		if (!oQuadCullShaderModule)
+		{
+			std::cout << "Failed to create Quad Cull Shader Module" << std::endl;
+			return -1;
+		}
 
-		//Create Buffer
-		Gfx::Buffer buffer1{ k_bufferSize, wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc, "buffer1", device };
-		Gfx::Buffer buffer2{ k_bufferSize, wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead, "buffer2", device };
+		//Sprite frames are advanced on the gpu from the animation tick
+		Gfx::ShaderDefine const animDefines[] = { { "k_spriteAnimWorkgroupSize", std::to_string(Gfx::k_spriteAnimWorkgroupSize) } };
+		auto oSpriteAnimShaderModule = shaderCache.Load(assetsBasePath / "spriteAnim.wgsl", animDefines);
+		if (!oSpriteAnimShaderModule)
+		{
+			std::cout << "Failed to create Sprite Anim Shader Module" << std::endl;
+			return -1;
+		}
 
-		//Add instruction to copy to buffer
-		buffer1.EnqueueCopy(numbers.data(), 0, queue);
+		auto oTilemapShaderModule = shaderCache.Load(assetsBasePath / "tilemap.wgsl");
+		if (!oTilemapShaderModule)
+		{
+			std::cout << "Failed to create Tilemap Shader Module" << std::endl;
+			return -1;
+		}
 
-		std::cout << "Sending buffer copy operation... " << std::endl;
+		//Both renderers are kept so the mode can be switched, only the active one records anything each frame
+		Terrain terrain(10, 10, 50, &jobs);
+		TerrainRenderer terrainRenderer(gfxDevice, terrain, animTex, camBuffer, quadShaderModule, *oQuadCullShaderModule, *oSpriteAnimShaderModule,
+			colorTarget, depthStencilState, k_quadGeometry);
+		TilemapRenderer tilemapRenderer(gfxDevice, terrain, animTex, camBuffer, *oTilemapShaderModule, colorTarget, depthStencilState);
+		TerrainDrawMode terrainDrawMode = k_terrainDrawMode;
+
+		//On screen stats, the font is baked once at startup
+		auto oDebugFont = Utils::BakeDefaultFont(13.f);
+		auto oTextShaderModule = shaderCache.Load(assetsBasePath / "textShader.wgsl");
+		if (!oDebugFont || !oTextShaderModule)
+		{
+			std::cout << "Failed to create Debug Text" << std::endl;
+			return -1;
+		}
+		//Text goes in the overlay pass at native resolution, which has no depth
+		Gfx::DebugText debugText(gfxDevice, *oDebugFont, *oTextShaderModule, swapChainFormat, wgpu::TextureFormat::Undefined);
 
-		//Copy buffer1 to buffer2
-		wgpu::CommandEncoderDescriptor encoderDesc1{};
-		encoderDesc1.label = "Default Command Encoder";
-		wgpu::CommandEncoder copyEncoder = device.createCommandEncoder(encoderDesc1);
-		copyEncoder.copyBufferToBuffer(buffer1.Get(), 0, buffer2.Get(), 0, k_bufferSize);
+		//The scene renders offscreen at a scale picked to hold the frame time, then gets stretched over the swap chain
+		auto oUpscaleShaderModule = shaderCache.Load(assetsBasePath / "upscale.wgsl");
+		if (!oUpscaleShaderModule)
+		{
+			std::cout << "Failed to create Upscale Shader Module" << std::endl;
+			return -1;
+		}
+		Gfx::ScaledRenderTarget sceneTarget(gfxDevice, swapChainFormat, depthTextureFormat);
+		sceneTarget.Resize(surfaceConfig.width, surfaceConfig.height);
+		Gfx::UpscalePipeline upscalePipeline(gfxDevice, *oUpscaleShaderModule, swapChainFormat);
+		upscalePipeline.BindData(sceneTarget.ColorView());
+		Gfx::ResolutionController resolutionController;
+
+		//Every pyramid is one instance of the same draw, only the ones inside the view get uploaded
+		auto oMeshShaderModule = shaderCache.Load(assetsBasePath / "shader.wgsl");
+		auto oPyramid = Utils::LoadGeometry(assetsBasePath / "pyramid.obj");
+		if (!oMeshShaderModule || !oPyramid)
+		{
+			std::cout << "Failed to create Mesh Renderer" << std::endl;
+			return -1;
+		}
+		MeshRenderer meshRenderer(gfxDevice, *oPyramid, *oMeshShaderModule, colorTarget, depthStencilState, k_meshGridSize * k_meshGridSize);
+
+		//Terrain animation and the mesh instances are simulated on their own thread, the frame loop only draws the
+		//newest snapshot. From here on the terrain's animation state belongs to that thread.
+		//Space pauses the pyramids' orbit and scrolling changes its speed
+		float orbitAngle = 0.f;
+		float orbitSpeed = 1.f;
+		bool orbitPaused = false;
+		SimulationThread simulation(
+			[&terrain, &orbitAngle, &orbitSpeed, &orbitPaused](uint64_t, float fixedDelta, std::span<InputEvent const> events) {
+				for (InputEvent const& event : events)
+				{
+					if (event.type == InputEventType::Key && event.code == GLFW_KEY_SPACE && event.action == GLFW_PRESS) orbitPaused = !orbitPaused;
+					else if (event.type == InputEventType::Scroll) orbitSpeed = std::clamp(orbitSpeed + 0.25f * event.value.y, 0.f, 8.f);
+				}
+				terrain.Animate();
+				if (!orbitPaused) orbitAngle += orbitSpeed * fixedDelta;
+			},
+			[&](FrameSnapshot& snapshot) {
+				snapshot.animTick = terrain.AnimTick();
+				//Each pyramid orbits its grid cell, rotation after translation to orbit
+				snapshot.meshModels.resize(k_meshGridSize * k_meshGridSize);
+				for (uint32_t y = 0; y < k_meshGridSize; ++y)
+				{
+					for (uint32_t x = 0; x < k_meshGridSize; ++x)
+					{
+						float const halfGrid = 0.5f * (k_meshGridSize - 1) * k_meshGridSpacing;
+						Mat4f const cell = glm::translate(Mat4f(1.0f), Vec3f(x * k_meshGridSpacing - halfGrid, y * k_meshGridSpacing - halfGrid, 0.f));
+						float const angle = orbitAngle + 0.37f * (x + y * k_meshGridSize); //arbitrary phase
+						Mat4f const rotation = glm::rotate(Mat4f(1.0f), angle, Vec3f(0.0f, 0.0f, 1.0f));
+						snapshot.meshModels[x + y * k_meshGridSize] = cell * rotation * translation1 * scale;
+					}
+				}
+			},
+			&input);
+
+		//Gpu results (visible quad count, captures) come back through here a few frames late.
+		//A capture sequence holds a slot for every frame in flight, so there are more than the default
+		Gfx::ReadbackRing readbacks(gfxDevice, 2 * Gfx::k_readbackSlots);
+		uint32_t visibleQuads = 0;
+		Gfx::FrameCapture frameCapture(readbacks);
+		uint32_t screenshotCount = 0;
+		bool screenshotKeyWasDown = false;
+		bool sequenceKeyWasDown = false;
+
+		//Dynamic draws are recorded into the draw list each frame and sorted by key before encoding,
+		//static terrain draws live in the terrain renderer's bundle
+		Gfx::DrawList drawList(&jobs);
+		//Per frame scratch (draw sort, mesh culling) is bumped from here instead of the heap
+		Memory::FrameArena frameArena;
+
+		FrameStats frameStats;
+		//Render thread heap allocations, only counted when built with RENDERER_TRACK_ALLOCATIONS
+		Memory::AllocationCounters frameAllocationStart = Memory::ThreadAllocations();
+		bool dumpKeyWasDown = false;
+		bool drawModeKeyWasDown = false;
 
-		wgpu::CommandBufferDescriptor commandBufferDescriptor1{};
-		commandBufferDescriptor1.label = "Default Command Buffer";
-		wgpu::CommandBuffer copyCommands = copyEncoder.finish(commandBufferDescriptor1);
-		queue.submit(copyCommands);
+		while (!window.ShouldClose())
+		{
+			PROFILE_SCOPE("Frame");
+			Clock::FrameClock& frameClock = Clock::Get();
+			frameClock.Tick();
+			float deltaTime = frameClock.GetDelta();
+			frameArena.NextFrame();
 
-		copyCommands.release();
+			Memory::AllocationCounters const allocationsNow = Memory::ThreadAllocations();
+			Memory::AllocationCounters const lastFrameAllocations = allocationsNow - frameAllocationStart;
+			frameAllocationStart = allocationsNow;
 
-		struct BufferMappedContext
-		{
-			wgpu::Buffer buffer;
-			uint32_t bufferSize;
-		};
+			glfwPollEvents();
+			frameStats.AddFrame(deltaTime);
 
-		auto onBuffer2Mapped = [](WGPUBufferMapAsyncStatus status, void* pUserData)
-		{
-			BufferMappedContext* pContext = reinterpret_cast<BufferMappedContext*>(pUserData);
-			std::cout << "Buffer 2 Mapped with status: " << status << "\n";
+			bool const dumpKeyDown = glfwGetKey(window.get(), GLFW_KEY_F2) == GLFW_PRESS;
+			if (dumpKeyDown && !dumpKeyWasDown) frameStats.Write(k_frameStatsPath);
+			dumpKeyWasDown = dumpKeyDown;
 
-			if (status != wgpu::BufferMapAsyncStatus::Success || pContext == nullptr) return;
-			//uint8_t* pBufferData = (uint8_t*)pContext->buffer.getConstMappedRange(0, pContext->bufferSize);
-			
-			//Once we are done with this data, unmap the buffer
-			pContext->buffer.unmap();
-		};
-		wgpuBufferMapAsync(buffer2.Get(), wgpu::MapMode::Read, 0, k_bufferSize, onBuffer2Mapped, nullptr);
+			bool const screenshotKeyDown = glfwGetKey(window.get(), GLFW_KEY_F12) == GLFW_PRESS;
+			if (screenshotKeyDown && !screenshotKeyWasDown)
+			{
+				char name[32];
+				snprintf(name, sizeof(name), "screenshot_%u.png", screenshotCount++);
+				std::filesystem::create_directories(k_capturePath);
+				frameCapture.Screenshot(std::filesystem::path(k_capturePath) / name);
+			}
+			screenshotKeyWasDown = screenshotKeyDown;
 
-		//Quad upload
-		Gfx::Quad quad;
-		Gfx::Buffer quadBuffer{
-			sizeof(Gfx::Quad), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex, "Quad Vertices", device
-		};
-		quadBuffer.EnqueueCopy(quad.vertices.data(), 0, queue);
+			bool const sequenceKeyDown = glfwGetKey(window.get(), GLFW_KEY_F11) == GLFW_PRESS;
+			if (sequenceKeyDown && !sequenceKeyWasDown) frameCapture.StartSequence(std::filesystem::path(k_capturePath) / "sequence", k_captureSequenceFrames);
+			sequenceKeyWasDown = sequenceKeyDown;
 
-		while (!window.ShouldClose())
-		{
-			Clock::Tick();
-			float deltaTime = Clock::GetDelta();
+			bool const drawModeKeyDown = glfwGetKey(window.get(), GLFW_KEY_F3) == GLFW_PRESS;
+			if (drawModeKeyDown && !drawModeKeyWasDown)
+			{
+				terrainDrawMode = terrainDrawMode == TerrainDrawMode::Quads ? TerrainDrawMode::Tilemap : TerrainDrawMode::Quads;
+				visibleQuads = 0;
+			}
+			drawModeKeyWasDown = drawModeKeyDown;
+			bool const drawQuads = terrainDrawMode == TerrainDrawMode::Quads;
+
+			//Nothing to draw into while minimized
+			int framebufferWidth = 0;
+			int framebufferHeight = 0;
+			glfwGetFramebufferSize(window.get(), &framebufferWidth, &framebufferHeight);
+			if (framebufferWidth == 0 || framebufferHeight == 0)
+			{
+				glfwWaitEvents();
+				continue;
+			}
 
-			glfwPollEvents();
+			//Only the surface, the scaled targets and what's bound to them depend on the window size
+			bool surfaceOutdated = (uint32_t)framebufferWidth != surfaceConfig.width || (uint32_t)framebufferHeight != surfaceConfig.height;
+			if (surfaceOutdated)
+			{
+				PROFILE_SCOPE("Resize");
+				surfaceConfig.width = (uint32_t)framebufferWidth;
+				surfaceConfig.height = (uint32_t)framebufferHeight;
+				surface.configure(surfaceConfig);
+
+				if (sceneTarget.Resize(surfaceConfig.width, surfaceConfig.height)) upscalePipeline.BindData(sceneTarget.ColorView());
+				quadCam.extents = Vec2f{ (float)surfaceConfig.width, (float)surfaceConfig.height };
+				camBuffer.EnqueueCopy(&quadCam, 0);
+			}
 
 			wgpu::SurfaceTexture surfaceTexture;
-			surface.getCurrentTexture(&surfaceTexture);
+			{
+				PROFILE_SCOPE("Acquire Surface");
+				surface.getCurrentTexture(&surfaceTexture);
+			}
+			if (surfaceTexture.status == wgpu::SurfaceGetCurrentTextureStatus::Outdated
+				|| surfaceTexture.status == wgpu::SurfaceGetCurrentTextureStatus::Lost)
+			{
+				//Can happen mid resize, configure again and retry next frame
+				if (surfaceTexture.texture) wgpuTextureRelease(surfaceTexture.texture);
+				surface.configure(surfaceConfig);
+				continue;
+			}
 			if (surfaceTexture.status != wgpu::SurfaceGetCurrentTextureStatus::Success) {
 				std::cerr << "Failed to get surfaceTexture, status code: " << surfaceTexture.status << "\n";
 				break;
@@ -367,32 +502,40 @@ int main()
 				break;
 			}
 
-			wgpu::CommandEncoderDescriptor encoderDesc{};
-			encoderDesc.label = "Default Command Encoder";
-			wgpu::CommandEncoder encoder = device.createCommandEncoder(encoderDesc);
+			//Gpu time when it's measured, otherwise vsync hides any headroom and the scale can only go down
+			sceneTarget.SetScale(resolutionController.Update(gpuProfiler ? gpuProfiler->LastFrameMs() : deltaTime * 1000.f));
+			upscalePipeline.SetSourceRegion(sceneTarget.RenderExtents(), sceneTarget.Extents());
 
-			//Update view matrix
-			angle1 = uniform.time;
-			rotation1 = glm::rotate(Mat4f(1.0f), angle1, Vec3f(0.0f, 0.0f, 1.0f));
-			uniform.model = rotation1 * translation1 * scale;
+			wgpu::CommandEncoder encoder = gfxDevice.BeginCommands("Default Command Encoder");
+			textureUploads.Flush(encoder);
+			if (gpuProfiler) gpuProfiler->BeginFrame();
 
-			//EnqueueCopy uniforms
-			uniform.time = static_cast<float>(glfwGetTime());
-			uniformBuffer.EnqueueCopy(&uniform, sizeof(Uniforms), 0, queue);
+			//Newest simulated state, the simulation thread keeps stepping while this frame is encoded
+			FrameSnapshot const& snapshot = simulation.Latest();
+			float const ratio = (float)surfaceConfig.width / (float)surfaceConfig.height;
+			meshRenderer.Update(snapshot.meshModels, meshView, glm::perspective(fov, ratio, nearPlane, farPlane), meshColor, snapshot.time,
+				frameArena.Resource());
 
-			//Update animations
-			terrain.Animate(deltaTime);
-			animationBuffer.EnqueueCopy(terrain.CellAnimations().data(), 0, queue);
+			if (drawQuads)
+			{
+				terrainRenderer.Update(snapshot.animTick);
+				terrainRenderer.Animate(encoder, gpuProfiler ? gpuProfiler->ComputePassWrites("Sprite Anim Pass") : nullptr);
+				terrainRenderer.Cull(encoder, gpuProfiler ? gpuProfiler->ComputePassWrites("Quad Cull Pass") : nullptr);
+			}
+			else
+			{
+				tilemapRenderer.Update(snapshot.animTick);
+			}
 
 			wgpu::RenderPassColorAttachment rpColorAttachment{};
-			rpColorAttachment.view = toDisplay;
+			rpColorAttachment.view = sceneTarget.ColorView();
 			rpColorAttachment.resolveTarget = nullptr;
 			rpColorAttachment.loadOp = wgpu::LoadOp::Clear;
 			rpColorAttachment.storeOp = wgpu::StoreOp::Store;
 			rpColorAttachment.clearValue = wgpu::Color{ 0.9, 0.1, 0.2, 1.0 };
 
 			wgpu::RenderPassDepthStencilAttachment rpDepthAttachment;
-			rpDepthAttachment.view = depthTextureView;
+			rpDepthAttachment.view = sceneTarget.DepthView();
 			rpDepthAttachment.depthClearValue = 1.0f; //Maximum distance possible
 			rpDepthAttachment.depthLoadOp = wgpu::LoadOp::Clear;
 			rpDepthAttachment.depthStoreOp = wgpu::StoreOp::Store;
@@ -406,39 +549,117 @@ int main()
 			wgpu::RenderPassDescriptor renderPassDesc{};
 			renderPassDesc.colorAttachmentCount = 1;
 			renderPassDesc.colorAttachments = &rpColorAttachment;
-			renderPassDesc.timestampWrites = nullptr;
+			renderPassDesc.timestampWrites = gpuProfiler ? gpuProfiler->RenderPassWrites("Main Pass") : nullptr;
 			renderPassDesc.depthStencilAttachment = &rpDepthAttachment;
 			renderPassDesc.nextInChain = nullptr; //TODO ensure this is set to nullptr for all descriptor constructors
 
-			wgpu::RenderPassEncoder quadPassEncoder = encoder.beginRenderPass(renderPassDesc);
-			quadPassEncoder.setPipeline(quadPipeline.Get());
-			quadPassEncoder.setBindGroup(0, quadPipeline.BindGroup(), 0, nullptr);
-			quadPassEncoder.setVertexBuffer(0, quadBuffer.Get(), 0, quadBuffer.Size());
-			quadPassEncoder.draw((uint32_t)quad.vertices.size(), (uint32_t)terrain.Cells().size() /*instance count*/, 0, 0);
-			quadPassEncoder.end();
-			quadPassEncoder.release();
+			//Upscale covers every pixel, the clear just saves loading the old contents
+			wgpu::RenderPassColorAttachment overlayColorAttachment{};
+			overlayColorAttachment.view = toDisplay;
+			overlayColorAttachment.resolveTarget = nullptr;
+			overlayColorAttachment.loadOp = wgpu::LoadOp::Clear;
+			overlayColorAttachment.storeOp = wgpu::StoreOp::Store;
+			overlayColorAttachment.clearValue = wgpu::Color{ 0.0, 0.0, 0.0, 1.0 };
+
+			wgpu::RenderPassDescriptor overlayPassDesc{};
+			overlayPassDesc.colorAttachmentCount = 1;
+			overlayPassDesc.colorAttachments = &overlayColorAttachment;
+			overlayPassDesc.timestampWrites = gpuProfiler ? gpuProfiler->RenderPassWrites("Upscale + Overlay Pass") : nullptr;
+			overlayPassDesc.depthStencilAttachment = nullptr;
+			overlayPassDesc.nextInChain = nullptr;
+
+			Gfx::DrawStats lastDrawStats = drawList.Stats();
+			drawList.Reset();
+
+			//Labels never change so their layouts stay cached, only the values get laid out again
+			debugText.BeginFrame(Vec2f{ (float)surfaceConfig.width, (float)surfaceConfig.height });
+			char statText[64];
+			float const lineHeight = debugText.LineHeight();
+			debugText.Print("frame ms\nfps\ndraws\nquads\np99 ms\nscale\nmeshes\nupload KB\nallocs\narena KB", Vec2f{ 8.f, 8.f });
+			snprintf(statText, sizeof(statText), "%.2f", deltaTime * 1000.f);
+			debugText.Print(statText, Vec2f{ 80.f, 8.f });
+			snprintf(statText, sizeof(statText), "%.0f", deltaTime > 0.f ? 1.f / deltaTime : 0.f);
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + lineHeight });
+			snprintf(statText, sizeof(statText), "%u", lastDrawStats.draws + 1 /*terrain bundle or tilemap*/);
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 2.f * lineHeight });
+			if (drawQuads) snprintf(statText, sizeof(statText), "%u / %u", visibleQuads, terrain.CellCount());
+			else snprintf(statText, sizeof(statText), "%u", terrain.CellCount());
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 3.f * lineHeight });
+			snprintf(statText, sizeof(statText), "%.2f", frameStats.LastWindow().p99Ms);
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 4.f * lineHeight });
+			snprintf(statText, sizeof(statText), "%.2f", resolutionController.Scale());
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 5.f * lineHeight });
+			snprintf(statText, sizeof(statText), "%u / %u", meshRenderer.Stats().visible, meshRenderer.Stats().instances);
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 6.f * lineHeight });
+			snprintf(statText, sizeof(statText), "%.1f (%u)", textureUploads.LastFlush().stagedBytes / 1024.f, textureUploads.LastFlush().copies);
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 7.f * lineHeight });
+			if constexpr (Memory::k_trackAllocations) snprintf(statText, sizeof(statText), "%llu (%.1f KB)", (unsigned long long)lastFrameAllocations.allocations, (double)lastFrameAllocations.bytes / 1024.0);
+			else snprintf(statText, sizeof(statText), "off");
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 8.f * lineHeight });
+			//Last frame's arena, anything over its capacity went to the heap
+			Memory::ArenaStats const& arenaStats = frameArena.Previous().Stats();
+			snprintf(statText, sizeof(statText), "%.1f (+%.1f)", arenaStats.used / 1024.0, arenaStats.overflowBytes / 1024.0);
+			debugText.Print(statText, Vec2f{ 80.f, 8.f + 9.f * lineHeight });
+			debugText.Submit(drawList);
+			meshRenderer.Submit(drawList);
+
+			drawList.Sort(frameArena.Resource());
 
-			wgpu::CommandBufferDescriptor commandBufferDescriptor{};
-			commandBufferDescriptor.label = "Default Command Buffer";
-			wgpu::CommandBuffer commands = encoder.finish(commandBufferDescriptor);
+			{
+				PROFILE_SCOPE("Encode Main Pass");
+				Gfx::RenderEncoder& quadPass = gfxDevice.BeginRenderPass(encoder, renderPassDesc);
+				sceneTarget.SetViewport(quadPass);
+				if (drawQuads) terrainRenderer.Draw(quadPass);
+				else tilemapRenderer.Draw(quadPass);
+				drawList.Encode(Gfx::k_mainPass, quadPass);
+				gfxDevice.EndRenderPass(quadPass);
+			}
+
+			{
+				PROFILE_SCOPE("Encode Overlay Pass");
+				Gfx::RenderEncoder& overlayPass = gfxDevice.BeginRenderPass(encoder, overlayPassDesc);
+				upscalePipeline.Draw(overlayPass);
+				drawList.Encode(Gfx::k_overlayPass, overlayPass);
+				gfxDevice.EndRenderPass(overlayPass);
+			}
+
+			frameCapture.Capture(encoder, sceneTarget.ColorTexture(), swapChainFormat, sceneTarget.RenderExtents());
+			if (drawQuads)
+			{
+				//Skipped while every slot is still in flight, the count is only for display
+				readbacks.ReadBuffer(encoder, terrainRenderer.DrawArgs().Get(), 0, sizeof(DrawIndirectArgs), [&visibleQuads](Gfx::ReadbackData const& data) {
+					if (data.bytes.size() < sizeof(DrawIndirectArgs)) return;
+					DrawIndirectArgs args;
+					std::memcpy(&args, data.bytes.data(), sizeof(args));
+					visibleQuads = args.instanceCount;
+				});
+			}
+
+			if (gpuProfiler) gpuProfiler->Resolve(encoder);
+			{
+				PROFILE_SCOPE("Submit");
+				gfxDevice.Submit(encoder);
+			}
+			if (gpuProfiler) gpuProfiler->EndFrame();
+			readbacks.Submitted();
 
-			queue.submit(commands);
-			
-			commands.release();
-			encoder.release();
 			toDisplay.release();
-			surface.present();
+			{
+				PROFILE_SCOPE("Present");
+				surface.present();
+			}
 
-			//Wait until queue is finished processing
-#ifdef WEBGPU_BACKEND_WGPU
-			queue.submit(0, nullptr);
-#else
-			device.tick();
-#endif
+			//Process finished work, also runs the timestamp and readback callbacks
+			gfxDevice.Poll();
 		}
 
+		frameStats.Write(k_frameStatsPath);
+#ifdef RENDERER_PROFILING
+		Profiling::WriteChromeTrace("RendererTrace.json");
+#endif
+		gpuProfiler.reset();
+
 		//TODO raii webgpu generator
-		depthTextureView.release();
 		queue.release();
 		device.release();
 		adapter.release();
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cmath>
+#include "Test.h"
+#include "Chrono.h"
+
+namespace
+{
+	using namespace std::chrono_literals;
+
+	Clock::TimePoint const k_start{ 1s };
+
+	bool Near(float a, float b)
+	{
+		return std::abs(a - b) < 1e-4f;
+	}
+}
+
+TEST_CASE(ClockFixedStepCount)
+{
+	Clock::FrameClock clock(10ms, 5, k_start);
+
+	CHECK_EQ(clock.Tick(k_start + 25ms), 2u);
+	CHECK(Near(clock.GetDelta(), 0.025f));
+	CHECK(Near(clock.FixedDelta(), 0.01f));
+	//The 5ms left over carries into the next frame
+	CHECK_EQ(clock.Tick(k_start + 30ms), 1u);
+	CHECK_EQ(clock.Tick(k_start + 39ms), 0u);
+	CHECK_EQ(clock.Tick(k_start + 40ms), 1u);
+	CHECK_EQ(clock.Steps(), 4u);
+	CHECK_EQ(clock.DroppedSteps(), 0u);
+
+	//A frame that takes no time steps nothing
+	CHECK_EQ(clock.Tick(k_start + 40ms), 0u);
+	CHECK_EQ(clock.GetDelta(), 0.f);
+}
+
+TEST_CASE(ClockStepsDontDrift)
+{
+	//1/60s isn't a whole number of nanoseconds, 60 frames of exactly one step each still take 60 steps
+	Clock::FrameClock clock(Clock::k_fixedStep, Clock::k_maxCatchUpSteps, k_start);
+	Clock::TimePoint now = k_start;
+	uint32_t steps = 0;
+	for (uint32_t frame = 0; frame < 600; ++frame)
+	{
+		now += Clock::k_fixedStep;
+		steps += clock.Tick(now);
+	}
+	CHECK_EQ(steps, 600u);
+	CHECK_EQ(clock.Alpha(), 0.f);
+}
+
+TEST_CASE(ClockCatchUpCap)
+{
+	Clock::FrameClock clock(10ms, 5, k_start);
+
+	//A one second stall runs 5 steps and drops the other 95 rather than spiralling
+	CHECK_EQ(clock.Tick(k_start + 1s + 3ms), 5u);
+	CHECK_EQ(clock.Steps(), 5u);
+	CHECK_EQ(clock.DroppedSteps(), 95u);
+	//The remainder of the stall still counts towards the next step
+	CHECK(Near(clock.Alpha(), 0.3f));
+	CHECK_EQ(clock.Tick(k_start + 1s + 10ms), 1u);
+	CHECK_EQ(clock.Steps(), 6u);
+	CHECK_EQ(clock.DroppedSteps(), 95u);
+}
+
+TEST_CASE(ClockInterpolationAlpha)
+{
+	Clock::FrameClock clock(10ms, 5, k_start);
+
+	CHECK_EQ(clock.Alpha(), 0.f);
+	clock.Tick(k_start + 2500us);
+	CHECK(Near(clock.Alpha(), 0.25f));
+	clock.Tick(k_start + 7500us);
+	CHECK(Near(clock.Alpha(), 0.75f));
+	//Stays in [0, 1) across a step
+	clock.Tick(k_start + 12500us);
+	CHECK(Near(clock.Alpha(), 0.25f));
+	clock.Tick(k_start + 19999us);
+	CHECK(clock.Alpha() < 1.f);
+	CHECK(Near(clock.Alpha(), 0.9999f));
+}
@@ -0,0 +1,106 @@
+#include <vector>
+#include "Test.h"
+#include "QuadCulling.h"
+
+namespace
+{
+	QuadTransform Quad(float x, float y, float width, float height)
+	{
+		QuadTransform transform;
+		transform.position = Vec3f(x, y, 0.f);
+		transform.scale = Vec2f(width, height);
+		return transform;
+	}
+
+	//Sees [-10, 10] on both axes around the origin
+	CamUniforms const k_camera{ Vec2f(0.f, 0.f), Vec2f(10.f, 10.f) };
+
+	std::vector<uint32_t> Cull(std::vector<QuadTransform> const& transforms, CamUniforms const& camera)
+	{
+		std::vector<uint32_t> visible(transforms.size());
+		visible.resize(Gfx::CullQuads(transforms, camera, visible));
+		return visible;
+	}
+}
+
+TEST_CASE(CullKeepsQuadsFullyInside)
+{
+	std::vector<QuadTransform> quads = { Quad(-1.f, -1.f, 2.f, 2.f), Quad(-10.f, -10.f, 20.f, 20.f), Quad(5.f, -8.f, 1.f, 1.f) };
+	CHECK(Cull(quads, k_camera) == (std::vector<uint32_t>{ 0, 1, 2 }));
+}
+
+TEST_CASE(CullDropsQuadsFullyOutside)
+{
+	std::vector<QuadTransform> quads = {
+		Quad(20.f, 0.f, 2.f, 2.f), //Right
+		Quad(-30.f, 0.f, 2.f, 2.f), //Left
+		Quad(0.f, 12.f, 2.f, 2.f), //Above
+		Quad(0.f, -15.f, 2.f, 2.f), //Below
+		Quad(11.f, 11.f, 1.f, 1.f), //Past a corner
+	};
+	CHECK(Cull(quads, k_camera).empty());
+}
+
+TEST_CASE(CullKeepsQuadsStraddlingEachEdge)
+{
+	std::vector<QuadTransform> quads = {
+		Quad(-11.f, 0.f, 2.f, 2.f), //Left
+		Quad(9.f, 0.f, 2.f, 2.f), //Right
+		Quad(0.f, -11.f, 2.f, 2.f), //Bottom
+		Quad(0.f, 9.f, 2.f, 2.f), //Top
+		Quad(-20.f, -20.f, 40.f, 40.f), //Covers the whole view
+	};
+	CHECK(Cull(quads, k_camera) == (std::vector<uint32_t>{ 0, 1, 2, 3, 4 }));
+}
+
+TEST_CASE(CullEdgesAreInclusive)
+{
+	std::vector<QuadTransform> quads = {
+		Quad(10.f, 0.f, 1.f, 1.f), //Touches the right edge
+		Quad(-12.f, 0.f, 2.f, 1.f), //Touches the left edge
+		Quad(10.5f, 0.f, 1.f, 1.f), //Just past the right edge
+		Quad(0.f, -12.f, 1.f, 1.5f), //Just short of the bottom edge
+	};
+	CHECK(Cull(quads, k_camera) == (std::vector<uint32_t>{ 0, 1 }));
+}
+
+TEST_CASE(CullHandlesZeroAndNegativeScale)
+{
+	std::vector<QuadTransform> quads = {
+		Quad(0.f, 0.f, 0.f, 0.f), //Point inside
+		Quad(15.f, 0.f, 0.f, 0.f), //Point outside
+		Quad(11.f, 0.f, -2.f, 1.f), //Spans [9, 11] on x
+		Quad(13.f, 0.f, -2.f, 1.f), //Spans [11, 13] on x
+		Quad(0.f, -9.f, 1.f, -2.f), //Spans [-11, -9] on y
+		Quad(0.f, -11.f, 1.f, -2.f), //Spans [-13, -11] on y
+	};
+	CHECK(Cull(quads, k_camera) == (std::vector<uint32_t>{ 0, 2, 4 }));
+}
+
+TEST_CASE(CullFollowsTheCamera)
+{
+	CamUniforms camera{ Vec2f(100.f, 50.f), Vec2f(10.f, 5.f) };
+	std::vector<QuadTransform> quads = {
+		Quad(0.f, 0.f, 1.f, 1.f), //Visible from the origin only
+		Quad(95.f, 50.f, 1.f, 1.f),
+		Quad(111.f, 50.f, 1.f, 1.f), //Past the right edge at x 110
+		Quad(100.f, 54.5f, 1.f, 1.f), //Straddles the top edge at y 55
+	};
+	CHECK(Cull(quads, camera) == (std::vector<uint32_t>{ 1, 3 }));
+	CHECK(Gfx::IsQuadVisible(quads[0], k_camera));
+	CHECK(!Gfx::IsQuadVisible(quads[0], camera));
+}
+
+TEST_CASE(CullKeepsInstanceOrder)
+{
+	std::vector<QuadTransform> quads;
+	std::vector<uint32_t> expected;
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		//Every third quad is moved out of view
+		bool const visible = i % 3 != 0;
+		quads.push_back(Quad(visible ? (float)(i % 16) - 8.f : 50.f, 0.f, 1.f, 1.f));
+		if (visible) expected.push_back(i);
+	}
+	CHECK(Cull(quads, k_camera) == expected);
+}
@@ -0,0 +1 @@
+const k_shared = 1u;
@@ -0,0 +1,14 @@
+#ifdef A
+a
+#ifdef B
+ab
+#else
+a_not_b
+#endif
+#else
+not_a
+#ifndef B
+not_a_not_b
+#endif
+#endif
+end
@@ -0,0 +1,5 @@
+const size = WIDTH;
+const other = WIDTHS + WIDTH_2;
+const sum = WIDTH+WIDTH; // WIDTH stays in comments
+#define HEIGHT 32u
+const area = WIDTH * HEIGHT;
@@ -0,0 +1,4 @@
+#include "common.wgsl"
+#include "Lib/helpers.wgsl"
+#include "common.wgsl"
+fn main() {}
@@ -0,0 +1,2 @@
+#include "doesNotExist.wgsl"
+fn main() {}
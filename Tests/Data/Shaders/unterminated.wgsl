@@ -0,0 +1,4 @@
+#ifdef A
+fn a() {}
+#ifndef B
+#endif
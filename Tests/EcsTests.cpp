@@ -0,0 +1,179 @@
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+#include "Test.h"
+#include "Ecs.h"
+#include "JobSystem.h"
+
+namespace
+{
+	struct Position
+	{
+		float x = 0.f;
+		float y = 0.f;
+	};
+
+	struct Velocity
+	{
+		float x = 0.f;
+		float y = 0.f;
+	};
+
+	struct Health
+	{
+		uint32_t value = 0;
+	};
+
+	//Rows a chunk holds for an archetype of just Position, there's no padding between the two arrays
+	constexpr uint32_t k_positionsPerChunk = (uint32_t)(Ecs::k_chunkBytes / (sizeof(Ecs::Entity) + sizeof(Position)));
+
+	uint32_t ChunkCount(Ecs::World& world)
+	{
+		uint32_t chunks = 0;
+		world.ForEachChunk<Position const>([&chunks](std::span<Ecs::Entity const>, std::span<Position const>) { ++chunks; });
+		return chunks;
+	}
+}
+
+TEST_CASE(EcsDestroyKeepsOtherHandlesValid)
+{
+	Ecs::World world;
+	std::vector<Ecs::Entity> entities;
+	for (uint32_t i = 0; i < 6; ++i) entities.push_back(world.Create(Position{ (float)i, 0.f }));
+
+	//The last entity is swapped into the hole, and destroying the last row swaps nothing
+	world.Destroy(entities[1]);
+	world.Destroy(entities[5]);
+	CHECK_EQ(world.Count(), 4u);
+	CHECK(!world.Alive(entities[1]));
+	CHECK(!world.Alive(entities[5]));
+	CHECK(world.Get<Position>(entities[1]) == nullptr);
+	for (uint32_t i : { 0u, 2u, 3u, 4u })
+	{
+		REQUIRE(world.Alive(entities[i]));
+		CHECK_EQ(world.Get<Position>(entities[i])->x, (float)i);
+	}
+
+	//Indices are reused with a new generation, the old handle stays dead
+	Ecs::Entity const reused = world.Create(Position{ 9.f, 0.f });
+	CHECK(reused.index == entities[1].index || reused.index == entities[5].index);
+	CHECK(reused.generation == 1u);
+	CHECK(world.Alive(reused));
+	CHECK(!world.Alive(entities[1]));
+	CHECK(!world.Alive(entities[5]));
+	CHECK_EQ(world.Get<Position>(reused)->x, 9.f);
+
+	//Destroying twice is a no-op
+	world.Destroy(entities[1]);
+	CHECK_EQ(world.Count(), 5u);
+}
+
+TEST_CASE(EcsMoveKeepsComponentValues)
+{
+	Ecs::World world;
+	Ecs::Entity const before = world.Create(Position{ 1.f, 2.f }, Health{ 7 });
+	Ecs::Entity const moving = world.Create(Position{ 3.f, 4.f }, Health{ 8 });
+	Ecs::Entity const after = world.Create(Position{ 5.f, 6.f }, Health{ 9 });
+
+	world.Add(moving, Velocity{ 0.5f, -0.5f });
+	REQUIRE(world.Get<Velocity>(moving) != nullptr);
+	CHECK_EQ(world.Get<Position>(moving)->x, 3.f);
+	CHECK_EQ(world.Get<Position>(moving)->y, 4.f);
+	CHECK_EQ(world.Get<Health>(moving)->value, 8u);
+	CHECK_EQ(world.Get<Velocity>(moving)->x, 0.5f);
+	CHECK_EQ(world.Count<Velocity>(), 1u);
+	CHECK_EQ((world.Count<Position, Health>()), 3u);
+
+	//The entities left behind were swapped around, not changed
+	CHECK_EQ(world.Get<Health>(before)->value, 7u);
+	CHECK_EQ(world.Get<Health>(after)->value, 9u);
+	CHECK_EQ(world.Get<Position>(after)->x, 5.f);
+	CHECK(world.Get<Velocity>(after) == nullptr);
+
+	//Adding a component it already has only overwrites it
+	world.Add(moving, Velocity{ 2.f, 2.f });
+	CHECK_EQ(world.Get<Velocity>(moving)->x, 2.f);
+	CHECK_EQ(world.Count<Velocity>(), 1u);
+
+	world.Remove<Health>(moving);
+	CHECK(world.Get<Health>(moving) == nullptr);
+	CHECK_EQ(world.Get<Position>(moving)->x, 3.f);
+	CHECK_EQ(world.Get<Velocity>(moving)->y, 2.f);
+	CHECK_EQ(world.Count<Health>(), 2u);
+	CHECK_EQ(world.Count(), 3u);
+}
+
+TEST_CASE(EcsSpillsIntoASecondChunk)
+{
+	Ecs::World world;
+	uint32_t const count = k_positionsPerChunk + 10;
+	std::vector<Ecs::Entity> entities;
+	for (uint32_t i = 0; i < count; ++i) entities.push_back(world.Create(Position{ (float)i, 0.f }));
+
+	std::vector<uint32_t> chunkSizes;
+	std::vector<float> xs;
+	world.ForEachChunk<Position const>([&](std::span<Ecs::Entity const> chunkEntities, std::span<Position const> positions) {
+		chunkSizes.push_back((uint32_t)chunkEntities.size());
+		for (Position const& position : positions) xs.push_back(position.x);
+	});
+	REQUIRE(chunkSizes.size() == 2);
+	CHECK_EQ(chunkSizes[0], k_positionsPerChunk);
+	CHECK_EQ(chunkSizes[1], 10u);
+	//Creation order across the chunk boundary
+	REQUIRE(xs.size() == count);
+	for (uint32_t i = 0; i < count; ++i) CHECK_EQ(xs[i], (float)i);
+
+	//A hole in the first chunk is filled from the end of the second
+	world.Destroy(entities[3]);
+	CHECK_EQ(world.Get<Position>(entities[count - 1])->x, (float)(count - 1));
+	CHECK_EQ(world.Get<Position>(entities[4])->x, 4.f);
+
+	//The second chunk is freed once it empties
+	for (uint32_t i = count - 9; i < count; ++i) world.Destroy(entities[i]);
+	CHECK_EQ(ChunkCount(world), 1u);
+	CHECK_EQ(world.Count(), k_positionsPerChunk);
+	for (uint32_t i = 0; i < count - 9; ++i)
+	{
+		if (i != 3) CHECK_EQ(world.Get<Position>(entities[i])->x, (float)i);
+	}
+}
+
+TEST_CASE(EcsParallelForEachChunkVisitsEveryEntityOnce)
+{
+	Jobs::JobSystem jobs(4);
+	Ecs::World world;
+	uint32_t const withHealth = 5 * k_positionsPerChunk + 17;
+	world.CreateMany<Position, Health>(withHealth);
+	world.CreateMany<Position>(100);
+	world.CreateMany<Health, Velocity>(50);
+
+	uint32_t const entityCount = world.Count();
+	std::unique_ptr<std::atomic<uint32_t>[]> visits(new std::atomic<uint32_t>[entityCount]);
+	for (uint32_t i = 0; i < entityCount; ++i) visits[i] = 0;
+
+	world.ParallelForEachChunk<Health>(jobs, [&visits](std::span<Ecs::Entity const> entities, std::span<Health> health) {
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			visits[entities[i].index].fetch_add(1, std::memory_order_relaxed);
+			++health[i].value;
+		}
+	});
+
+	uint32_t visitedOnce = 0;
+	uint32_t visitedMore = 0;
+	for (uint32_t i = 0; i < entityCount; ++i)
+	{
+		uint32_t const count = visits[i].load();
+		visitedOnce += count == 1;
+		visitedMore += count > 1;
+	}
+	CHECK_EQ(visitedOnce, withHealth + 50);
+	CHECK_EQ(visitedMore, 0u);
+
+	uint32_t healthTotal = 0;
+	world.ForEachChunk<Health const>([&healthTotal](std::span<Ecs::Entity const>, std::span<Health const> health) {
+		for (Health const& h : health) healthTotal += h.value;
+	});
+	CHECK_EQ(healthTotal, withHealth + 50);
+}
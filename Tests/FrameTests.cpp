@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <vector>
+#include "Test.h"
+#include "webgpu.h"
+#include "NullDevice.h"
+#include "NullScene.h"
+#include "QuadCullPipeline.h"
+#include "SpriteAnimPipeline.h"
+#include "TerrainRenderer.h"
+#include "Terrain.h"
+
+namespace
+{
+	using Gfx::NullCommandType;
+	using Test::NullScene;
+
+	constexpr uint32_t k_side = 100; //More cells than one uniform array could hold
+
+	//Records one frame the way main does
+	void RecordFrame(Gfx::NullDevice& device, Terrain& terrain, TerrainRenderer& renderer)
+	{
+		wgpu::CommandEncoder encoder = device.BeginCommands("Frame");
+		terrain.Animate();
+		renderer.Update(terrain.AnimTick());
+		renderer.Animate(encoder);
+		renderer.Cull(encoder);
+
+		wgpu::RenderPassDescriptor passDesc{};
+		Gfx::RenderEncoder& pass = device.BeginRenderPass(encoder, passDesc);
+		renderer.Draw(pass);
+		device.EndRenderPass(pass);
+		device.Submit(encoder);
+	}
+
+	std::vector<NullCommandType> Types(std::vector<Gfx::NullCommand> const& commands)
+	{
+		std::vector<NullCommandType> types;
+		for (Gfx::NullCommand const& command : commands) types.push_back(command.type);
+		return types;
+	}
+
+	uint32_t Count(std::vector<Gfx::NullCommand> const& commands, NullCommandType type)
+	{
+		return (uint32_t)std::count_if(commands.begin(), commands.end(), [type](Gfx::NullCommand const& command) { return command.type == type; });
+	}
+}
+
+TEST_CASE(TerrainFrameCommands)
+{
+	Gfx::NullDevice device;
+	{
+		NullScene scene(device);
+		Terrain terrain(k_side, k_side, 50);
+		TerrainRenderer renderer(device, terrain, scene.animations, scene.camera, scene.quadShader, scene.cullShader, scene.animShader,
+			scene.colorTarget, scene.depthStencil, Gfx::QuadGeometry::VertexPulling);
+
+		//The first frame records the bundle
+		device.ClearCommands();
+		device.ResetStats();
+		RecordFrame(device, terrain, renderer);
+		CHECK_EQ(Count(device.Commands(), NullCommandType::BeginRenderBundle), 1u);
+		CHECK_EQ(device.Stats().bundlesRecorded, 1u);
+		//Draws recorded into the bundle only count once it executes
+		CHECK_EQ(device.Stats().draws, 1u);
+
+		uint32_t const cellCount = terrain.CellCount();
+		REQUIRE(cellCount > 0);
+
+		//Steady frames replay it
+		for (uint32_t frame = 0; frame < 3; ++frame)
+		{
+			device.ClearCommands();
+			device.ResetStats();
+			RecordFrame(device, terrain, renderer);
+
+			std::vector<Gfx::NullCommand> const& commands = device.Commands();
+			std::vector<NullCommandType> const expected = {
+				NullCommandType::WriteBuffer, //Animation tick
+				NullCommandType::BeginComputePass, NullCommandType::SetComputePipeline, NullCommandType::SetComputeBindGroup,
+				NullCommandType::Dispatch, NullCommandType::EndComputePass,
+				NullCommandType::CopyBufferToBuffer, //Draw args reset
+				NullCommandType::BeginComputePass, NullCommandType::SetComputePipeline, NullCommandType::SetComputeBindGroup,
+				NullCommandType::Dispatch, NullCommandType::EndComputePass,
+				NullCommandType::BeginRenderPass, NullCommandType::ExecuteBundle, NullCommandType::EndRenderPass,
+				NullCommandType::Submit,
+			};
+			REQUIRE(Types(commands) == expected);
+
+			//The only write is the tick
+			CHECK_EQ(commands[0].arg1, sizeof(Gfx::SpriteAnimTick));
+			CHECK_EQ(commands[6].arg1, sizeof(DrawIndirectArgs));
+			//Animation then cull dispatches, one thread per cell
+			CHECK_EQ(commands[4].arg0, (cellCount + Gfx::k_spriteAnimWorkgroupSize - 1) / Gfx::k_spriteAnimWorkgroupSize);
+			CHECK_EQ(commands[10].arg0, (cellCount + Gfx::k_cullWorkgroupSize - 1) / Gfx::k_cullWorkgroupSize);
+
+			Gfx::NullDeviceStats const& stats = device.Stats();
+			CHECK_EQ(stats.bufferWrites, 1u);
+			CHECK_EQ(stats.bufferBytesWritten, sizeof(Gfx::SpriteAnimTick));
+			CHECK_EQ(stats.textureWrites, 0u);
+			CHECK_EQ(stats.bundlesRecorded, 0u);
+			CHECK_EQ(stats.bundlesExecuted, 1u);
+			CHECK_EQ(stats.dispatches, 2u);
+			CHECK_EQ(stats.draws, 1u);
+			//Pipeline and bind group for each compute pass and inside the bundle
+			CHECK_EQ(stats.stateChanges, 6u);
+			CHECK_EQ(stats.submits, 1u);
+			CHECK_EQ(stats.objectsCreated, stats.objectsReleased); //Only the command encoder
+		}
+	}
+
+	//Everything the terrain, renderer and scene created has been released
+	CHECK(device.LiveObjects().empty());
+	CHECK_EQ(device.LiveBytes(), 0u);
+}
+
+TEST_CASE(TerrainRelayoutRecordsTheBundleAgain)
+{
+	Gfx::NullDevice device;
+	{
+		NullScene scene(device);
+		Terrain terrain(10, 10, 50);
+		TerrainRenderer renderer(device, terrain, scene.animations, scene.camera, scene.quadShader, scene.cullShader, scene.animShader,
+			scene.colorTarget, scene.depthStencil, Gfx::QuadGeometry::VertexPulling);
+		RecordFrame(device, terrain, renderer);
+
+		terrain.Generate(20, 20, 50);
+		device.ClearCommands();
+		device.ResetStats();
+		RecordFrame(device, terrain, renderer);
+		CHECK_EQ(device.Stats().bundlesRecorded, 1u);
+		CHECK_EQ(device.Stats().bundlesExecuted, 1u);
+		CHECK_EQ(device.Stats().draws, 1u);
+		CHECK_EQ(Count(device.Commands(), NullCommandType::ExecuteBundle), 1u);
+	}
+	CHECK(device.LiveObjects().empty());
+}
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "Test.h"
+#include "JobSystem.h"
+
+namespace
+{
+	constexpr uint32_t k_workers = 4;
+	constexpr uint32_t k_outer = 64;
+	constexpr uint32_t k_inner = 1000;
+}
+
+TEST_CASE(JobsNestedParallelForRunsEveryIndexOnce)
+{
+	Jobs::JobSystem jobs(k_workers);
+	std::unique_ptr<std::atomic<uint32_t>[]> runs(new std::atomic<uint32_t>[k_outer * k_inner]);
+	for (uint32_t i = 0; i < k_outer * k_inner; ++i) runs[i] = 0;
+
+	//Inner loops are queued from whichever worker runs the outer chunk, and waited on there
+	jobs.ParallelFor(k_outer, 1, [&](uint32_t outerBegin, uint32_t outerEnd) {
+		for (uint32_t outer = outerBegin; outer < outerEnd; ++outer)
+		{
+			jobs.ParallelFor(k_inner, 16, [&runs, outer](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i) runs[outer * k_inner + i].fetch_add(1, std::memory_order_relaxed);
+			});
+		}
+	});
+
+	uint32_t wrong = 0;
+	for (uint32_t i = 0; i < k_outer * k_inner; ++i) wrong += runs[i].load() != 1;
+	CHECK_EQ(wrong, 0u);
+}
+
+TEST_CASE(JobsWaitReturnsAfterChildrenFinish)
+{
+	Jobs::JobSystem jobs(k_workers);
+	constexpr uint32_t k_children = 32;
+	std::atomic<uint32_t> finished = 0;
+	std::atomic<uint32_t> finishedAtWait = 0;
+
+	Jobs::Counter parent;
+	jobs.Run(parent, [&jobs, &finished, &finishedAtWait] {
+		Jobs::Counter children;
+		for (uint32_t i = 0; i < k_children; ++i)
+		{
+			jobs.Run(children, [&finished] {
+				//Long enough that other workers steal some while this one waits
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+				finished.fetch_add(1, std::memory_order_relaxed);
+			});
+		}
+		jobs.Wait(children);
+		finishedAtWait = finished.load();
+	});
+	jobs.Wait(parent);
+
+	CHECK(parent.Done());
+	CHECK_EQ(finishedAtWait.load(), k_children);
+	CHECK_EQ(finished.load(), k_children);
+}
+
+TEST_CASE(JobsRunInlineFromOtherThreads)
+{
+	Jobs::JobSystem jobs(k_workers);
+	bool runInline = false;
+	bool parallelForInline = true;
+	bool doneBeforeWait = false;
+
+	//Not one of the system's workers, so nothing is queued
+	std::thread outsider([&] {
+		std::thread::id const self = std::this_thread::get_id();
+		Jobs::Counter counter;
+		std::thread::id ranOn;
+		jobs.Run(counter, [&ranOn] { ranOn = std::this_thread::get_id(); });
+		runInline = ranOn == self;
+		doneBeforeWait = counter.Done();
+		jobs.Wait(counter);
+
+		std::atomic<uint32_t> chunks = 0;
+		jobs.ParallelFor(100, 10, [&](uint32_t, uint32_t) {
+			if (std::this_thread::get_id() != self) parallelForInline = false;
+			chunks.fetch_add(1, std::memory_order_relaxed);
+		});
+		if (chunks.load() != 10) parallelForInline = false;
+	});
+	outsider.join();
+
+	CHECK(runInline);
+	CHECK(doneBeforeWait);
+	CHECK(parallelForInline);
+}
+
+TEST_CASE(JobsRunInlineWhenThePoolIsFull)
+{
+	//A single worker is only the calling thread, nothing runs until it waits
+	Jobs::JobSystem jobs(1);
+	constexpr uint32_t k_extra = 10;
+	std::atomic<uint32_t> ran = 0;
+
+	Jobs::Counter counter;
+	for (uint32_t i = 0; i < Jobs::k_maxJobsPerWorker + k_extra; ++i)
+	{
+		jobs.Run(counter, [&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+	}
+	//Every slot holds an unfinished job, the extras ran inline
+	CHECK_EQ(ran.load(), k_extra);
+	CHECK(!counter.Done());
+
+	jobs.Wait(counter);
+	CHECK_EQ(ran.load(), Jobs::k_maxJobsPerWorker + k_extra);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "webgpu.h"
+#include "NullDevice.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "QuadDefs.h"
+
+//Shared by the tests and the benchmarks, so frames are recorded against the same setup
+namespace Test
+{
+	//Resources main creates before the terrain, against the null device. Shaders are empty placeholders
+	struct NullScene
+	{
+		static constexpr wgpu::TextureFormat k_colorFormat = wgpu::TextureFormat::BGRA8Unorm;
+		static constexpr wgpu::TextureFormat k_depthFormat = wgpu::TextureFormat::Depth24Plus;
+
+		NullScene(Gfx::NullDevice& device)
+			: camera(sizeof(CamUniforms), wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform | wgpu::BufferUsage::Storage, "Camera Uniforms", device)
+			, animations(wgpu::TextureDimension::_2D, { 512, 64, 2 }, wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::CopyDst,
+				4, 1, wgpu::TextureFormat::RGBA8Unorm, device, "animation")
+			, pDevice(&device)
+		{
+			wgpu::ShaderModuleDescriptor shaderDesc{};
+			quadShader = device.CreateShaderModule(shaderDesc);
+			cullShader = device.CreateShaderModule(shaderDesc);
+			animShader = device.CreateShaderModule(shaderDesc);
+			tilemapShader = device.CreateShaderModule(shaderDesc);
+
+			colorTarget.format = k_colorFormat;
+			colorTarget.writeMask = wgpu::ColorWriteMask::All;
+			depthStencil.format = k_depthFormat;
+			depthStencil.depthWriteEnabled = true;
+			depthStencil.depthCompare = wgpu::CompareFunction::Less;
+		}
+
+		~NullScene()
+		{
+			pDevice->Release(quadShader);
+			pDevice->Release(cullShader);
+			pDevice->Release(animShader);
+			pDevice->Release(tilemapShader);
+		}
+
+		//No copy, move
+		NullScene(NullScene const& other) = delete;
+		NullScene(NullScene&& other) = delete;
+		NullScene& operator=(NullScene const& other) = delete;
+		NullScene& operator=(NullScene&& other) = delete;
+
+		Gfx::Buffer camera;
+		Gfx::Texture animations;
+		wgpu::ShaderModule quadShader = nullptr;
+		wgpu::ShaderModule cullShader = nullptr;
+		wgpu::ShaderModule animShader = nullptr;
+		wgpu::ShaderModule tilemapShader = nullptr;
+		wgpu::ColorTargetState colorTarget{};
+		wgpu::DepthStencilState depthStencil{};
+		Gfx::NullDevice* pDevice;
+	};
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include "Test.h"
+#include "SoftwareRasterizer.h"
+#include "JobSystem.h"
+#include "Utils.h"
+#include <glfw/deps/stb_image_write.h> //Implemented in FrameCapture.cpp
+
+namespace
+{
+	std::filesystem::path const k_goldenPath = std::filesystem::path(TEST_DATA_DIR) / "quadsGolden.png";
+
+	//Target and camera sizes are powers of two so quad edges land exactly where they are placed in pixel space
+	constexpr uint32_t k_width = 128; //Two raster tiles across
+	constexpr uint32_t k_height = 64;
+	Vec4f const k_clearColor{ 0.2f, 0.2f, 0.2f, 0.25f };
+
+	//Framebuffer x is world x and framebuffer y is 64 - world y
+	CamUniforms const k_camera{ Vec2f(64.f, 32.f), Vec2f(64.f, 32.f) };
+
+	TextureResource SolidLayer(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+	{
+		TextureResource layer{ 4, 4, 1, 4, {}, "solid" };
+		layer.data.resize(layer.SizeBytes());
+		for (size_t i = 0; i < layer.data.size(); i += 4)
+		{
+			layer.data[i + 0] = (std::byte)r;
+			layer.data[i + 1] = (std::byte)g;
+			layer.data[i + 2] = (std::byte)b;
+			layer.data[i + 3] = (std::byte)a;
+		}
+		return layer;
+	}
+
+	//Covers framebuffer pixels whose centers lie in [x0, x1) x [y0, y1) when the bounds sit on pixel centers
+	QuadTransform PixelQuad(float x0, float y0, float x1, float y1, float z)
+	{
+		QuadTransform transform;
+		transform.position = Vec3f(x0, (float)k_height - y1, z);
+		transform.scale = Vec2f(x1 - x0, y1 - y0);
+		return transform;
+	}
+
+	AnimUniform Sprite(uint32_t layer)
+	{
+		AnimUniform animation;
+		animation.frameDimensions = Vec2f(4.f, 4.f);
+		animation.animId = layer;
+		return animation;
+	}
+
+	struct Scene
+	{
+		std::vector<QuadTransform> transforms;
+		std::vector<AnimUniform> animations;
+		std::vector<uint32_t> instances;
+		std::vector<TextureResource> layers;
+	};
+
+	Scene MakeScene()
+	{
+		Scene scene;
+		scene.layers = { SolidLayer(255, 0, 0, 255), SolidLayer(0, 0, 255, 128) };
+
+		//Opaque red, pixels [8, 40) on both axes. Its edges sit on pixel centers, so only the top and left rows are in
+		scene.transforms.push_back(PixelQuad(8.5f, 8.5f, 40.5f, 40.5f, 0.5f));
+		scene.animations.push_back(Sprite(0));
+		//Half transparent blue behind the red one and drawn after it, straddles the tile boundary at x 64
+		scene.transforms.push_back(PixelQuad(24.5f, 24.5f, 72.5f, 56.5f, 0.7f));
+		scene.animations.push_back(Sprite(1));
+		//Half transparent blue in front of the red one
+		scene.transforms.push_back(PixelQuad(32.5f, 0.5f, 48.5f, 16.5f, 0.2f));
+		scene.animations.push_back(Sprite(1));
+		//Negative scale flips the winding, same pixels as [90, 100) x [40, 50)
+		QuadTransform flipped = PixelQuad(90.5f, 40.5f, 100.5f, 50.5f, 0.9f);
+		flipped.position.x += flipped.scale.x;
+		flipped.scale.x = -flipped.scale.x;
+		scene.transforms.push_back(flipped);
+		scene.animations.push_back(Sprite(0));
+		//Past the far plane, clipped
+		scene.transforms.push_back(PixelQuad(100.5f, 4.5f, 120.5f, 20.5f, 1.5f));
+		scene.animations.push_back(Sprite(0));
+		//Not in the instance list
+		scene.transforms.push_back(PixelQuad(0.5f, 50.5f, 10.5f, 60.5f, 0.1f));
+		scene.animations.push_back(Sprite(0));
+
+		scene.instances = { 0, 1, 2, 3, 4 };
+		return scene;
+	}
+
+	Gfx::RasterTarget Render(Scene const& scene, Jobs::JobSystem* pJobs)
+	{
+		Gfx::RasterTarget target;
+		target.Resize(k_width, k_height);
+		target.Clear(k_clearColor, 1.f);
+
+		Gfx::SoftwareRasterizer rasterizer(pJobs);
+		rasterizer.DrawQuads({ scene.transforms, scene.animations, k_camera, scene.instances, scene.layers }, target);
+		return target;
+	}
+
+	uint32_t Channel(Gfx::RasterTarget const& target, uint32_t x, uint32_t y, uint32_t channel)
+	{
+		return (target.color[(size_t)y * target.width + x] >> (channel * 8)) & 0xFF;
+	}
+
+	//SrcAlpha, OneMinusDstAlpha on 8 bit values, rounded like a unorm store
+	uint32_t Blend(uint32_t src, uint32_t srcAlpha, uint32_t dst, uint32_t dstAlpha)
+	{
+		float value = (float)src / 255.f * ((float)srcAlpha / 255.f) + (float)dst / 255.f * (1.f - (float)dstAlpha / 255.f);
+		return (uint32_t)std::nearbyint(std::clamp(value, 0.f, 1.f) * 255.f);
+	}
+
+	//Two workers for the two tiles across
+	Gfx::RasterTarget Render(Scene const& scene)
+	{
+		Jobs::JobSystem jobs(2);
+		return Render(scene, &jobs);
+	}
+
+	bool Near(uint32_t a, uint32_t b)
+	{
+		return (a > b ? a - b : b - a) <= 1;
+	}
+}
+
+TEST_CASE(RasterMatchesGoldenImage)
+{
+	Gfx::RasterTarget target = Render(MakeScene());
+
+	//RENDERER_UPDATE_GOLDEN=1 rewrites the golden image instead of comparing against it
+	char const* update = std::getenv("RENDERER_UPDATE_GOLDEN");
+	if (update && update[0] == '1')
+	{
+		TextureResource image = target.ToTextureResource("quadsGolden");
+		REQUIRE(stbi_write_png(k_goldenPath.generic_string().c_str(), (int)image.width, (int)image.height, 4, image.data.data(), (int)image.width * 4));
+		std::cout << "  Wrote " << k_goldenPath.generic_string() << "\n";
+		return;
+	}
+
+	std::optional<TextureResource> golden = Utils::LoadTexture(k_goldenPath);
+	REQUIRE(golden.has_value());
+	CHECK(Gfx::MaxChannelDifference(target, *golden) <= 1);
+}
+
+TEST_CASE(RasterTopLeftRule)
+{
+	Gfx::RasterTarget target = Render(MakeScene());
+	Gfx::RasterTarget clear;
+	clear.Resize(k_width, k_height);
+	clear.Clear(k_clearColor, 1.f);
+	auto isClear = [&](uint32_t x, uint32_t y) { return target.color[(size_t)y * k_width + x] == clear.color[(size_t)y * k_width + x]; };
+
+	//Top and left edges of the red quad are in, bottom and right are out
+	CHECK(!isClear(8, 8));
+	CHECK(!isClear(8, 20));
+	CHECK(!isClear(20, 8));
+	CHECK(!isClear(39, 20));
+	CHECK(!isClear(20, 39));
+	CHECK(isClear(7, 20));
+	CHECK(isClear(20, 7));
+	CHECK(isClear(40, 20));
+	CHECK(isClear(20, 40));
+
+	//The flipped quad covers exactly [90, 100) x [40, 50)
+	CHECK(!isClear(90, 40));
+	CHECK(!isClear(99, 49));
+	CHECK(isClear(89, 45));
+	CHECK(isClear(100, 45));
+	CHECK(isClear(95, 39));
+	CHECK(isClear(95, 50));
+
+	//Clipped and skipped quads leave the target alone
+	CHECK(isClear(110, 10));
+	CHECK(isClear(5, 55));
+}
+
+TEST_CASE(RasterDepthLess)
+{
+	Gfx::RasterTarget target = Render(MakeScene());
+
+	//The blue quad is behind the red one, red stays where they overlap
+	for (uint32_t c = 0; c < 4; ++c) CHECK_EQ(Channel(target, 30, 30, c), Channel(target, 12, 12, c));
+	CHECK_EQ(target.depth[30 * k_width + 30], 0.5f);
+	//And lands where the red one isn't
+	CHECK_EQ(target.depth[50 * k_width + 50], 0.7f);
+	//Nearer quads still pass
+	CHECK_EQ(target.depth[10 * k_width + 36], 0.2f);
+	CHECK_EQ(target.depth[10 * k_width + 110], 1.f);
+}
+
+TEST_CASE(RasterBlendSrcAlphaOneMinusDstAlpha)
+{
+	Gfx::RasterTarget target = Render(MakeScene());
+	uint32_t const clearChannel = (uint32_t)std::nearbyint(k_clearColor.x * 255.f);
+	uint32_t const dstAlpha = (uint32_t)std::nearbyint(k_clearColor.w * 255.f);
+
+	//Opaque red over the clear color, the destination keeps weight 1 - dstAlpha
+	uint32_t const redR = Blend(255, 255, clearChannel, dstAlpha);
+	uint32_t const redG = Blend(0, 255, clearChannel, dstAlpha);
+	CHECK(Near(Channel(target, 12, 12, 0), redR));
+	CHECK(Near(Channel(target, 12, 12, 1), redG));
+	CHECK(Near(Channel(target, 12, 12, 2), redG));
+	//Alpha keeps the destination value
+	CHECK_EQ(Channel(target, 12, 12, 3), dstAlpha);
+
+	//Half transparent blue over the clear color
+	CHECK(Near(Channel(target, 50, 50, 0), Blend(0, 128, clearChannel, dstAlpha)));
+	CHECK(Near(Channel(target, 50, 50, 2), Blend(255, 128, clearChannel, dstAlpha)));
+	CHECK_EQ(Channel(target, 50, 50, 3), dstAlpha);
+
+	//Half transparent blue over red
+	CHECK(Near(Channel(target, 36, 10, 0), Blend(0, 128, redR, dstAlpha)));
+	CHECK(Near(Channel(target, 36, 10, 2), Blend(255, 128, redG, dstAlpha)));
+}
+
+TEST_CASE(RasterSameWithoutJobs)
+{
+	Scene const scene = MakeScene();
+	Gfx::RasterTarget threaded = Render(scene);
+	Gfx::RasterTarget serial = Render(scene, nullptr);
+	CHECK(threaded.color == serial.color);
+	CHECK(threaded.depth == serial.depth);
+}
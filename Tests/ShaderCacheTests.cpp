@@ -0,0 +1,94 @@
+#include <filesystem>
+#include <optional>
+#include <string>
+#include "Test.h"
+#include "NullDevice.h"
+#include "ShaderCache.h"
+
+namespace
+{
+	std::filesystem::path const k_shaderDir = std::filesystem::path(TEST_DATA_DIR) / "Shaders";
+}
+
+TEST_CASE(ShaderIncludesArePastedOnce)
+{
+	Gfx::NullDevice device;
+	Gfx::ShaderCache cache(device);
+
+	//common.wgsl is included twice directly and once through Lib/helpers.wgsl as ../common.wgsl
+	std::optional<std::string> oSource = cache.Preprocess(k_shaderDir / "includeTwice.wgsl");
+	REQUIRE(oSource.has_value());
+	CHECK_EQ(*oSource, std::string("const k_shared = 1u;\nfn helper() {}\nfn main() {}\n"));
+	CHECK_EQ(cache.Stats().filesRead, 3u);
+
+	//Files are read once per cache, not per variant
+	Gfx::ShaderDefine const defines[] = { { "UNUSED", "1" } };
+	CHECK(cache.Preprocess(k_shaderDir / "includeTwice.wgsl", defines) == oSource);
+	CHECK_EQ(cache.Stats().filesRead, 3u);
+}
+
+TEST_CASE(ShaderConditionalsNest)
+{
+	Gfx::NullDevice device;
+	Gfx::ShaderCache cache(device);
+	std::filesystem::path const path = k_shaderDir / "conditionals.wgsl";
+
+	Gfx::ShaderDefine const a[] = { { "A", "" } };
+	Gfx::ShaderDefine const b[] = { { "B", "" } };
+	Gfx::ShaderDefine const ab[] = { { "A", "" }, { "B", "" } };
+	CHECK(cache.Preprocess(path) == std::string("not_a\nnot_a_not_b\nend\n"));
+	CHECK(cache.Preprocess(path, a) == std::string("a\na_not_b\nend\n"));
+	CHECK(cache.Preprocess(path, b) == std::string("not_a\nend\n"));
+	CHECK(cache.Preprocess(path, ab) == std::string("a\nab\nend\n"));
+}
+
+TEST_CASE(ShaderDefinesReplaceWholeWords)
+{
+	Gfx::NullDevice device;
+	Gfx::ShaderCache cache(device);
+
+	Gfx::ShaderDefine const defines[] = { { "WIDTH", "64u" } };
+	std::optional<std::string> oSource = cache.Preprocess(k_shaderDir / "defines.wgsl", defines);
+	REQUIRE(oSource.has_value());
+	CHECK_EQ(*oSource, std::string(
+		"const size = 64u;\n"
+		"const other = WIDTHS + WIDTH_2;\n"
+		"const sum = 64u+64u; // WIDTH stays in comments\n"
+		"const area = 64u * 32u;\n"));
+}
+
+TEST_CASE(ShaderPreprocessErrors)
+{
+	Gfx::NullDevice device;
+	Gfx::ShaderCache cache(device);
+
+	CHECK(!cache.Preprocess(k_shaderDir / "unterminated.wgsl").has_value());
+	CHECK(!cache.Preprocess(k_shaderDir / "missingInclude.wgsl").has_value());
+	CHECK(!cache.Load(k_shaderDir / "missingInclude.wgsl").has_value());
+	CHECK_EQ(cache.Stats().compiled, 0u);
+}
+
+TEST_CASE(ShaderModulesAreCachedBySource)
+{
+	Gfx::NullDevice device;
+	{
+		Gfx::ShaderCache cache(device);
+		std::filesystem::path const path = k_shaderDir / "defines.wgsl";
+		Gfx::ShaderDefine const wide[] = { { "WIDTH", "64u" } };
+		Gfx::ShaderDefine const wideAgain[] = { { "WIDTH", "64u" }, { "UNUSED", "1" } };
+		Gfx::ShaderDefine const narrow[] = { { "WIDTH", "8u" } };
+
+		std::optional<wgpu::ShaderModule> oWide = cache.Load(path, wide);
+		std::optional<wgpu::ShaderModule> oWideAgain = cache.Load(path, wideAgain);
+		std::optional<wgpu::ShaderModule> oNarrow = cache.Load(path, narrow);
+		REQUIRE(oWide && oWideAgain && oNarrow);
+
+		//Different defines with the same output share a module
+		CHECK(*oWide == *oWideAgain);
+		CHECK(*oWide != *oNarrow);
+		CHECK_EQ(cache.Stats().compiled, 2u);
+		CHECK_EQ(cache.Stats().hits, 1u);
+	}
+	//The cache releases its modules
+	CHECK(device.LiveObjects().empty());
+}
@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include "Test.h"
+#include "SpriteAnimPipeline.h"
+
+namespace
+{
+	SpriteAnimState State(uint32_t clipLength, uint32_t ticksPerFrame, uint32_t phase)
+	{
+		SpriteAnimState state;
+		state.clipLength = clipLength;
+		state.ticksPerFrame = ticksPerFrame;
+		state.phase = phase;
+		return state;
+	}
+
+	constexpr uint32_t k_maxTick = std::numeric_limits<uint32_t>::max();
+}
+
+TEST_CASE(WgslDivisionByZero)
+{
+	CHECK_EQ(Gfx::WgslDivide(7, 0), 7u);
+	CHECK_EQ(Gfx::WgslModulo(7, 0), 0u);
+	CHECK_EQ(Gfx::WgslDivide(7, 2), 3u);
+	CHECK_EQ(Gfx::WgslModulo(7, 2), 1u);
+}
+
+TEST_CASE(SpriteFrameZeroDivisor)
+{
+	//0 ticks per frame advances a frame every tick, like dividing by 1
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 0, 1), 6), 3u);
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 0, 0), 9), 1u);
+	//An empty clip always shows frame 0
+	CHECK_EQ(Gfx::SpriteFrame(State(0, 3, 2), 100), 0u);
+	CHECK_EQ(Gfx::SpriteFrame(State(0, 0, 0), 12345), 0u);
+}
+
+TEST_CASE(SpriteFrameWrapsPhaseIntoTheClip)
+{
+	//(tick / 3 + 2) % 4
+	SpriteAnimState const state = State(4, 3, 2);
+	uint32_t const expected[] = { 2, 2, 2, 3, 3, 3, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3 };
+	for (uint32_t tick = 0; tick < std::size(expected); ++tick) CHECK_EQ(Gfx::SpriteFrame(state, tick), expected[tick]);
+
+	//A phase past the clip length wraps like any other offset
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 1, 9), 0), 1u);
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 1, 9), 3), 0u);
+	//Single frame clips never move
+	CHECK_EQ(Gfx::SpriteFrame(State(1, 1, 5), 77), 0u);
+}
+
+TEST_CASE(SpriteFrameTickOverflow)
+{
+	//u32 arithmetic wraps the same way in wgsl, the reference has to follow it rather than the exact result
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 1, 0), k_maxTick), 3u);
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 1, 0), 0), 0u); //The tick after it
+	//tick + phase wraps to 0 instead of 2^32 % 3 == 1
+	CHECK_EQ(Gfx::SpriteFrame(State(3, 1, 1), k_maxTick), 0u);
+	//Division happens before the phase is added: (2^31 - 1) + 5 = 4 * 536870913
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 2, 5), k_maxTick), 0u);
+	CHECK_EQ(Gfx::SpriteFrame(State(4, 0, 0), k_maxTick), 3u);
+}
+
+TEST_CASE(AnimateSpritesOnlyWritesFrameIndices)
+{
+	std::vector<SpriteAnimState> states = { State(4, 1, 0), State(4, 2, 1), State(0, 0, 0), State(3, 1, 2) };
+	std::vector<AnimUniform> animations(3);
+	for (uint32_t i = 0; i < animations.size(); ++i)
+	{
+		animations[i].startCoord = Vec2f((float)i, 1.f);
+		animations[i].animId = i;
+		animations[i].currentFrameIndex = 99;
+	}
+
+	//One more state than animations, the extra one is ignored
+	Gfx::AnimateSprites(states, 5, animations);
+
+	CHECK_EQ(animations[0].currentFrameIndex, 1u);
+	CHECK_EQ(animations[1].currentFrameIndex, 3u);
+	CHECK_EQ(animations[2].currentFrameIndex, 0u);
+	for (uint32_t i = 0; i < animations.size(); ++i)
+	{
+		CHECK_EQ(animations[i].currentFrameIndex, Gfx::SpriteFrame(states[i], 5));
+		CHECK_EQ(animations[i].animId, i);
+		CHECK_EQ(animations[i].startCoord.x, (float)i);
+	}
+}
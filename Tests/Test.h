@@ -0,0 +1,51 @@
+#pragma once
+#include <iostream>
+#include <vector>
+
+//Minimal self registering test harness, no dependencies. TEST_CASE bodies run in registration order,
+//CHECK reports and carries on, REQUIRE reports and leaves the test
+namespace Test
+{
+	using TestFunction = void (*)();
+
+	struct TestCase
+	{
+		char const* name;
+		TestFunction function;
+	};
+
+	std::vector<TestCase>& Registry();
+
+	struct Registrar
+	{
+		Registrar(char const* name, TestFunction function) { Registry().push_back({ name, function }); }
+	};
+
+	//Prints the failed expression and marks the running test as failed
+	void Fail(char const* expression, char const* file, int line);
+
+	template<typename A, typename B>
+	void FailEqual(char const* expression, A const& actual, B const& expected, char const* file, int line)
+	{
+		Fail(expression, file, line);
+		std::cout << "    actual " << actual << ", expected " << expected << "\n";
+	}
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static Test::Registrar const name##Registrar(#name, name); \
+	static void name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) Test::Fail(#expression, __FILE__, __LINE__); } while (false)
+
+#define CHECK_EQ(actual, expected) \
+	do { \
+		auto const& checkActual = (actual); \
+		auto const& checkExpected = (expected); \
+		if (!(checkActual == checkExpected)) Test::FailEqual(#actual " == " #expected, checkActual, checkExpected, __FILE__, __LINE__); \
+	} while (false)
+
+#define REQUIRE(expression) \
+	do { if (!(expression)) { Test::Fail(#expression, __FILE__, __LINE__); return; } } while (false)
@@ -0,0 +1,47 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "Test.h"
+
+namespace
+{
+	bool g_currentFailed = false;
+}
+
+namespace Test
+{
+	std::vector<TestCase>& Registry()
+	{
+		//Function local so registrars in other translation units can't run before it exists
+		static std::vector<TestCase> registry;
+		return registry;
+	}
+
+	void Fail(char const* expression, char const* file, int line)
+	{
+		g_currentFailed = true;
+		std::cout << "  " << file << "(" << line << "): check failed: " << expression << "\n";
+	}
+}
+
+//Runs every test, or only those whose name contains the first argument
+int main(int argc, char** argv)
+{
+	char const* filter = argc > 1 ? argv[1] : nullptr;
+
+	uint32_t run = 0;
+	uint32_t failed = 0;
+	for (Test::TestCase const& test : Test::Registry())
+	{
+		if (filter && !std::strstr(test.name, filter)) continue;
+
+		g_currentFailed = false;
+		test.function();
+		++run;
+		if (g_currentFailed) ++failed;
+		std::cout << (g_currentFailed ? "[FAIL] " : "[ OK ] ") << test.name << "\n";
+	}
+
+	std::cout << run - failed << "/" << run << " tests passed\n";
+	return failed == 0 && run > 0 ? 0 : 1;
+}